@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_CIVIL_FIELDS_HPP_GUARD
+#define PEELO_CHRONO_CIVIL_FIELDS_HPP_GUARD
+
+#include <peelo/chrono/time_zone.hpp>
+#include <peelo/number/inttypes.hpp>
+#include <cstddef>
+
+namespace peelo
+{
+    /**
+     * Calendar fields of a single point in time, used by batch conversion
+     * functions.
+     */
+    struct civil_fields
+    {
+        /** Year. */
+        int32_t year;
+        /** Month of the year (from 1 to 12). */
+        int32_t month;
+        /** Day of the month (from 1 to 31). */
+        int32_t day;
+        /** Hour of the day (from 0 to 23). */
+        int32_t hour;
+        /** Minute of the hour (from 0 to 59). */
+        int32_t minute;
+        /** Second of the minute (from 0 to 59). */
+        int32_t second;
+        /** ISO weekday index, from 1 (Monday) to 7 (Sunday). */
+        int32_t weekday;
+        /** Day of the year (from 1 to 366). */
+        int32_t day_of_year;
+    };
+
+    /**
+     * Converts <i>n</i> UNIX timestamps into calendar fields in UTC. The
+     * results are identical to those of date, datetime and weekday, but the
+     * conversion is performed as a single loop over closed-form arithmetic
+     * without per element function calls or object construction. The
+     * timestamps are processed in batches: when every date of a batch is
+     * between years -799999 and 800000, the batch is converted by a
+     * branch-free loop over 32-bit arithmetic which the compiler vectorizes
+     * at -O3; otherwise the batch falls back to the general algorithm.
+     */
+    void to_civil(const int64_t* timestamps,
+                  std::size_t n,
+                  civil_fields* output);
+
+    /**
+     * Converts <i>n</i> UNIX timestamps into calendar fields in given time
+     * zone.
+     */
+    void to_civil(const int64_t* timestamps,
+                  std::size_t n,
+                  civil_fields* output,
+                  const time_zone& zone);
+
+    /**
+     * Converts <i>n</i> calendar fields in UTC into UNIX timestamps. Weekday
+     * and day of the year fields are ignored. Fields are not validated.
+     */
+    void from_civil(const civil_fields* input, std::size_t n, int64_t* output);
+}
+
+#endif /* !PEELO_CHRONO_CIVIL_FIELDS_HPP_GUARD */
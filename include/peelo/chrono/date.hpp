@@ -28,6 +28,7 @@
 
 #include <peelo/chrono/duration.hpp>
 #include <peelo/chrono/month.hpp>
+#include <peelo/chrono/time_zone.hpp>
 #include <peelo/chrono/weekday.hpp>
 #include <iostream>
 
@@ -58,15 +59,26 @@ namespace peelo
         date(const date& that);
 
         /**
-         * Constructs date value from UNIX timestamp.
+         * Constructs date value from UNIX timestamp, using local time zone of
+         * the system.
          */
         date(long timestamp);
 
+        /**
+         * Constructs date value from UNIX timestamp in given time zone.
+         */
+        date(long timestamp, const time_zone& zone);
+
         /**
          * Returns date value based on system clock.
          */
         static date today();
 
+        /**
+         * Returns current date in given time zone.
+         */
+        static date today(const time_zone& zone);
+
         /**
          * Returns yesterdays date value based on system clock.
          */
@@ -111,6 +123,31 @@ namespace peelo
          */
         const weekday& day_of_week() const;
 
+        /**
+         * Returns the first date after this one which falls on the given
+         * weekday.
+         */
+        date next(const weekday& wd) const;
+
+        /**
+         * Returns the last date before this one which falls on the given
+         * weekday.
+         */
+        date previous(const weekday& wd) const;
+
+        /**
+         * Returns the n:th occurrence of given weekday in the given month.
+         * Negative values of n count backwards from the end of the month, so
+         * that -1 gives the last occurrence.
+         *
+         * \throws std::out_of_range If n is zero or the month does not have
+         *                           that many occurrences of the weekday
+         */
+        static date nth_weekday(int year,
+                                const class month& month,
+                                const weekday& wd,
+                                int n);
+
         /**
          * Returns the day of the year (from 1 to 365 or 366 on leap years) for
          * this date.
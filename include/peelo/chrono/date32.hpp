@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_DATE32_HPP_GUARD
+#define PEELO_CHRONO_DATE32_HPP_GUARD
+
+#include <peelo/chrono/date.hpp>
+#include <peelo/number/inttypes.hpp>
+
+namespace peelo
+{
+    /**
+     * Compact date representation which stores number of days since
+     * 1970-01-01 in a single 32-bit integer. Values compare and sort as plain
+     * integers, and the class is trivially copyable, so arrays of it can be
+     * copied with memcpy().
+     */
+    class date32
+    {
+    public:
+        typedef int32_t value_type;
+
+        /**
+         * Constructs date from number of days since 1970-01-01.
+         */
+        explicit date32(value_type days = 0)
+            : m_days(days) {}
+
+        /**
+         * Constructs compact representation of given date.
+         *
+         * \throws std::out_of_range If the date cannot be represented
+         */
+        explicit date32(const date& d);
+
+        /**
+         * Returns number of days since 1970-01-01.
+         */
+        inline value_type days() const
+        {
+            return m_days;
+        }
+
+        /**
+         * Converts back to date.
+         */
+        date to_date() const;
+
+        inline bool equals(const date32& that) const
+        {
+            return m_days == that.m_days;
+        }
+
+        inline bool operator==(const date32& that) const
+        {
+            return m_days == that.m_days;
+        }
+
+        inline bool operator!=(const date32& that) const
+        {
+            return m_days != that.m_days;
+        }
+
+        inline int compare(const date32& that) const
+        {
+            return (m_days > that.m_days) - (m_days < that.m_days);
+        }
+
+        inline bool operator<(const date32& that) const
+        {
+            return m_days < that.m_days;
+        }
+
+        inline bool operator>(const date32& that) const
+        {
+            return m_days > that.m_days;
+        }
+
+        inline bool operator<=(const date32& that) const
+        {
+            return m_days <= that.m_days;
+        }
+
+        inline bool operator>=(const date32& that) const
+        {
+            return m_days >= that.m_days;
+        }
+
+        /**
+         * Returns date which is given number of days after this one.
+         */
+        inline date32 operator+(value_type days) const
+        {
+            return date32(m_days + days);
+        }
+
+        /**
+         * Returns date which is given number of days before this one.
+         */
+        inline date32 operator-(value_type days) const
+        {
+            return date32(m_days - days);
+        }
+
+        /**
+         * Returns number of days between two dates.
+         */
+        inline value_type operator-(const date32& that) const
+        {
+            return m_days - that.m_days;
+        }
+
+        inline date32& operator++()
+        {
+            ++m_days;
+
+            return *this;
+        }
+
+        inline date32 operator++(int)
+        {
+            return date32(m_days++);
+        }
+
+        inline date32& operator--()
+        {
+            --m_days;
+
+            return *this;
+        }
+
+        inline date32 operator--(int)
+        {
+            return date32(m_days--);
+        }
+
+    private:
+        /** Number of days since 1970-01-01. */
+        value_type m_days;
+    };
+
+    std::ostream& operator<<(std::ostream&, const date32&);
+    std::wostream& operator<<(std::wostream&, const date32&);
+}
+
+#endif /* !PEELO_CHRONO_DATE32_HPP_GUARD */
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_DATE_RANGE_HPP_GUARD
+#define PEELO_CHRONO_DATE_RANGE_HPP_GUARD
+
+#include <peelo/chrono/date.hpp>
+#include <peelo/container/range.hpp>
+#include <cstddef>
+
+namespace peelo
+{
+    /**
+     * Half open range of dates which is stepped through by days, weeks,
+     * months or business days. Unlike <code>range&lt;date&gt;</code>, which
+     * walks through the dates one day at a time, each element of the range
+     * is calculated directly from its position, so the range can also be
+     * indexed and its size is known without iterating.
+     */
+    class date_range
+    {
+    public:
+        class iterator;
+        typedef date value_type;
+        typedef std::size_t size_type;
+        typedef iterator const_iterator;
+
+        /**
+         * Units in which the range is stepped.
+         */
+        enum unit
+        {
+            /** Steps by days. */
+            days,
+            /** Steps by weeks. */
+            weeks,
+            /**
+             * Steps by months. Day of the month is taken from the first date
+             * of the range and clamped to the length of shorter months.
+             */
+            months,
+            /**
+             * Steps by days from Monday to Friday. The range begins from the
+             * first business day on or after the first date.
+             */
+            business_days
+        };
+
+        /**
+         * Constructs range which contains dates starting from
+         * <i>front</i> up to, but not including, <i>back</i>.
+         *
+         * \param front First date of the range
+         * \param back  End of the range
+         * \param u     Unit in which the range is stepped
+         * \param step  Number of units between two consecutive dates
+         * \throw std::invalid_argument If step is not positive
+         */
+        date_range(const date& front,
+                   const date& back,
+                   enum unit u = days,
+                   int step = 1);
+
+        /**
+         * Constructs date range from generic range of dates.
+         *
+         * \throw std::invalid_argument If step is not positive
+         */
+        explicit date_range(const range<date>& r,
+                            enum unit u = days,
+                            int step = 1);
+
+        /**
+         * Copy constructor.
+         */
+        date_range(const date_range& that);
+
+        /**
+         * Returns first date given to the constructor.
+         */
+        date front() const;
+
+        /**
+         * Returns end of the range, which itself is not part of the range.
+         */
+        date back() const;
+
+        inline enum unit step_unit() const
+        {
+            return m_unit;
+        }
+
+        inline int step() const
+        {
+            return m_step;
+        }
+
+        /**
+         * Returns number of dates in the range.
+         */
+        inline size_type size() const
+        {
+            return m_size;
+        }
+
+        /**
+         * Returns <code>true</code> if the range does not contain any dates.
+         */
+        inline bool empty() const
+        {
+            return !m_size;
+        }
+
+        /**
+         * Returns date from given position of the range.
+         *
+         * \throw std::out_of_range If index is out of bounds
+         */
+        date at(size_type index) const;
+
+        inline date operator[](size_type index) const
+        {
+            return at(index);
+        }
+
+        inline iterator begin() const
+        {
+            return iterator(this, 0);
+        }
+
+        inline iterator end() const
+        {
+            return iterator(this, m_size);
+        }
+
+        date_range& assign(const date_range& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline date_range& operator=(const date_range& that)
+        {
+            return assign(that);
+        }
+
+        bool equals(const date_range& that) const;
+
+        inline bool operator==(const date_range& that) const
+        {
+            return equals(that);
+        }
+
+        inline bool operator!=(const date_range& that) const
+        {
+            return !equals(that);
+        }
+
+        class iterator
+        {
+            friend class date_range;
+
+        public:
+            iterator(const iterator& that)
+                : m_range(that.m_range)
+                , m_index(that.m_index) {}
+
+            iterator& operator=(const iterator& that)
+            {
+                m_range = that.m_range;
+                m_index = that.m_index;
+
+                return *this;
+            }
+
+            inline value_type operator*() const
+            {
+                return m_range->at(m_index);
+            }
+
+            inline iterator& operator++()
+            {
+                ++m_index;
+
+                return *this;
+            }
+
+            inline iterator operator++(int)
+            {
+                iterator copy(*this);
+
+                ++m_index;
+
+                return copy;
+            }
+
+            inline iterator& operator--()
+            {
+                --m_index;
+
+                return *this;
+            }
+
+            inline iterator operator--(int)
+            {
+                iterator copy(*this);
+
+                --m_index;
+
+                return copy;
+            }
+
+            inline bool operator==(const iterator& that) const
+            {
+                return m_index == that.m_index;
+            }
+
+            inline bool operator!=(const iterator& that) const
+            {
+                return m_index != that.m_index;
+            }
+
+            inline bool operator<(const iterator& that) const
+            {
+                return m_index < that.m_index;
+            }
+
+            inline bool operator>(const iterator& that) const
+            {
+                return m_index > that.m_index;
+            }
+
+            inline bool operator<=(const iterator& that) const
+            {
+                return m_index <= that.m_index;
+            }
+
+            inline bool operator>=(const iterator& that) const
+            {
+                return m_index >= that.m_index;
+            }
+
+        private:
+            iterator(const date_range* range, size_type index)
+                : m_range(range)
+                , m_index(index) {}
+
+            const date_range* m_range;
+            size_type m_index;
+        };
+
+    private:
+        void initialize();
+
+    private:
+        /** First date of the range as number of days since 1970-01-01. */
+        long m_front;
+        /** End of the range as number of days since 1970-01-01. */
+        long m_back;
+        /** Unit in which the range is stepped. */
+        enum unit m_unit;
+        /** Number of units between two consecutive dates. */
+        int m_step;
+        /** Number of days since 1970-01-01 of the first date in the range. */
+        long m_first;
+        /** Number of dates in the range. */
+        size_type m_size;
+    };
+
+    std::ostream& operator<<(std::ostream&, const date_range&);
+    std::wostream& operator<<(std::wostream&, const date_range&);
+}
+
+#endif /* !PEELO_CHRONO_DATE_RANGE_HPP_GUARD */
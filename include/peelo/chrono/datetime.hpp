@@ -28,18 +28,26 @@
 
 #include <peelo/chrono/date.hpp>
 #include <peelo/chrono/time.hpp>
+#include <cstddef>
 
 namespace peelo
 {
     class datetime
     {
     public:
+        /**
+         * Size of buffer which is always large enough for output of
+         * format_iso8601(), including the terminating NUL character.
+         */
+        static const std::size_t iso8601_buffer_size = 40;
+
         explicit datetime(int year = 1900,
                           const class month& month = month::jan,
                           int day = 1,
                           int hour = 0,
                           int minute = 0,
-                          int second = 0);
+                          int second = 0,
+                          int nanosecond = 0);
 
         /**
          * Copy constructor.
@@ -53,21 +61,58 @@ namespace peelo
         datetime(const time& time);
 
         /**
-         * Constructs datetime instance from UNIX timestamp.
+         * Constructs datetime instance from UNIX timestamp, using local time
+         * zone of the system.
          */
         datetime(long timestamp);
 
         /**
-         * Returns current date and time based on system clock.
+         * Constructs datetime instance from UNIX timestamp in given time
+         * zone.
+         */
+        datetime(long timestamp, const time_zone& zone);
+
+        /**
+         * Returns current date and time based on system clock, with
+         * nanosecond resolution where the platform provides it.
          */
         static datetime now();
 
+        /**
+         * Returns current date and time in given time zone.
+         */
+        static datetime now(const time_zone& zone);
+
+        /**
+         * Parses ISO 8601 / RFC 3339 date and time such as
+         * "2014-06-17T13:45:30.25+03:00". Fractional seconds up to nanosecond
+         * precision and either "Z" or numeric UTC offset are supported. The
+         * result is converted to UTC. Input without UTC offset is treated as
+         * UTC and input with only a date is treated as midnight. Years
+         * outside 0 to 9999 are accepted in the expanded form with explicit
+         * sign and at least four digits, such as "+10000-01-01" or
+         * "-0001-12-31", which is what format_iso8601() writes for them.
+         *
+         * The parser does not allocate memory or depend on the locale.
+         *
+         * \throws std::invalid_argument If the input is not valid
+         */
+        static datetime parse_iso8601(const char* input, std::size_t length);
+
+        /**
+         * Parses ISO 8601 / RFC 3339 date and time from a string.
+         *
+         * \throws std::invalid_argument If the input is not valid
+         */
+        static datetime parse_iso8601(const string& input);
+
         static bool is_valid(int year,
                              const class month& month,
                              int day,
                              int hour,
                              int minute,
-                             int second);
+                             int second,
+                             int nanosecond = 0);
 
         /**
          * Returns date value.
@@ -158,11 +203,37 @@ namespace peelo
             return m_time.second();
         }
 
+        inline int nanosecond() const
+        {
+            return m_time.nanosecond();
+        }
+
         /**
          * Calculates UNIX timestamp from date and time.
          */
         long timestamp() const;
 
+        /**
+         * Calculates UNIX timestamp from date and time, treating them as wall
+         * clock time in given time zone.
+         */
+        long timestamp(const time_zone& zone) const;
+
+        /**
+         * Writes the date and time in RFC 3339 format with "Z" suffix into
+         * given buffer, which must have room for at least
+         * <code>iso8601_buffer_size</code> characters. Fractional seconds are
+         * included only when they are non-zero. Output is NUL terminated.
+         *
+         * \return Number of characters written, excluding the NUL character
+         */
+        std::size_t format_iso8601(char* output) const;
+
+        /**
+         * Returns the date and time in RFC 3339 format with "Z" suffix.
+         */
+        string format_iso8601() const;
+
         datetime& assign(const datetime& that);
         datetime& assign(const class date& date, const class time& time);
 
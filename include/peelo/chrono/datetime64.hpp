@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_DATETIME64_HPP_GUARD
+#define PEELO_CHRONO_DATETIME64_HPP_GUARD
+
+#include <peelo/chrono/date32.hpp>
+#include <peelo/chrono/datetime.hpp>
+
+namespace peelo
+{
+    /**
+     * Compact date and time representation which stores number of
+     * nanoseconds since 1970-01-01 00:00:00 UTC in a single 64-bit integer,
+     * covering years from 1677 to 2262. Values compare and sort as plain
+     * integers, and the class is trivially copyable, so arrays of it can be
+     * copied with memcpy().
+     */
+    class datetime64
+    {
+    public:
+        typedef int64_t value_type;
+
+        /**
+         * Constructs date and time from number of nanoseconds since
+         * 1970-01-01 00:00:00.
+         */
+        explicit datetime64(value_type nanoseconds = 0)
+            : m_nanoseconds(nanoseconds) {}
+
+        /**
+         * Constructs compact representation of given date and time.
+         *
+         * \throws std::out_of_range If the value cannot be represented
+         */
+        explicit datetime64(const datetime& dt);
+
+        /**
+         * Constructs compact representation of midnight of given date.
+         *
+         * \throws std::out_of_range If the value cannot be represented
+         */
+        explicit datetime64(const date32& d);
+
+        /**
+         * Returns number of nanoseconds since 1970-01-01 00:00:00.
+         */
+        inline value_type nanoseconds() const
+        {
+            return m_nanoseconds;
+        }
+
+        /**
+         * Returns UNIX timestamp in seconds, rounded towards negative
+         * infinity.
+         */
+        long timestamp() const;
+
+        /**
+         * Returns the date part.
+         */
+        date32 to_date32() const;
+
+        /**
+         * Converts back to datetime.
+         */
+        datetime to_datetime() const;
+
+        inline bool equals(const datetime64& that) const
+        {
+            return m_nanoseconds == that.m_nanoseconds;
+        }
+
+        inline bool operator==(const datetime64& that) const
+        {
+            return m_nanoseconds == that.m_nanoseconds;
+        }
+
+        inline bool operator!=(const datetime64& that) const
+        {
+            return m_nanoseconds != that.m_nanoseconds;
+        }
+
+        inline int compare(const datetime64& that) const
+        {
+            return (m_nanoseconds > that.m_nanoseconds)
+                - (m_nanoseconds < that.m_nanoseconds);
+        }
+
+        inline bool operator<(const datetime64& that) const
+        {
+            return m_nanoseconds < that.m_nanoseconds;
+        }
+
+        inline bool operator>(const datetime64& that) const
+        {
+            return m_nanoseconds > that.m_nanoseconds;
+        }
+
+        inline bool operator<=(const datetime64& that) const
+        {
+            return m_nanoseconds <= that.m_nanoseconds;
+        }
+
+        inline bool operator>=(const datetime64& that) const
+        {
+            return m_nanoseconds >= that.m_nanoseconds;
+        }
+
+        inline datetime64 operator+(const duration& d) const
+        {
+            return datetime64(m_nanoseconds + d.nanoseconds());
+        }
+
+        inline datetime64 operator-(const duration& d) const
+        {
+            return datetime64(m_nanoseconds - d.nanoseconds());
+        }
+
+        inline duration operator-(const datetime64& that) const
+        {
+            return duration::from_nanoseconds(
+                    m_nanoseconds - that.m_nanoseconds
+            );
+        }
+
+    private:
+        /** Number of nanoseconds since 1970-01-01 00:00:00. */
+        value_type m_nanoseconds;
+    };
+
+    std::ostream& operator<<(std::ostream&, const datetime64&);
+    std::wostream& operator<<(std::wostream&, const datetime64&);
+}
+
+#endif /* !PEELO_CHRONO_DATETIME64_HPP_GUARD */
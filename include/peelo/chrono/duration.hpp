@@ -26,10 +26,14 @@
 #ifndef PEELO_CHRONO_DURATION_HPP_GUARD
 #define PEELO_CHRONO_DURATION_HPP_GUARD
 
+#include <peelo/number/inttypes.hpp>
+
 namespace peelo
 {
     /**
-     * Duration represents a time span measured in seconds.
+     * Duration represents a time span measured in nanoseconds. The value is
+     * stored as 64-bit integer, which covers roughly 292 years in both
+     * directions.
      */
     class duration
     {
@@ -37,37 +41,70 @@ namespace peelo
         explicit duration(int days = 0,
                           int hours = 0,
                           int minutes = 0,
-                          int seconds = 0);
+                          int seconds = 0,
+                          int64_t nanoseconds = 0);
 
         /**
          * Copy constructor.
          */
         duration(const duration& that);
 
+        /**
+         * Constructs duration from given number of milliseconds.
+         */
+        static duration from_milliseconds(int64_t milliseconds);
+
+        /**
+         * Constructs duration from given number of microseconds.
+         */
+        static duration from_microseconds(int64_t microseconds);
+
+        /**
+         * Constructs duration from given number of nanoseconds.
+         */
+        static duration from_nanoseconds(int64_t nanoseconds);
+
         /**
          * Returns duration in days. Incomplete days are discarded.
          */
-        int days() const;
+        int64_t days() const;
 
         /**
          * Returns duration in hours. Incomplete hours are discarded. The returned
          * value can be greater than 23.
          */
-        int hours() const;
+        int64_t hours() const;
 
         /**
          * Returns duration in minutes. Incomplete minutes are discarded. The
          * returned value can be greater than 59.
          */
-        int minutes() const;
+        int64_t minutes() const;
+
+        /**
+         * Returns duration in seconds. Incomplete seconds are discarded. The
+         * returned value can be greater than 59.
+         */
+        int64_t seconds() const;
+
+        /**
+         * Returns duration in milliseconds. Incomplete milliseconds are
+         * discarded.
+         */
+        int64_t milliseconds() const;
+
+        /**
+         * Returns duration in microseconds. Incomplete microseconds are
+         * discarded.
+         */
+        int64_t microseconds() const;
 
         /**
-         * Returns duration in seconds. The returned value can be greater than
-         * 59.
+         * Returns duration in nanoseconds.
          */
-        inline int seconds() const
+        inline int64_t nanoseconds() const
         {
-            return m_seconds;
+            return m_nanoseconds;
         }
 
         /**
@@ -137,12 +174,12 @@ namespace peelo
 
         duration operator+(const duration& that) const;
         duration operator-(const duration& that) const;
-        duration operator*(int factor) const;
-        duration operator/(int quotient) const;
+        duration operator*(int64_t factor) const;
+        duration operator/(int64_t quotient) const;
 
     private:
-        /** Value of duration in seconds. */
-        int m_seconds;
+        /** Value of duration in nanoseconds. */
+        int64_t m_nanoseconds;
     };
 }
 
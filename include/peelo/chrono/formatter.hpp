@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_FORMATTER_HPP_GUARD
+#define PEELO_CHRONO_FORMATTER_HPP_GUARD
+
+#include <peelo/chrono/datetime.hpp>
+#include <peelo/container/vector.hpp>
+#include <peelo/text/stringbuilder.hpp>
+
+namespace peelo
+{
+    /**
+     * Formats dates and times using strftime-style pattern, which is compiled
+     * once into a list of instructions when the formatter is constructed.
+     * Formatting does not depend on the locale and does not allocate memory
+     * on its own.
+     *
+     * Supported conversion specifications are:
+     *
+     * - <code>%Y</code> Year with at least four digits
+     * - <code>%y</code> Last two digits of the year
+     * - <code>%C</code> Century as two digit number
+     * - <code>%m</code> Month as two digit number
+     * - <code>%d</code> Day of the month as two digit number
+     * - <code>%e</code> Day of the month, padded with space
+     * - <code>%j</code> Day of the year as three digit number
+     * - <code>%H</code> Hour (00 - 23)
+     * - <code>%I</code> Hour (01 - 12)
+     * - <code>%M</code> Minute (00 - 59)
+     * - <code>%S</code> Second (00 - 59)
+     * - <code>%f</code> Microseconds as six digit number
+     * - <code>%N</code> Nanoseconds as nine digit number
+     * - <code>%p</code> Either "AM" or "PM"
+     * - <code>%a</code>, <code>%A</code> Abbreviated and full weekday name
+     * - <code>%b</code>, <code>%h</code>, <code>%B</code> Abbreviated and
+     *   full month name
+     * - <code>%u</code> Weekday as number from 1 (Monday) to 7
+     * - <code>%w</code> Weekday as number from 0 (Sunday) to 6
+     * - <code>%F</code> Same as "%Y-%m-%d"
+     * - <code>%T</code> Same as "%H:%M:%S"
+     * - <code>%R</code> Same as "%H:%M"
+     * - <code>%D</code> Same as "%m/%d/%y"
+     * - <code>%n</code>, <code>%t</code>, <code>%%</code> Newline, tab and
+     *   percent sign
+     */
+    class formatter
+    {
+    public:
+        /**
+         * Compiles given pattern.
+         *
+         * \throws std::invalid_argument If the pattern contains unknown
+         *                               conversion specification
+         */
+        explicit formatter(const char* pattern);
+
+        /**
+         * Compiles given pattern.
+         *
+         * \throws std::invalid_argument If the pattern contains unknown
+         *                               conversion specification
+         */
+        explicit formatter(const string& pattern);
+
+        /**
+         * Copy constructor.
+         */
+        formatter(const formatter& that);
+
+        /**
+         * Destructor.
+         */
+        virtual ~formatter();
+
+        /**
+         * Returns upper bound for length of formatted output, excluding the
+         * terminating NUL character.
+         */
+        inline std::size_t max_length() const
+        {
+            return m_max_length;
+        }
+
+        /**
+         * Formats given date and time into a buffer of <i>size</i>
+         * characters. Output is truncated if it does not fit, and is always
+         * NUL terminated when <i>size</i> is greater than zero.
+         *
+         * \return Length of the complete output, excluding the NUL character
+         */
+        std::size_t format(const datetime& dt,
+                           char* output,
+                           std::size_t size) const;
+
+        /**
+         * Appends formatted date and time to given string builder.
+         */
+        void format(const datetime& dt, stringbuilder& output) const;
+
+        /**
+         * Returns formatted date and time as string.
+         */
+        string format(const datetime& dt) const;
+
+        formatter& assign(const formatter& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline formatter& operator=(const formatter& that)
+        {
+            return assign(that);
+        }
+
+        /**
+         * Single compiled step of the pattern.
+         */
+        struct instruction
+        {
+            /** Conversion performed by the instruction. */
+            int opcode;
+            /** Offset of literal text in the literal buffer. */
+            std::size_t offset;
+            /** Length of literal text. */
+            std::size_t length;
+        };
+
+    private:
+        void compile(const char* pattern);
+        void emit(int opcode);
+        void literal(const char* text, std::size_t length);
+
+    private:
+        /** Compiled instructions. */
+        vector<instruction> m_instructions;
+        /** Literal text referenced by the instructions. */
+        vector<char> m_literals;
+        /** Upper bound for length of output. */
+        std::size_t m_max_length;
+    };
+}
+
+#endif /* !PEELO_CHRONO_FORMATTER_HPP_GUARD */
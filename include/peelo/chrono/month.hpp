@@ -78,6 +78,17 @@ namespace peelo
             return m_index;
         }
 
+        /**
+         * Returns English name of the month, such as "January".
+         */
+        const char* name() const;
+
+        /**
+         * Returns three letter English abbreviation of the month, such as
+         * "Jan".
+         */
+        const char* abbreviation() const;
+
         /**
          * Returns the number of days in the month (28 to 31).
          */
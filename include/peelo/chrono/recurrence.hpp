@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_RECURRENCE_HPP_GUARD
+#define PEELO_CHRONO_RECURRENCE_HPP_GUARD
+
+#include <peelo/chrono/date.hpp>
+#include <peelo/container/range.hpp>
+#include <peelo/container/vector.hpp>
+
+namespace peelo
+{
+    /**
+     * Rule for recurring dates, such as "every other Tuesday" or "second
+     * Tuesday of every month". Occurrences are calculated directly from the
+     * rule, instead of testing each day in the requested period.
+     */
+    class recurrence
+    {
+    public:
+        /**
+         * Returns rule which recurs on given weekday of every
+         * <i>interval</i>:th week, starting from the week of given date.
+         *
+         * \throw std::invalid_argument If interval is not positive
+         */
+        static recurrence weekly(const date& start,
+                                 const weekday& wd,
+                                 int interval = 1);
+
+        /**
+         * Returns rule which recurs on given day of every <i>interval</i>:th
+         * month, starting from the month of given date. Months which do not
+         * have such day are skipped.
+         *
+         * \throw std::invalid_argument If interval is not positive or day is
+         *                              not between 1 and 31
+         */
+        static recurrence monthly(const date& start,
+                                  int day,
+                                  int interval = 1);
+
+        /**
+         * Returns rule which recurs on <i>n</i>:th given weekday of every
+         * <i>interval</i>:th month, starting from the month of given date.
+         * Negative values of n count backwards from the end of the month.
+         * Months which do not have such weekday are skipped.
+         *
+         * \throw std::invalid_argument If interval is not positive or n is
+         *                              not between -5 and 5 or is zero
+         */
+        static recurrence monthly(const date& start,
+                                  const weekday& wd,
+                                  int n,
+                                  int interval = 1);
+
+        /**
+         * Copy constructor.
+         */
+        recurrence(const recurrence& that);
+
+        /**
+         * Returns date from which the recurrence begins. No occurrences are
+         * generated before it.
+         */
+        date start() const;
+
+        /**
+         * Returns the first occurrence which is on or after given date.
+         *
+         * \throw std::out_of_range If there are no more occurrences that can
+         *                          be represented
+         */
+        date next(const date& from) const;
+
+        /**
+         * Returns all occurrences between <i>from</i> and <i>until</i>,
+         * including the former but not the latter.
+         */
+        vector<date> expand(const date& from, const date& until) const;
+
+        /**
+         * Returns all occurrences within given range.
+         */
+        inline vector<date> expand(const range<date>& r) const
+        {
+            return expand(r.front(), r.back());
+        }
+
+        recurrence& assign(const recurrence& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline recurrence& operator=(const recurrence& that)
+        {
+            return assign(that);
+        }
+
+        bool equals(const recurrence& that) const;
+
+        inline bool operator==(const recurrence& that) const
+        {
+            return equals(that);
+        }
+
+        inline bool operator!=(const recurrence& that) const
+        {
+            return !equals(that);
+        }
+
+    private:
+        enum kind
+        {
+            kind_weekly,
+            kind_monthly_day,
+            kind_monthly_weekday
+        };
+
+        recurrence(enum kind k,
+                   const date& start,
+                   int interval,
+                   int day,
+                   int ordinal);
+
+        /**
+         * Searches for the first occurrence on or after given day, both
+         * represented as number of days since 1970-01-01. Returns
+         * <code>false</code> if the rule does not produce any more
+         * occurrences.
+         */
+        bool find(long from, long& result) const;
+
+    private:
+        /** Type of the rule. */
+        enum kind m_kind;
+        /** Starting date as number of days since 1970-01-01. */
+        long m_start;
+        /** Number of weeks or months between two occurrences. */
+        int m_interval;
+        /** Index of the weekday (1 - 7) or day of the month. */
+        int m_weekday;
+        /** Ordinal of the weekday in the month. */
+        int m_ordinal;
+    };
+}
+
+#endif /* !PEELO_CHRONO_RECURRENCE_HPP_GUARD */
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_STEADY_CLOCK_HPP_GUARD
+#define PEELO_CHRONO_STEADY_CLOCK_HPP_GUARD
+
+#include <peelo/chrono/duration.hpp>
+
+namespace peelo
+{
+    /**
+     * Monotonic clock with nanosecond resolution, suitable for measuring
+     * elapsed time. Values returned by the clock are measured from an
+     * unspecified starting point, so only differences between them are
+     * meaningful.
+     *
+     * On x86 processors with invariant time stamp counter, the clock can
+     * optionally read the counter directly instead of going through the
+     * operating system. The counter frequency is calibrated against the
+     * monotonic clock of the system when the fast path is first enabled.
+     *
+     * Readings of each source never decrease. When the source is switched,
+     * the new one continues from the current reading of the old one, so
+     * toggling the fast path does not make the clock go backwards either,
+     * although the values then drift away from those of the system clock.
+     * Reading the clock performs no writes to shared memory.
+     */
+    class steady_clock
+    {
+    public:
+        /**
+         * Returns current value of the clock.
+         */
+        static duration now();
+
+        /**
+         * Attempts to switch the clock to read the time stamp counter of the
+         * processor. Returns <code>true</code> if the processor has an
+         * invariant time stamp counter and the fast path is now in use.
+         */
+        static bool enable_tsc();
+
+        /**
+         * Switches the clock back to the monotonic clock of the system.
+         */
+        static void disable_tsc();
+
+        /**
+         * Returns <code>true</code> if the clock is currently reading the
+         * time stamp counter of the processor.
+         */
+        static bool is_tsc_enabled();
+
+    private:
+        steady_clock();
+    };
+}
+
+#endif /* !PEELO_CHRONO_STEADY_CLOCK_HPP_GUARD */
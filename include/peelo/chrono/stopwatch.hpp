@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_STOPWATCH_HPP_GUARD
+#define PEELO_CHRONO_STOPWATCH_HPP_GUARD
+
+#include <peelo/chrono/steady_clock.hpp>
+#include <peelo/container/vector.hpp>
+
+namespace peelo
+{
+    /**
+     * Stopwatch measures elapsed time using steady_clock and can record lap
+     * times.
+     */
+    class stopwatch
+    {
+    public:
+        /**
+         * Constructs stopwatch which is started immediately if
+         * <i>running</i> is <code>true</code>.
+         */
+        explicit stopwatch(bool running = false);
+
+        /**
+         * Copy constructor.
+         */
+        stopwatch(const stopwatch& that);
+
+        /**
+         * Starts or resumes measuring time. Does nothing if the stopwatch is
+         * already running.
+         */
+        void start();
+
+        /**
+         * Stops measuring time. Elapsed time is retained, so the stopwatch
+         * can be resumed with start().
+         */
+        void stop();
+
+        /**
+         * Stops the stopwatch and clears elapsed time and recorded laps.
+         */
+        void reset();
+
+        /**
+         * Resets the stopwatch and starts it again.
+         */
+        void restart();
+
+        /**
+         * Returns <code>true</code> if the stopwatch is running.
+         */
+        inline bool is_running() const
+        {
+            return m_running;
+        }
+
+        /**
+         * Returns total time measured by the stopwatch.
+         */
+        duration elapsed() const;
+
+        /**
+         * Records a lap and returns the time elapsed since previous lap, or
+         * since the stopwatch was started if this is the first lap.
+         */
+        duration lap();
+
+        /**
+         * Returns all recorded lap times.
+         */
+        inline const vector<duration>& laps() const
+        {
+            return m_laps;
+        }
+
+        stopwatch& assign(const stopwatch& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline stopwatch& operator=(const stopwatch& that)
+        {
+            return assign(that);
+        }
+
+    private:
+        /** Whether the stopwatch is running. */
+        bool m_running;
+        /** Clock value when the stopwatch was last started. */
+        duration m_started;
+        /** Time accumulated before the stopwatch was last started. */
+        duration m_elapsed;
+        /** Total elapsed time when previous lap was recorded. */
+        duration m_last_lap;
+        /** Recorded lap times. */
+        vector<duration> m_laps;
+    };
+}
+
+#endif /* !PEELO_CHRONO_STOPWATCH_HPP_GUARD */
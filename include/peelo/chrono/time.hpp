@@ -26,6 +26,7 @@
 #ifndef PEELO_CHRONO_TIME_HPP_GUARD
 #define PEELO_CHRONO_TIME_HPP_GUARD
 
+#include <peelo/chrono/time_zone.hpp>
 #include <iostream>
 
 namespace peelo
@@ -36,7 +37,10 @@ namespace peelo
     class time
     {
     public:
-        explicit time(int hour = 0, int minute = 0, int second = 0);
+        explicit time(int hour = 0,
+                      int minute = 0,
+                      int second = 0,
+                      int nanosecond = 0);
 
         /**
          * Copy constructor.
@@ -48,7 +52,15 @@ namespace peelo
          */
         static time now();
 
-        static bool is_valid(int hour, int minute, int second);
+        /**
+         * Returns current time in given time zone.
+         */
+        static time now(const time_zone& zone);
+
+        static bool is_valid(int hour,
+                             int minute,
+                             int second,
+                             int nanosecond = 0);
 
         /**
          * Returns hour of the day (from 0 to 23).
@@ -74,8 +86,16 @@ namespace peelo
             return m_second;
         }
 
+        /**
+         * Returns nanosecond of the second (from 0 to 999999999).
+         */
+        inline int nanosecond() const
+        {
+            return m_nanosecond;
+        }
+
         time& assign(const time& that);
-        time& assign(int hour, int minute, int second);
+        time& assign(int hour, int minute, int second, int nanosecond = 0);
 
         /**
          * Assignment operator.
@@ -86,7 +106,10 @@ namespace peelo
         }
 
         bool equals(const time& that) const;
-        bool equals(int hour, int minute, int second) const;
+        bool equals(int hour,
+                    int minute,
+                    int second,
+                    int nanosecond = 0) const;
 
         inline bool operator==(const time& that) const
         {
@@ -99,7 +122,10 @@ namespace peelo
         }
 
         int compare(const time& that) const;
-        int compare(int hour, int minute, int second) const;
+        int compare(int hour,
+                    int minute,
+                    int second,
+                    int nanosecond = 0) const;
 
         inline bool operator<(const time& that) const
         {
@@ -148,6 +174,8 @@ namespace peelo
         int m_minute;
         /** Second of the minute. */
         int m_second;
+        /** Nanosecond of the second. */
+        int m_nanosecond;
     };
 
     std::ostream& operator<<(std::ostream&, const time&);
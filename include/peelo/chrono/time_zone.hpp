@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_TIME_ZONE_HPP_GUARD
+#define PEELO_CHRONO_TIME_ZONE_HPP_GUARD
+
+#include <peelo/text/string.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace peelo
+{
+    /**
+     * Time zone backed by TZif data from the zoneinfo database. Zone data is
+     * parsed once into an immutable transition table that is shared between
+     * copies, so that conversions can be performed concurrently from
+     * multiple threads without any locking or access to global state of the
+     * C library.
+     *
+     * All timestamps are UNIX timestamps in seconds, and offsets are given
+     * in seconds east of UTC.
+     */
+    class time_zone
+    {
+    public:
+        /**
+         * Constructs UTC time zone.
+         */
+        time_zone();
+
+        /**
+         * Copy constructor.
+         */
+        time_zone(const time_zone& that);
+
+        /**
+         * Destructor.
+         */
+        virtual ~time_zone();
+
+        /**
+         * Returns shared instance of UTC time zone.
+         */
+        static const time_zone& utc();
+
+        /**
+         * Returns time zone of the system. The zone is determined from the
+         * <code>TZ</code> environment variable or from
+         * <code>/etc/localtime</code> when it is first requested and cached
+         * for the rest of the process. If neither of those can be loaded,
+         * UTC is used instead.
+         */
+        static const time_zone& local();
+
+        /**
+         * Loads time zone with given name (such as "Europe/Helsinki") from
+         * the zoneinfo database. Absolute paths to TZif files are also
+         * accepted.
+         *
+         * \throws std::runtime_error If the zone cannot be read
+         * \throws std::invalid_argument If the zone data is malformed
+         */
+        static time_zone load(const string& name);
+
+        /**
+         * Constructs time zone from contents of a TZif file.
+         *
+         * \throws std::invalid_argument If the data is malformed
+         */
+        static time_zone parse(const string& name,
+                               const unsigned char* data,
+                               std::size_t size);
+
+        /**
+         * Constructs time zone from POSIX TZ rule such as
+         * "EET-2EEST,M3.5.0/3,M10.5.0/4".
+         *
+         * \throws std::invalid_argument If the rule is malformed
+         */
+        static time_zone parse_rule(const string& rule);
+
+        /**
+         * Returns name of the time zone.
+         */
+        string name() const;
+
+        /**
+         * Returns UTC offset in seconds which is in effect at given UNIX
+         * timestamp.
+         */
+        long offset(long timestamp) const;
+
+        /**
+         * Returns <code>true</code> if daylight saving time is in effect at
+         * given UNIX timestamp.
+         */
+        bool is_dst(long timestamp) const;
+
+        /**
+         * Returns abbreviation (such as "EEST") of the local time type in
+         * effect at given UNIX timestamp.
+         */
+        string abbreviation(long timestamp) const;
+
+        /**
+         * Converts UNIX timestamp into local wall clock time, expressed as
+         * seconds since 1970-01-01 00:00:00 in this time zone.
+         */
+        inline long to_local(long timestamp) const
+        {
+            return timestamp + offset(timestamp);
+        }
+
+        /**
+         * Converts local wall clock time into UNIX timestamp. Times which
+         * fall into a gap caused by a forward transition are shifted by the
+         * length of the gap and ambiguous times are resolved to the earlier
+         * of the two possible instants.
+         */
+        long to_utc(long local) const;
+
+        time_zone& assign(const time_zone& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline time_zone& operator=(const time_zone& that)
+        {
+            return assign(that);
+        }
+
+        struct data;
+
+    private:
+        explicit time_zone(const std::shared_ptr<const data>& data);
+
+    private:
+        /** Shared immutable zone data. */
+        std::shared_ptr<const data> m_data;
+    };
+}
+
+#endif /* !PEELO_CHRONO_TIME_ZONE_HPP_GUARD */
@@ -62,6 +62,25 @@ namespace peelo
             return m_index;
         }
 
+        /**
+         * Returns English name of the weekday, such as "Monday".
+         */
+        const char* name() const;
+
+        /**
+         * Returns three letter English abbreviation of the weekday, such as
+         * "Mon".
+         */
+        const char* abbreviation() const;
+
+        /**
+         * Returns <code>true</code> if the weekday is Saturday or Sunday.
+         */
+        inline bool is_weekend() const
+        {
+            return m_index > 5;
+        }
+
         weekday& assign(const weekday& that);
 
         /**
@@ -120,6 +139,22 @@ namespace peelo
 
         weekday operator--(int);
 
+        /**
+         * Returns number of days (from 0 to 6) from this weekday forward to
+         * the given weekday.
+         */
+        int days_until(const weekday& that) const;
+
+        /**
+         * Returns weekday which is given number of days after this one.
+         */
+        weekday operator+(int days) const;
+
+        /**
+         * Returns weekday which is given number of days before this one.
+         */
+        weekday operator-(int days) const;
+
     private:
         int m_index;
     };
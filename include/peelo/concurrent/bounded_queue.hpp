@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CONCURRENT_BOUNDED_QUEUE_HPP_GUARD
+#define PEELO_CONCURRENT_BOUNDED_QUEUE_HPP_GUARD
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace peelo
+{
+    namespace concurrent
+    {
+        /**
+         * Bounded multi-producer multi-consumer queue, based on the array
+         * queue algorithm by Dmitry Vyukov. The non-blocking operations are
+         * lock-free and cost a single compare-and-swap in the uncontended
+         * case. Blocking operations fall back to a condition variable only
+         * when the queue is full or empty.
+         */
+        template< class T >
+        class bounded_queue
+        {
+        public:
+            typedef T value_type;
+            typedef std::size_t size_type;
+            typedef value_type& reference;
+            typedef const value_type& const_reference;
+
+            /** Assumed size of a cache line, in bytes. */
+            static const size_type cache_line_size = 64;
+
+            /**
+             * Constructs empty queue.
+             *
+             * \param capacity Maximum number of elements stored in the queue.
+             *                 Rounded up to the nearest power of two.
+             */
+            explicit bounded_queue(size_type capacity = 1024)
+                : m_mask(round_capacity(capacity) - 1)
+                , m_cells(new cell[m_mask + 1])
+                , m_enqueue_pos(0)
+                , m_dequeue_pos(0)
+                , m_push_waiters(0)
+                , m_pop_waiters(0)
+            {
+                for (size_type i = 0; i <= m_mask; ++i)
+                {
+                    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * Destructor. Elements still stored in the queue are destroyed.
+             */
+            virtual ~bounded_queue()
+            {
+                value_type value;
+
+                while (dequeue(value));
+                delete[] m_cells;
+            }
+
+            /**
+             * Returns maximum number of elements the queue can hold.
+             */
+            inline size_type capacity() const
+            {
+                return m_mask + 1;
+            }
+
+            /**
+             * Returns approximate number of elements in the queue. The result
+             * may already be outdated when it's returned.
+             */
+            size_type size() const
+            {
+                const size_type tail = m_dequeue_pos.load(std::memory_order_acquire);
+                const size_type head = m_enqueue_pos.load(std::memory_order_acquire);
+
+                return head > tail ? head - tail : 0;
+            }
+
+            /**
+             * Returns <code>true</code> if the queue appears to be empty.
+             */
+            inline bool empty() const
+            {
+                return !size();
+            }
+
+            /**
+             * Attempts to push given value to the end of the queue without
+             * blocking.
+             *
+             * \return <code>false</code> if the queue is full
+             */
+            bool try_push(const_reference value)
+            {
+                if (!enqueue(value))
+                {
+                    return false;
+                }
+                wake(m_pop_waiters, m_not_empty);
+
+                return true;
+            }
+
+            /**
+             * Attempts to remove an element from the front of the queue
+             * without blocking, and assigns it to the given slot.
+             *
+             * \return <code>false</code> if the queue is empty
+             */
+            bool try_pop(reference slot)
+            {
+                if (!dequeue(slot))
+                {
+                    return false;
+                }
+                wake(m_push_waiters, m_not_full);
+
+                return true;
+            }
+
+            /**
+             * Pushes up to <i>n</i> values from given array to the end of the
+             * queue without blocking. Consecutive slots are claimed with a
+             * single compare-and-swap.
+             *
+             * \return Number of values pushed
+             */
+            size_type push_n(const value_type* values, size_type n)
+            {
+                size_type pos;
+
+                if (!(n = claim(m_enqueue_pos, 0, n, pos)))
+                {
+                    return 0;
+                }
+                for (size_type i = 0; i < n; ++i)
+                {
+                    store(pos + i, values[i]);
+                }
+                wake(m_pop_waiters, m_not_empty);
+
+                return n;
+            }
+
+            /**
+             * Removes up to <i>n</i> elements from the front of the queue
+             * without blocking and stores them into given array. Consecutive
+             * slots are claimed with a single compare-and-swap.
+             *
+             * \return Number of elements removed
+             */
+            size_type pop_n(value_type* slots, size_type n)
+            {
+                size_type pos;
+
+                if (!(n = claim(m_dequeue_pos, 1, n, pos)))
+                {
+                    return 0;
+                }
+                for (size_type i = 0; i < n; ++i)
+                {
+                    load(pos + i, slots[i]);
+                }
+                wake(m_push_waiters, m_not_full);
+
+                return n;
+            }
+
+            /**
+             * Pushes given value to the end of the queue, blocking while the
+             * queue is full.
+             */
+            void push(const_reference value)
+            {
+                if (!enqueue(value))
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+
+                    m_push_waiters.fetch_add(1);
+                    while (!enqueue(value))
+                    {
+                        m_not_full.wait(lock);
+                    }
+                    m_push_waiters.fetch_sub(1);
+                }
+                wake(m_pop_waiters, m_not_empty);
+            }
+
+            /**
+             * Removes an element from the front of the queue and assigns it to
+             * the given slot, blocking while the queue is empty.
+             */
+            void pop(reference slot)
+            {
+                if (!dequeue(slot))
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+
+                    m_pop_waiters.fetch_add(1);
+                    while (!dequeue(slot))
+                    {
+                        m_not_empty.wait(lock);
+                    }
+                    m_pop_waiters.fetch_sub(1);
+                }
+                wake(m_push_waiters, m_not_full);
+            }
+
+            /**
+             * Pushes given value to the end of the queue, blocking while the
+             * queue is full.
+             */
+            inline bounded_queue& operator<<(const_reference value)
+            {
+                push(value);
+
+                return *this;
+            }
+
+            /**
+             * Removes an element from the front of the queue and assigns it to
+             * the given slot, blocking while the queue is empty.
+             */
+            inline bounded_queue& operator>>(reference slot)
+            {
+                pop(slot);
+
+                return *this;
+            }
+
+        private:
+            bounded_queue(const bounded_queue<T>&);
+            bounded_queue& operator=(const bounded_queue<T>&);
+
+            struct cell
+            {
+                std::atomic<size_type> sequence;
+                typename std::aligned_storage<
+                    sizeof(T),
+                    std::alignment_of<T>::value
+                >::type data;
+            };
+
+            static size_type round_capacity(size_type capacity)
+            {
+                size_type result = 2;
+
+                while (result < capacity)
+                {
+                    result <<= 1;
+                }
+
+                return result;
+            }
+
+            /**
+             * Claims up to <i>n</i> consecutive cells whose sequence number
+             * equals their position plus <i>offset</i> (0 for free cells, 1
+             * for cells which contain a value) by advancing the given
+             * position counter.
+             *
+             * \return Number of cells claimed, starting at <i>pos</i>
+             */
+            size_type claim(std::atomic<size_type>& counter,
+                            size_type offset,
+                            size_type n,
+                            size_type& pos)
+            {
+                pos = counter.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    size_type count = 0;
+                    std::ptrdiff_t diff = 0;
+
+                    while (count < n)
+                    {
+                        const size_type seq = m_cells[(pos + count) & m_mask]
+                            .sequence.load(std::memory_order_acquire);
+
+                        diff = static_cast<std::ptrdiff_t>(seq - (pos + count + offset));
+                        if (diff)
+                        {
+                            break;
+                        }
+                        ++count;
+                    }
+                    if (count)
+                    {
+                        if (counter.compare_exchange_weak(
+                                    pos,
+                                    pos + count,
+                                    std::memory_order_relaxed))
+                        {
+                            return count;
+                        }
+                    }
+                    else if (diff < 0)
+                    {
+                        return 0;
+                    } else {
+                        pos = counter.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            /**
+             * Pushes given value without waking up blocked consumers.
+             */
+            bool enqueue(const_reference value)
+            {
+                size_type pos;
+
+                if (!claim(m_enqueue_pos, 0, 1, pos))
+                {
+                    return false;
+                }
+                store(pos, value);
+
+                return true;
+            }
+
+            /**
+             * Pops an element without waking up blocked producers.
+             */
+            bool dequeue(reference slot)
+            {
+                size_type pos;
+
+                if (!claim(m_dequeue_pos, 1, 1, pos))
+                {
+                    return false;
+                }
+                load(pos, slot);
+
+                return true;
+            }
+
+            inline void store(size_type pos, const_reference value)
+            {
+                cell& c = m_cells[pos & m_mask];
+
+                new (&c.data) value_type(value);
+                c.sequence.store(pos + 1, std::memory_order_release);
+            }
+
+            inline void load(size_type pos, reference slot)
+            {
+                cell& c = m_cells[pos & m_mask];
+                value_type* data = reinterpret_cast<value_type*>(&c.data);
+
+                slot = *data;
+                data->~value_type();
+                c.sequence.store(pos + m_mask + 1, std::memory_order_release);
+            }
+
+            /**
+             * Wakes up threads blocked in push() or pop(). The fence pairs
+             * with the increment of the waiter count, so either the waiter
+             * sees the cell we just released or we see the waiter.
+             */
+            inline void wake(std::atomic<size_type>& waiters,
+                             std::condition_variable& condition)
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (waiters.load(std::memory_order_relaxed))
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+
+                    condition.notify_all();
+                }
+            }
+
+            /** Mask used to map positions into cells. */
+            const size_type m_mask;
+            /** Ring buffer of cells. */
+            cell* const m_cells;
+            /** Position of the next push, on its own cache line. */
+            alignas(cache_line_size) std::atomic<size_type> m_enqueue_pos;
+            /** Position of the next pop, on its own cache line. */
+            alignas(cache_line_size) std::atomic<size_type> m_dequeue_pos;
+            /** Waiter bookkeeping used only by the blocking operations. */
+            alignas(cache_line_size) std::atomic<size_type> m_push_waiters;
+            std::atomic<size_type> m_pop_waiters;
+            std::mutex m_mutex;
+            std::condition_variable m_not_full;
+            std::condition_variable m_not_empty;
+        };
+    }
+}
+
+#endif /* !PEELO_CONCURRENT_BOUNDED_QUEUE_HPP_GUARD */
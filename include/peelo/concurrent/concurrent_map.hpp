@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CONCURRENT_CONCURRENT_MAP_HPP_GUARD
+#define PEELO_CONCURRENT_CONCURRENT_MAP_HPP_GUARD
+
+#include <peelo/container/map.hpp>
+#include <peelo/number/inttypes.hpp>
+#include <atomic>
+#include <thread>
+
+namespace peelo
+{
+    /**
+     * Hash map which can be shared between threads. Entries are distributed
+     * into independently locked map segments, so that threads working on
+     * different segments do not contend with each other. Lookups take only a
+     * shared lock on their segment, which allows any number of concurrent
+     * readers.
+     *
+     * Since entries may be modified or removed by other threads at any time,
+     * values are returned as copies instead of references or iterators.
+     */
+    template <
+        class Key,
+        class T,
+        class Hash = hash<Key>,
+        class KeyEqual = equal_to<Key>
+    >
+    class concurrent_map
+    {
+    public:
+        typedef Key key_type;
+        typedef T mapped_value;
+        typedef std::size_t size_type;
+        typedef Hash hasher;
+        typedef KeyEqual key_equal;
+        typedef map<Key, T, Hash, KeyEqual> segment_type;
+
+        /**
+         * Constructs empty map.
+         *
+         * \param segment_count Number of independently locked segments.
+         *                      Rounded up to the nearest power of two.
+         * \param bucket_count  Number of hash buckets in each segment
+         * \param hash          Hash function used for the keys
+         * \param equal         Equality function used for the keys
+         */
+        explicit concurrent_map(size_type segment_count = 16,
+                                size_type bucket_count = 64,
+                                const hasher& hash = hasher(),
+                                const key_equal& equal = key_equal())
+            : m_hash(hash)
+            , m_shift(64)
+            , m_segment_count(1)
+            , m_segments(0)
+        {
+            while (m_segment_count < segment_count)
+            {
+                m_segment_count <<= 1;
+                --m_shift;
+            }
+            m_segments = new segment*[m_segment_count];
+            for (size_type i = 0; i < m_segment_count; ++i)
+            {
+                m_segments[i] = new segment(bucket_count, hash, equal);
+            }
+        }
+
+        /**
+         * Destructor.
+         */
+        virtual ~concurrent_map()
+        {
+            for (size_type i = 0; i < m_segment_count; ++i)
+            {
+                delete m_segments[i];
+            }
+            delete[] m_segments;
+        }
+
+        /**
+         * Returns number of segments in the map.
+         */
+        inline size_type segment_count() const
+        {
+            return m_segment_count;
+        }
+
+        /**
+         * Returns the number of entries stored in the map. Segments are
+         * counted one by one, so the result is not a consistent snapshot if
+         * other threads are modifying the map at the same time.
+         */
+        size_type size() const
+        {
+            size_type result = 0;
+
+            for (size_type i = 0; i < m_segment_count; ++i)
+            {
+                shared_guard guard(m_segments[i]->lock);
+
+                result += m_segments[i]->entries.size();
+            }
+
+            return result;
+        }
+
+        /**
+         * Returns <code>true</code> if the map appears to be empty.
+         */
+        inline bool empty() const
+        {
+            return !size();
+        }
+
+        /**
+         * Looks up entry with given key and copies its value into the given
+         * slot. Only a shared lock is taken.
+         *
+         * \return <code>true</code> if the entry was found
+         */
+        bool find(const key_type& key, mapped_value& slot) const
+        {
+            const segment& s = segment_for(key);
+            shared_guard guard(s.lock);
+            typename segment_type::const_iterator i = s.entries.find(key);
+
+            if (i == s.entries.end())
+            {
+                return false;
+            }
+            slot = (*i).second();
+
+            return true;
+        }
+
+        /**
+         * Returns <code>true</code> if the map contains given key. Only a
+         * shared lock is taken.
+         */
+        bool contains(const key_type& key) const
+        {
+            const segment& s = segment_for(key);
+            shared_guard guard(s.lock);
+
+            return s.entries.find(key) != s.entries.end();
+        }
+
+        /**
+         * Inserts given key and value into the map. Existing entry with same
+         * key is overridden.
+         *
+         * \return <code>true</code> if a new entry was inserted
+         */
+        bool insert_or_assign(const key_type& key, const mapped_value& value)
+        {
+            segment& s = segment_for(key);
+            exclusive_guard guard(s.lock);
+            const size_type size = s.entries.size();
+
+            s.entries.insert(key, value);
+
+            return s.entries.size() != size;
+        }
+
+        /**
+         * Returns value of entry with given key. If the map does not contain
+         * such entry, value is computed with <code>function(key)</code> and
+         * inserted into the map. The function is called at most once, while
+         * the segment is exclusively locked.
+         */
+        template< class Function >
+        mapped_value compute_if_absent(const key_type& key, Function function)
+        {
+            segment& s = segment_for(key);
+
+            {
+                shared_guard guard(s.lock);
+                const segment_type& entries = s.entries;
+                typename segment_type::const_iterator i = entries.find(key);
+
+                if (i != entries.end())
+                {
+                    return (*i).second();
+                }
+            }
+
+            exclusive_guard guard(s.lock);
+            typename segment_type::iterator i = s.entries.find(key);
+
+            if (i != s.entries.end())
+            {
+                return (*i).second();
+            } else {
+                const mapped_value value = function(key);
+
+                s.entries.insert(key, value);
+
+                return value;
+            }
+        }
+
+        /**
+         * Removes entry with given key from the map.
+         *
+         * \return Number of entries removed
+         */
+        size_type erase(const key_type& key)
+        {
+            segment& s = segment_for(key);
+            exclusive_guard guard(s.lock);
+
+            return s.entries.erase(key);
+        }
+
+        /**
+         * Removes all entries from the map. Segments are cleared one by one.
+         */
+        void clear()
+        {
+            for (size_type i = 0; i < m_segment_count; ++i)
+            {
+                exclusive_guard guard(m_segments[i]->lock);
+
+                m_segments[i]->entries.clear();
+            }
+        }
+
+    private:
+        concurrent_map(const concurrent_map<Key, T, Hash, KeyEqual>&);
+        concurrent_map& operator=(const concurrent_map<Key, T, Hash, KeyEqual>&);
+
+        /**
+         * Writer preferring reader-writer spin lock. Readers only increment a
+         * counter, and new readers back off as soon as a writer announces
+         * itself.
+         */
+        class rwlock
+        {
+        public:
+            rwlock()
+                : m_state(0) {}
+
+            void lock_shared()
+            {
+                for (;;)
+                {
+                    unsigned state = m_state.load(std::memory_order_relaxed);
+
+                    if (!(state & writer)
+                        && m_state.compare_exchange_weak(
+                            state,
+                            state + 1,
+                            std::memory_order_acquire,
+                            std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+
+            inline void unlock_shared()
+            {
+                m_state.fetch_sub(1, std::memory_order_release);
+            }
+
+            void lock()
+            {
+                for (;;)
+                {
+                    unsigned state = m_state.load(std::memory_order_relaxed);
+
+                    if (!(state & writer)
+                        && m_state.compare_exchange_weak(
+                            state,
+                            state | writer,
+                            std::memory_order_acquire,
+                            std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+                while (m_state.load(std::memory_order_acquire) != writer)
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            inline void unlock()
+            {
+                m_state.store(0, std::memory_order_release);
+            }
+
+        private:
+            static const unsigned writer = 1u << 31;
+
+            std::atomic<unsigned> m_state;
+        };
+
+        class shared_guard
+        {
+        public:
+            explicit shared_guard(rwlock& lock)
+                : m_lock(lock)
+            {
+                m_lock.lock_shared();
+            }
+
+            ~shared_guard()
+            {
+                m_lock.unlock_shared();
+            }
+
+        private:
+            rwlock& m_lock;
+        };
+
+        class exclusive_guard
+        {
+        public:
+            explicit exclusive_guard(rwlock& lock)
+                : m_lock(lock)
+            {
+                m_lock.lock();
+            }
+
+            ~exclusive_guard()
+            {
+                m_lock.unlock();
+            }
+
+        private:
+            rwlock& m_lock;
+        };
+
+        struct segment
+        {
+            segment(size_type bucket_count,
+                    const hasher& hash,
+                    const key_equal& equal)
+                : entries(bucket_count, hash, equal) {}
+
+            mutable rwlock lock;
+            segment_type entries;
+        };
+
+        /**
+         * Selects segment for given key from the high bits of a multiplicative
+         * hash, so that the segment choice is independent of the bucket index
+         * used inside the segment.
+         */
+        inline segment& segment_for(const key_type& key) const
+        {
+            const uint64_t h = static_cast<uint64_t>(m_hash(key));
+
+            if (m_segment_count == 1)
+            {
+                return *m_segments[0];
+            }
+
+            return *m_segments[(h * 0x9e3779b97f4a7c15ULL) >> m_shift];
+        }
+
+        /** Hash function used for selecting the segment. */
+        hasher m_hash;
+        /** Shift which maps 64-bit hash into segment index. */
+        unsigned m_shift;
+        /** Number of segments. */
+        size_type m_segment_count;
+        /** Independently locked segments. */
+        segment** m_segments;
+    };
+}
+
+#endif /* !PEELO_CONCURRENT_CONCURRENT_MAP_HPP_GUARD */
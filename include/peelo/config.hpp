@@ -0,0 +1,13 @@
+#ifndef PEELO_CONFIG_HPP_GUARD
+#define PEELO_CONFIG_HPP_GUARD
+
+#define PEELO_HAVE_CSTDINT 1
+#define PEELO_HAVE_STDINT_H 1
+
+#define PEELO_HAVE_LINUX_IO_URING_H 1
+#define PEELO_HAVE_SYS_INOTIFY_H 1
+
+/* #undef PEELO_HAVE_VASPRINTF */
+/* #undef PEELO_HAVE_VSNPRINTF */
+
+#endif /* !PEELO_CONFIG_HPP_GUARD */
@@ -0,0 +1,570 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CONTAINER_FLAT_MAP_HPP_GUARD
+#define PEELO_CONTAINER_FLAT_MAP_HPP_GUARD
+
+#include <peelo/container/pair.hpp>
+#include <peelo/container/vector.hpp>
+#include <peelo/functional/less.hpp>
+#include <algorithm>
+
+namespace peelo
+{
+    /**
+     * Ordered map which stores its entries in a vector sorted by key. Lookups
+     * are done with branchless binary search, which makes the container
+     * suitable for lookup tables which are constructed once and queried
+     * often. Insertions and removals are linear in the size of the map.
+     */
+    template <
+        class Key,
+        class T,
+        class Compare = less<Key>,
+        class Allocator = std::allocator< pair<Key, T> >
+    >
+    class flat_map
+    {
+    public:
+        typedef Key key_type;
+        typedef T mapped_value;
+        typedef pair<Key, T> value_type;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Compare key_compare;
+        typedef Allocator allocator_type;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef vector<value_type, Allocator> container_type;
+        typedef typename container_type::iterator iterator;
+        typedef typename container_type::const_iterator const_iterator;
+        typedef typename container_type::reverse_iterator reverse_iterator;
+        typedef typename container_type::const_reverse_iterator const_reverse_iterator;
+
+        /**
+         * Constructs empty map.
+         */
+        explicit flat_map(const key_compare& compare = key_compare(),
+                          const allocator_type& allocator = allocator_type())
+            : m_compare(compare)
+            , m_data(allocator) {}
+
+        /**
+         * Copy constructor.
+         */
+        flat_map(const flat_map<Key, T, Compare, Allocator>& that)
+            : m_compare(that.m_compare)
+            , m_data(that.m_data) {}
+
+        /**
+         * Constructs map from contents of the range <i>[first, last]</i>. The
+         * input does not have to be sorted. When the input contains multiple
+         * entries with equivalent keys, the first one of them is kept.
+         */
+        template< class InputIt >
+        flat_map(InputIt first,
+                 InputIt last,
+                 const key_compare& compare = key_compare(),
+                 const allocator_type& allocator = allocator_type())
+            : m_compare(compare)
+            , m_data(allocator)
+        {
+            container_type input(first, last, allocator);
+
+            build(input);
+        }
+
+        /**
+         * Constructs map from entries of the given vector. The input does not
+         * have to be sorted. When the input contains multiple entries with
+         * equivalent keys, the first one of them is kept.
+         */
+        explicit flat_map(const container_type& input,
+                          const key_compare& compare = key_compare())
+            : m_compare(compare)
+        {
+            container_type copy(input);
+
+            build(copy);
+        }
+
+        /**
+         * Returns <code>true</code> if the map is not empty.
+         */
+        inline operator bool() const
+        {
+            return !m_data.empty();
+        }
+
+        /**
+         * Returns <code>true</code> if the map is empty.
+         */
+        inline bool operator!() const
+        {
+            return m_data.empty();
+        }
+
+        /**
+         * Returns <code>true</code> if the map is empty.
+         */
+        inline bool empty() const
+        {
+            return m_data.empty();
+        }
+
+        /**
+         * Returns the number of entries stored in the map.
+         */
+        inline size_type size() const
+        {
+            return m_data.size();
+        }
+
+        /**
+         * Returns the sorted vector which serves as storage for the map.
+         */
+        inline const container_type& data() const
+        {
+            return m_data;
+        }
+
+        /**
+         * Returns reference to the mapped value of entry with given key.
+         *
+         * \throw std::out_of_range If the map does not contain given key.
+         */
+        mapped_value& at(const key_type& key)
+        {
+            const size_type index = search(key);
+
+            if (index < m_data.size())
+            {
+                return m_data[index].second();
+            }
+
+            throw std::out_of_range("map index out of bounds");
+        }
+
+        const mapped_value& at(const key_type& key) const
+        {
+            const size_type index = search(key);
+
+            if (index < m_data.size())
+            {
+                return m_data[index].second();
+            }
+
+            throw std::out_of_range("map index out of bounds");
+        }
+
+        /**
+         * Returns reference to the mapped value of entry with given key,
+         * inserting default constructed value if the map does not contain
+         * such entry.
+         */
+        mapped_value& operator[](const key_type& key)
+        {
+            const size_type index = lower_bound_index(key);
+
+            if (index >= m_data.size() || m_compare(key, m_data[index].first()))
+            {
+                m_data.insert(index, value_type(key, mapped_value()));
+            }
+
+            return m_data[index].second();
+        }
+
+        inline iterator begin()
+        {
+            return m_data.begin();
+        }
+
+        inline const_iterator begin() const
+        {
+            return m_data.begin();
+        }
+
+        inline const_iterator cbegin() const
+        {
+            return m_data.begin();
+        }
+
+        inline iterator end()
+        {
+            return m_data.end();
+        }
+
+        inline const_iterator end() const
+        {
+            return m_data.end();
+        }
+
+        inline const_iterator cend() const
+        {
+            return m_data.end();
+        }
+
+        inline reverse_iterator rbegin()
+        {
+            return m_data.rbegin();
+        }
+
+        inline const_reverse_iterator rbegin() const
+        {
+            return m_data.rbegin();
+        }
+
+        inline const_reverse_iterator crbegin() const
+        {
+            return m_data.rbegin();
+        }
+
+        inline reverse_iterator rend()
+        {
+            return m_data.rend();
+        }
+
+        inline const_reverse_iterator rend() const
+        {
+            return m_data.rend();
+        }
+
+        inline const_reverse_iterator crend() const
+        {
+            return m_data.rend();
+        }
+
+        /**
+         * Ensures that the map has capacity for at least <i>n</i> entries.
+         */
+        inline void reserve(size_type n)
+        {
+            m_data.reserve(n);
+        }
+
+        flat_map& assign(const flat_map<Key, T, Compare, Allocator>& that)
+        {
+            m_compare = that.m_compare;
+            m_data.assign(that.m_data);
+
+            return *this;
+        }
+
+        /**
+         * Assignment operator.
+         */
+        inline flat_map& operator=(const flat_map<Key, T, Compare, Allocator>& that)
+        {
+            return assign(that);
+        }
+
+        bool equals(const flat_map<Key, T, Compare, Allocator>& that) const
+        {
+            return m_data.equals(that.m_data);
+        }
+
+        /**
+         * Equality testing operator.
+         */
+        inline bool operator==(const flat_map<Key, T, Compare, Allocator>& that) const
+        {
+            return equals(that);
+        }
+
+        /**
+         * Non-equality testing operator.
+         */
+        inline bool operator!=(const flat_map<Key, T, Compare, Allocator>& that) const
+        {
+            return !equals(that);
+        }
+
+        /**
+         * Removes all entries from the map.
+         */
+        void clear()
+        {
+            m_data.clear();
+        }
+
+        /**
+         * Returns the number of entries matching specific key, which is
+         * either 0 or 1.
+         */
+        size_type count(const key_type& key) const
+        {
+            return search(key) < m_data.size() ? 1 : 0;
+        }
+
+        /**
+         * Returns <code>true</code> if the map contains given key.
+         */
+        inline bool contains(const key_type& key) const
+        {
+            return search(key) < m_data.size();
+        }
+
+        /**
+         * Inserts given entry into the map. Existing entry with same key is
+         * overridden.
+         */
+        inline void insert(const_reference value)
+        {
+            insert(value.first(), value.second());
+        }
+
+        /**
+         * Inserts given key and value into the map. Existing entry with same
+         * key is overridden.
+         */
+        void insert(const key_type& key, const mapped_value& value)
+        {
+            const size_type index = lower_bound_index(key);
+
+            if (index < m_data.size() && !m_compare(key, m_data[index].first()))
+            {
+                m_data[index].second() = value;
+            } else {
+                m_data.insert(index, value_type(key, value));
+            }
+        }
+
+        inline flat_map& operator<<(const_reference value)
+        {
+            insert(value);
+
+            return *this;
+        }
+
+        /**
+         * Removes entry with given key from the map.
+         *
+         * \return Number of entries removed, either 0 or 1
+         */
+        size_type erase(const key_type& key)
+        {
+            const size_type index = search(key);
+
+            if (index < m_data.size())
+            {
+                m_data.erase(index);
+
+                return 1;
+            }
+
+            return 0;
+        }
+
+        /**
+         * Returns iterator to entry with given key, or end() if the map does
+         * not contain such entry.
+         */
+        iterator find(const key_type& key)
+        {
+            return m_data.begin() + search(key);
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            return m_data.begin() + search(key);
+        }
+
+        /**
+         * Returns iterator to the first entry whose key is not less than given
+         * key.
+         */
+        iterator lower_bound(const key_type& key)
+        {
+            return m_data.begin() + lower_bound_index(key);
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            return m_data.begin() + lower_bound_index(key);
+        }
+
+        /**
+         * Returns iterator to the first entry whose key is greater than given
+         * key.
+         */
+        iterator upper_bound(const key_type& key)
+        {
+            return m_data.begin() + upper_bound_index(key);
+        }
+
+        const_iterator upper_bound(const key_type& key) const
+        {
+            return m_data.begin() + upper_bound_index(key);
+        }
+
+        /**
+         * Returns range of entries matching given key. Since keys are unique,
+         * the range contains at most one entry.
+         */
+        pair<iterator, iterator> equal_range(const key_type& key)
+        {
+            return pair<iterator, iterator>(
+                    m_data.begin() + lower_bound_index(key),
+                    m_data.begin() + upper_bound_index(key)
+            );
+        }
+
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            return pair<const_iterator, const_iterator>(
+                    m_data.begin() + lower_bound_index(key),
+                    m_data.begin() + upper_bound_index(key)
+            );
+        }
+
+    private:
+        /**
+         * Branchless binary search. The loop body compiles into a conditional
+         * move, so the search does not suffer from branch mispredictions.
+         */
+        size_type lower_bound_index(const key_type& key) const
+        {
+            const value_type* data = m_data.data();
+            const value_type* base = data;
+            size_type n = m_data.size();
+
+            if (!n)
+            {
+                return 0;
+            }
+            while (n > 1)
+            {
+                const size_type half = n / 2;
+
+                base = m_compare(base[half].first(), key) ? base + half : base;
+                n -= half;
+            }
+
+            return (base - data) + (m_compare(base->first(), key) ? 1 : 0);
+        }
+
+        size_type upper_bound_index(const key_type& key) const
+        {
+            const size_type index = lower_bound_index(key);
+
+            if (index < m_data.size() && !m_compare(key, m_data[index].first()))
+            {
+                return index + 1;
+            }
+
+            return index;
+        }
+
+        /**
+         * Returns index of the entry with given key, or size() if the map does
+         * not contain such entry.
+         */
+        size_type search(const key_type& key) const
+        {
+            const size_type index = lower_bound_index(key);
+
+            if (index < m_data.size() && !m_compare(key, m_data[index].first()))
+            {
+                return index;
+            }
+
+            return m_data.size();
+        }
+
+        struct entry_compare
+        {
+            entry_compare(const key_compare& compare)
+                : compare(compare) {}
+
+            inline bool operator()(const value_type& a, const value_type& b) const
+            {
+                return compare(a.first(), b.first());
+            }
+
+            key_compare compare;
+        };
+
+        /**
+         * Sorts the given input by key and copies entries with unique keys
+         * from it into the storage.
+         */
+        void build(container_type& input)
+        {
+            const size_type n = input.size();
+            value_type* data = input.data();
+
+            std::stable_sort(data, data + n, entry_compare(m_compare));
+            m_data.reserve(n);
+            for (size_type i = 0; i < n; ++i)
+            {
+                if (!i || m_compare(data[i - 1].first(), data[i].first()))
+                {
+                    m_data.push_back(data[i]);
+                }
+            }
+        }
+
+        /** Comparison function object. */
+        key_compare m_compare;
+        /** Storage of the entries, sorted by key. */
+        container_type m_data;
+    };
+
+    template< class Key, class T >
+    std::ostream& operator<<(std::ostream& os, const flat_map<Key, T>& m)
+    {
+        for (typename flat_map<Key, T>::const_iterator i = m.begin();
+             i != m.end();
+             ++i)
+        {
+            if (i != m.begin())
+            {
+                os << ", ";
+            }
+            os << *i;
+        }
+
+        return os;
+    }
+
+    template< class Key, class T >
+    std::wostream& operator<<(std::wostream& os, const flat_map<Key, T>& m)
+    {
+        for (typename flat_map<Key, T>::const_iterator i = m.begin();
+             i != m.end();
+             ++i)
+        {
+            if (i != m.begin())
+            {
+                os << L", ";
+            }
+            os << *i;
+        }
+
+        return os;
+    }
+}
+
+#endif /* !PEELO_CONTAINER_FLAT_MAP_HPP_GUARD */
@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CONTAINER_FLAT_SET_HPP_GUARD
+#define PEELO_CONTAINER_FLAT_SET_HPP_GUARD
+
+#include <peelo/container/pair.hpp>
+#include <peelo/container/vector.hpp>
+#include <peelo/functional/less.hpp>
+#include <algorithm>
+
+namespace peelo
+{
+    /**
+     * Ordered set which stores its elements in a sorted vector. Lookups are
+     * done with branchless binary search, which makes the container suitable
+     * for data which is constructed once and queried often. Insertions and
+     * removals are linear in the size of the set.
+     */
+    template <
+        class Key,
+        class Compare = less<Key>,
+        class Allocator = std::allocator<Key>
+    >
+    class flat_set
+    {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Compare key_compare;
+        typedef Allocator allocator_type;
+        typedef const value_type& reference;
+        typedef const value_type& const_reference;
+        typedef vector<Key, Allocator> container_type;
+        typedef typename container_type::const_iterator iterator;
+        typedef typename container_type::const_iterator const_iterator;
+        typedef typename container_type::const_reverse_iterator reverse_iterator;
+        typedef typename container_type::const_reverse_iterator const_reverse_iterator;
+
+        /**
+         * Constructs empty set.
+         */
+        explicit flat_set(const key_compare& compare = key_compare(),
+                          const allocator_type& allocator = allocator_type())
+            : m_compare(compare)
+            , m_data(allocator) {}
+
+        /**
+         * Copy constructor.
+         */
+        flat_set(const flat_set<Key, Compare, Allocator>& that)
+            : m_compare(that.m_compare)
+            , m_data(that.m_data) {}
+
+        /**
+         * Constructs set from contents of the range <i>[first, last]</i>. The
+         * input does not have to be sorted and duplicate elements are
+         * discarded.
+         */
+        template< class InputIt >
+        flat_set(InputIt first,
+                 InputIt last,
+                 const key_compare& compare = key_compare(),
+                 const allocator_type& allocator = allocator_type())
+            : m_compare(compare)
+            , m_data(allocator)
+        {
+            container_type input(first, last, allocator);
+
+            build(input);
+        }
+
+        /**
+         * Constructs set from elements of the given vector. The input does not
+         * have to be sorted and duplicate elements are discarded.
+         */
+        explicit flat_set(const container_type& input,
+                          const key_compare& compare = key_compare())
+            : m_compare(compare)
+        {
+            container_type copy(input);
+
+            build(copy);
+        }
+
+        /**
+         * Returns <code>true</code> if the set is not empty.
+         */
+        inline operator bool() const
+        {
+            return !m_data.empty();
+        }
+
+        /**
+         * Returns <code>true</code> if the set is empty.
+         */
+        inline bool operator!() const
+        {
+            return m_data.empty();
+        }
+
+        /**
+         * Returns <code>true</code> if the set is empty.
+         */
+        inline bool empty() const
+        {
+            return m_data.empty();
+        }
+
+        /**
+         * Returns the number of elements stored in the set.
+         */
+        inline size_type size() const
+        {
+            return m_data.size();
+        }
+
+        /**
+         * Returns the sorted vector which serves as storage for the set.
+         */
+        inline const container_type& data() const
+        {
+            return m_data;
+        }
+
+        /**
+         * Returns reference to element at specified position in the sort
+         * order. No bounds checking is performed.
+         */
+        inline const_reference operator[](size_type pos) const
+        {
+            return m_data[pos];
+        }
+
+        inline const_iterator begin() const
+        {
+            return m_data.begin();
+        }
+
+        inline const_iterator cbegin() const
+        {
+            return m_data.begin();
+        }
+
+        inline const_iterator end() const
+        {
+            return m_data.end();
+        }
+
+        inline const_iterator cend() const
+        {
+            return m_data.end();
+        }
+
+        inline const_reverse_iterator rbegin() const
+        {
+            return m_data.rbegin();
+        }
+
+        inline const_reverse_iterator crbegin() const
+        {
+            return m_data.rbegin();
+        }
+
+        inline const_reverse_iterator rend() const
+        {
+            return m_data.rend();
+        }
+
+        inline const_reverse_iterator crend() const
+        {
+            return m_data.rend();
+        }
+
+        /**
+         * Ensures that the set has capacity for at least <i>n</i> elements.
+         */
+        inline void reserve(size_type n)
+        {
+            m_data.reserve(n);
+        }
+
+        flat_set& assign(const flat_set<Key, Compare, Allocator>& that)
+        {
+            m_compare = that.m_compare;
+            m_data.assign(that.m_data);
+
+            return *this;
+        }
+
+        /**
+         * Assignment operator.
+         */
+        inline flat_set& operator=(const flat_set<Key, Compare, Allocator>& that)
+        {
+            return assign(that);
+        }
+
+        bool equals(const flat_set<Key, Compare, Allocator>& that) const
+        {
+            return m_data.equals(that.m_data);
+        }
+
+        /**
+         * Equality testing operator.
+         */
+        inline bool operator==(const flat_set<Key, Compare, Allocator>& that) const
+        {
+            return equals(that);
+        }
+
+        /**
+         * Non-equality testing operator.
+         */
+        inline bool operator!=(const flat_set<Key, Compare, Allocator>& that) const
+        {
+            return !equals(that);
+        }
+
+        /**
+         * Removes all elements from the set.
+         */
+        void clear()
+        {
+            m_data.clear();
+        }
+
+        /**
+         * Returns the number of elements matching specific key, which is
+         * either 0 or 1.
+         */
+        size_type count(const key_type& key) const
+        {
+            return search(key) < m_data.size() ? 1 : 0;
+        }
+
+        /**
+         * Returns <code>true</code> if the set contains given key.
+         */
+        inline bool contains(const key_type& key) const
+        {
+            return search(key) < m_data.size();
+        }
+
+        /**
+         * Inserts given element into the set, if the set doesn't already
+         * contain an equivalent element.
+         *
+         * \return <code>true</code> if the element was inserted
+         */
+        bool insert(const_reference value)
+        {
+            const size_type index = lower_bound_index(value);
+
+            if (index < m_data.size() && !m_compare(value, m_data[index]))
+            {
+                return false;
+            }
+            m_data.insert(index, value);
+
+            return true;
+        }
+
+        inline flat_set& operator<<(const_reference value)
+        {
+            insert(value);
+
+            return *this;
+        }
+
+        /**
+         * Removes element with given key from the set.
+         *
+         * \return Number of elements removed, either 0 or 1
+         */
+        size_type erase(const key_type& key)
+        {
+            const size_type index = search(key);
+
+            if (index < m_data.size())
+            {
+                m_data.erase(index);
+
+                return 1;
+            }
+
+            return 0;
+        }
+
+        /**
+         * Returns iterator to element with given key, or end() if the set
+         * does not contain such element.
+         */
+        const_iterator find(const key_type& key) const
+        {
+            return m_data.begin() + search(key);
+        }
+
+        /**
+         * Returns iterator to the first element which is not less than given
+         * key.
+         */
+        const_iterator lower_bound(const key_type& key) const
+        {
+            return m_data.begin() + lower_bound_index(key);
+        }
+
+        /**
+         * Returns iterator to the first element which is greater than given
+         * key.
+         */
+        const_iterator upper_bound(const key_type& key) const
+        {
+            size_type index = lower_bound_index(key);
+
+            if (index < m_data.size() && !m_compare(key, m_data[index]))
+            {
+                ++index;
+            }
+
+            return m_data.begin() + index;
+        }
+
+        /**
+         * Returns range of elements matching given key. Since keys are unique,
+         * the range contains at most one element.
+         */
+        pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            const size_type index = lower_bound_index(key);
+            const_iterator first = m_data.begin() + index;
+
+            if (index < m_data.size() && !m_compare(key, m_data[index]))
+            {
+                return pair<const_iterator, const_iterator>(first, first + 1);
+            }
+
+            return pair<const_iterator, const_iterator>(first, first);
+        }
+
+    private:
+        /**
+         * Branchless binary search. The loop body compiles into a conditional
+         * move, so the search does not suffer from branch mispredictions.
+         */
+        size_type lower_bound_index(const key_type& key) const
+        {
+            const Key* data = m_data.data();
+            const Key* base = data;
+            size_type n = m_data.size();
+
+            if (!n)
+            {
+                return 0;
+            }
+            while (n > 1)
+            {
+                const size_type half = n / 2;
+
+                base = m_compare(base[half], key) ? base + half : base;
+                n -= half;
+            }
+
+            return (base - data) + (m_compare(*base, key) ? 1 : 0);
+        }
+
+        /**
+         * Returns index of the element with given key, or size() if the set
+         * does not contain such element.
+         */
+        size_type search(const key_type& key) const
+        {
+            const size_type index = lower_bound_index(key);
+
+            if (index < m_data.size() && !m_compare(key, m_data[index]))
+            {
+                return index;
+            }
+
+            return m_data.size();
+        }
+
+        /**
+         * Sorts the given input and copies unique elements from it into the
+         * storage.
+         */
+        void build(container_type& input)
+        {
+            const size_type n = input.size();
+            Key* data = input.data();
+
+            std::sort(data, data + n, m_compare);
+            m_data.reserve(n);
+            for (size_type i = 0; i < n; ++i)
+            {
+                if (!i || m_compare(data[i - 1], data[i]))
+                {
+                    m_data.push_back(data[i]);
+                }
+            }
+        }
+
+        /** Comparison function object. */
+        key_compare m_compare;
+        /** Sorted storage of the elements. */
+        container_type m_data;
+    };
+
+    template< class T >
+    std::ostream& operator<<(std::ostream& os, const flat_set<T>& s)
+    {
+        for (typename flat_set<T>::size_type i = 0; i < s.size(); ++i)
+        {
+            if (i > 0)
+            {
+                os << ", ";
+            }
+            os << s[i];
+        }
+
+        return os;
+    }
+
+    template< class T >
+    std::wostream& operator<<(std::wostream& os, const flat_set<T>& s)
+    {
+        for (typename flat_set<T>::size_type i = 0; i < s.size(); ++i)
+        {
+            if (i > 0)
+            {
+                os << L", ";
+            }
+            os << s[i];
+        }
+
+        return os;
+    }
+}
+
+#endif /* !PEELO_CONTAINER_FLAT_SET_HPP_GUARD */
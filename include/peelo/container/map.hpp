@@ -250,7 +250,7 @@ namespace peelo
 
         private:
             entry* m_pointer;
-            friend class set;
+            friend class map;
         };
 
         typedef std::reverse_iterator<iterator> reverse_iterator;
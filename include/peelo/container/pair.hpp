@@ -80,7 +80,7 @@ namespace peelo
         pair& assign(const T1& first, const T2& second)
         {
             m_first = first;
-            m_second = m_second;
+            m_second = second;
 
             return *this;
         }
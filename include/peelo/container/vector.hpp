@@ -709,7 +709,7 @@ namespace peelo
 
         void insert(size_type i, size_type count, const_reference value)
         {
-            if (i >= m_size)
+            if (i > m_size)
             {
                 throw std::out_of_range("vector index out of range");
             }
@@ -717,47 +717,22 @@ namespace peelo
             {
                 return;
             }
-            else if (!i)
-            {
-                push_front(count, value);
-            }
-            else if (i == m_size)
+
+            // The value may refer to an element of this vector, which is
+            // either freed when the storage grows or moved by the shift.
+            const value_type copy(value);
+
+            reserve(m_size + count);
+            std::memmove(
+                    static_cast<void*>(m_data + i + count),
+                    static_cast<const void*>(m_data + i),
+                    sizeof(value_type) * (m_size - i)
+            );
+            for (size_type j = 0; j < count; ++j)
             {
-                push_back(count, value);
-            } else {
-                if (m_capacity >= m_size + count)
-                {
-                    std::memmove(
-                            static_cast<void*>(m_data + i + count),
-                            static_cast<const void*>(m_data + i),
-                            sizeof(value_type) * (m_size - i)
-                    );
-                } else {
-                    pointer old = m_data;
-
-                    m_data = m_allocator.allocate(m_size + count);
-                    for (size_type j = 0; j < i - count; ++j)
-                    {
-                        m_allocator.construct(m_data + j, old[j]);
-                        m_allocator.destroy(old + j);
-                    }
-                    for (size_type j = i; j < m_size; ++j)
-                    {
-                        m_allocator.construct(m_data + j + count, old[j]);
-                        m_allocator.destroy(old + j);
-                    }
-                    if (old)
-                    {
-                        m_allocator.destroy(old, m_capacity);
-                    }
-                    m_capacity = m_size + count;
-                }
-                for (size_type j = 0; j < count; ++j)
-                {
-                    m_allocator.construct(m_data + i + j, value);
-                }
-                m_size += count;
+                m_allocator.construct(m_data + i + j, copy);
             }
+            m_size += count;
         }
 
         void insert(const const_iterator& pos, const_reference& value)
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_IO_ASYNC_FILE_HPP_GUARD
+#define PEELO_IO_ASYNC_FILE_HPP_GUARD
+
+#include <peelo/io/filename.hpp>
+#include <peelo/io/io_queue.hpp>
+#include <future>
+#include <memory>
+
+namespace peelo
+{
+    /**
+     * File which is read and written asynchronously through an io_queue.
+     * All operations are positional, so any number of them can be in flight
+     * at the same time.
+     */
+    class async_file
+    {
+    public:
+        typedef io_queue::callback callback;
+
+        /**
+         * Callback for batched operations, which receives index of the
+         * segment and result of the operation.
+         */
+        typedef std::function<void(std::size_t, long)> batch_callback;
+
+        /**
+         * Flags for opening the file.
+         */
+        enum open_mode
+        {
+            /** Open for reading. */
+            in = 1,
+            /** Open for writing. */
+            out = 2,
+            /** Create the file if it does not exist. */
+            create = 4,
+            /** Truncate the file when it is opened. */
+            truncate = 8
+        };
+
+        /**
+         * Part of a batched operation.
+         */
+        struct segment
+        {
+            /** Buffer to read into or write from. */
+            void* buffer;
+            /** Number of bytes to transfer. */
+            std::size_t size;
+            /** Position in the file. */
+            uint64_t offset;
+            /**
+             * Index of registered buffer which contains the given buffer,
+             * or -1 if the buffer has not been registered.
+             */
+            int buffer_index;
+        };
+
+        /**
+         * Opens file for asynchronous operations.
+         *
+         * \param queue Queue through which the operations are performed
+         * \param file  Name of the file
+         * \param mode  Combination of open_mode flags
+         * \throw std::runtime_error If the file cannot be opened
+         */
+        async_file(io_queue& queue, const filename& file, int mode = in);
+
+        /**
+         * Destructor. Waits for operations on the file to complete and
+         * closes the file.
+         */
+        virtual ~async_file();
+
+        inline const filename& file() const
+        {
+            return m_filename;
+        }
+
+        /**
+         * Returns current size of the file in bytes.
+         */
+        uint64_t size() const;
+
+        /**
+         * Reads from given position of the file into the buffer and invokes
+         * the callback with number of bytes read.
+         */
+        void read(void* buffer,
+                  std::size_t size,
+                  uint64_t offset,
+                  const callback& done);
+
+        /**
+         * Reads from given position of the file into the buffer. Returned
+         * future receives number of bytes read, or a negated error code.
+         */
+        std::future<long> read(void* buffer,
+                               std::size_t size,
+                               uint64_t offset);
+
+        /**
+         * Reads multiple segments of the file, submitting all of them at
+         * once. The callback is invoked separately for each segment.
+         */
+        void read(const segment* segments,
+                  std::size_t count,
+                  const batch_callback& done);
+
+        /**
+         * Writes contents of the buffer into given position of the file and
+         * invokes the callback with number of bytes written.
+         */
+        void write(const void* buffer,
+                   std::size_t size,
+                   uint64_t offset,
+                   const callback& done);
+
+        /**
+         * Writes contents of the buffer into given position of the file.
+         * Returned future receives number of bytes written, or a negated
+         * error code.
+         */
+        std::future<long> write(const void* buffer,
+                                std::size_t size,
+                                uint64_t offset);
+
+        /**
+         * Writes multiple segments into the file, submitting all of them at
+         * once. The callback is invoked separately for each segment.
+         */
+        void write(const segment* segments,
+                   std::size_t count,
+                   const batch_callback& done);
+
+        /**
+         * Waits until all operations on this file have completed.
+         */
+        void wait() const;
+
+    private:
+        async_file(const async_file&);
+        async_file& operator=(const async_file&);
+
+        struct state;
+
+        void submit(bool write,
+                    const segment* segments,
+                    std::size_t count,
+                    const batch_callback& done);
+
+    private:
+        io_queue& m_queue;
+        filename m_filename;
+        io_queue::native_handle m_handle;
+        /** Bookkeeping of operations in flight. */
+        std::shared_ptr<state> m_state;
+    };
+}
+
+#endif /* !PEELO_IO_ASYNC_FILE_HPP_GUARD */
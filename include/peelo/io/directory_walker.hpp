@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_IO_DIRECTORY_WALKER_HPP_GUARD
+#define PEELO_IO_DIRECTORY_WALKER_HPP_GUARD
+
+#include <peelo/container/vector.hpp>
+#include <peelo/io/filename.hpp>
+#include <functional>
+
+namespace peelo
+{
+    /**
+     * Recursively enumerates contents of a directory tree. Directories are
+     * read in large batches and entry types are taken from the directory
+     * listing itself where the platform provides them, so files are not
+     * queried individually. Subtrees can be traversed by multiple threads,
+     * in which case idle threads steal pending directories from the busy
+     * ones.
+     */
+    class directory_walker
+    {
+    public:
+        /**
+         * Entry found during the traversal. The file name of the entry is
+         * constructed only when it is asked for, so visitors which look at
+         * the name alone do not pay for it. Entries are valid only for the
+         * duration of the callback they are passed to.
+         */
+        class entry
+        {
+        public:
+            /**
+             * Constructs entry for given name in given directory.
+             *
+             * \param directory Directory which contains the entry
+             * \param name      UTF-8 encoded name of the entry
+             * \param is_dir    Whether the entry is a directory
+             */
+            entry(const filename& directory, const char* name, bool is_dir);
+
+            /**
+             * Returns UTF-8 encoded name of the entry within its directory.
+             */
+            inline const char* name() const
+            {
+                return m_name;
+            }
+
+            /**
+             * Returns <code>true</code> if the entry is a directory which
+             * the walker would descend into, ignoring the prune predicate.
+             */
+            inline bool is_directory() const
+            {
+                return m_is_directory;
+            }
+
+            /**
+             * Returns the directory which contains the entry.
+             */
+            inline const filename& directory() const
+            {
+                return m_directory;
+            }
+
+            /**
+             * Returns full file name of the entry. It is constructed on the
+             * first call.
+             */
+            const filename& file() const;
+
+        private:
+            entry(const entry&);
+            entry& operator=(const entry&);
+
+        private:
+            /** Directory which contains the entry. */
+            const filename& m_directory;
+            /** UTF-8 encoded name of the entry. */
+            const char* m_name;
+            /** Whether the entry is a directory. */
+            const bool m_is_directory;
+            /** Full file name, once constructed. */
+            mutable filename m_file;
+            /** Whether the full file name has been constructed. */
+            mutable bool m_file_valid;
+        };
+
+        /**
+         * Callback which receives entries found during the traversal.
+         */
+        typedef std::function<void(const entry&)> visitor;
+
+        /**
+         * Callback which decides whether contents of a directory should be
+         * skipped.
+         */
+        typedef std::function<bool(const entry&)> predicate;
+
+        /**
+         * Constructs walker which traverses the given directory.
+         */
+        explicit directory_walker(const filename& root);
+
+        /**
+         * Copy constructor.
+         */
+        directory_walker(const directory_walker& that);
+
+        /**
+         * Returns the directory from which the traversal begins.
+         */
+        inline const filename& root() const
+        {
+            return m_root;
+        }
+
+        /**
+         * Sets predicate which is called for each directory found during the
+         * traversal. If it returns <code>true</code>, the directory is still
+         * reported to the visitor but its contents are not traversed.
+         */
+        void set_prune(const predicate& prune);
+
+        /**
+         * Returns <code>true</code> if symbolic links pointing to
+         * directories are followed. Disabled by default.
+         */
+        inline bool follow_symlinks() const
+        {
+            return m_follow_symlinks;
+        }
+
+        /**
+         * Enables or disables following of symbolic links which point to
+         * directories. Directories which have already been visited are
+         * skipped, so that links pointing back up in the tree do not cause
+         * infinite loops.
+         */
+        void set_follow_symlinks(bool follow);
+
+        /**
+         * Returns number of threads used for the traversal.
+         */
+        inline unsigned threads() const
+        {
+            return m_threads;
+        }
+
+        /**
+         * Sets number of threads used for the traversal, including the
+         * calling thread. Zero selects number of processors in the system.
+         * Defaults to one.
+         */
+        void set_threads(unsigned threads);
+
+        /**
+         * Traverses the directory tree and calls the visitor for every entry
+         * found, excluding the root directory itself. Directories are always
+         * reported before their contents, but otherwise the order of entries
+         * is unspecified. When multiple threads are used, the visitor and
+         * the prune predicate are called concurrently from all of them and
+         * each entry passed to them is owned by the calling thread.
+         * Directories which cannot be read are silently skipped.
+         *
+         * \throw std::runtime_error If the root directory cannot be opened
+         */
+        void walk(const visitor& v) const;
+
+        /**
+         * Traverses the directory tree and returns all entries found.
+         *
+         * \throw std::runtime_error If the root directory cannot be opened
+         */
+        vector<filename> list() const;
+
+        directory_walker& assign(const directory_walker& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline directory_walker& operator=(const directory_walker& that)
+        {
+            return assign(that);
+        }
+
+    private:
+        /** Directory from which the traversal begins. */
+        filename m_root;
+        /** Optional predicate for skipping contents of directories. */
+        predicate m_prune;
+        /** Whether symbolic links to directories are followed. */
+        bool m_follow_symlinks;
+        /** Number of threads used for the traversal. */
+        unsigned m_threads;
+    };
+}
+
+#endif /* !PEELO_IO_DIRECTORY_WALKER_HPP_GUARD */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_IO_FILE_STATUS_HPP_GUARD
+#define PEELO_IO_FILE_STATUS_HPP_GUARD
+
+#include <peelo/chrono/datetime64.hpp>
+#include <peelo/number/inttypes.hpp>
+
+namespace peelo
+{
+    class filename;
+
+    /**
+     * Snapshot of file system information about a single file, obtained with
+     * one status query. Instances are acquired with filename::status().
+     */
+    class file_status
+    {
+        friend class filename;
+
+    public:
+        /**
+         * Constructs status of a file which does not exist.
+         */
+        file_status();
+
+        /**
+         * Copy constructor.
+         */
+        file_status(const file_status& that);
+
+        /**
+         * Returns <code>true</code> if the file existed when the status was
+         * queried. Symbolic links are followed, so a link pointing to a
+         * missing file does not exist.
+         */
+        inline bool exists() const
+        {
+            return m_type != type_none;
+        }
+
+        /**
+         * Returns <code>true</code> if the file is a regular file.
+         */
+        inline bool is_file() const
+        {
+            return m_type == type_file;
+        }
+
+        /**
+         * Returns <code>true</code> if the file is a directory.
+         */
+        inline bool is_dir() const
+        {
+            return m_type == type_dir;
+        }
+
+        /**
+         * Returns <code>true</code> if the file is a pipe.
+         */
+        inline bool is_pipe() const
+        {
+            return m_type == type_pipe;
+        }
+
+        /**
+         * Returns <code>true</code> if the file is a socket.
+         */
+        inline bool is_socket() const
+        {
+            return m_type == type_socket;
+        }
+
+        /**
+         * Returns <code>true</code> if the file has sticky bit set.
+         */
+        inline bool is_sticky() const
+        {
+            return m_sticky;
+        }
+
+        /**
+         * Returns <code>true</code> if the file name itself is a symbolic
+         * link.
+         */
+        inline bool is_symlink() const
+        {
+            return m_symlink;
+        }
+
+        /**
+         * Returns size of the file in bytes.
+         */
+        inline uint64_t size() const
+        {
+            return m_size;
+        }
+
+        /**
+         * Returns time of last modification of the file.
+         */
+        inline const datetime64& mtime() const
+        {
+            return m_mtime;
+        }
+
+        /**
+         * Returns inode number of the file, or zero on platforms which do
+         * not have them.
+         */
+        inline uint64_t inode() const
+        {
+            return m_inode;
+        }
+
+        file_status& assign(const file_status& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline file_status& operator=(const file_status& that)
+        {
+            return assign(that);
+        }
+
+    private:
+        enum type
+        {
+            type_none,
+            type_file,
+            type_dir,
+            type_pipe,
+            type_socket,
+            type_other
+        };
+
+        enum type m_type;
+        bool m_symlink;
+        bool m_sticky;
+        uint64_t m_size;
+        datetime64 m_mtime;
+        uint64_t m_inode;
+    };
+}
+
+#endif /* !PEELO_IO_FILE_STATUS_HPP_GUARD */
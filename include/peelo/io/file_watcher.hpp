@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_IO_FILE_WATCHER_HPP_GUARD
+#define PEELO_IO_FILE_WATCHER_HPP_GUARD
+
+#include <peelo/chrono/duration.hpp>
+#include <peelo/io/filepath.hpp>
+#include <functional>
+#include <memory>
+
+namespace peelo
+{
+    /**
+     * Watches files and directories for changes. On Linux the changes are
+     * reported by the kernel through inotify, so nothing is polled.
+     *
+     * Changes are coalesced: when a file changes repeatedly within the
+     * coalescing interval, such as during a burst of writes, only a single
+     * event is delivered for it once the file has been quiet for the whole
+     * interval. The event then contains all kinds of changes seen during
+     * the burst.
+     *
+     * Events are delivered by calling poll(), either periodically or when
+     * the file descriptor returned by fd() becomes readable.
+     */
+    class file_watcher
+    {
+    public:
+        /**
+         * Kinds of changes which can be watched. Moves are reported as
+         * removal of the old name and creation of the new one.
+         */
+        enum change
+        {
+            created = 1,
+            modified = 2,
+            removed = 4,
+            attributes = 8,
+            all = created | modified | removed | attributes
+        };
+
+        /**
+         * Single coalesced change to a file.
+         */
+        struct event
+        {
+            /** The file which changed. */
+            filename file;
+            /** Bitmask of changes seen for the file. */
+            int changes;
+        };
+
+        /**
+         * Callback which receives events.
+         */
+        typedef std::function<void(const event&)> callback;
+
+        /**
+         * Constructs new watcher.
+         *
+         * \param coalesce Interval during which subsequent changes of a file
+         *                 are merged into a single event
+         * \throw std::runtime_error If file watching is not supported
+         */
+        explicit file_watcher(
+            const duration& coalesce = duration::from_milliseconds(50)
+        );
+
+        /**
+         * Destructor. Removes all watches.
+         */
+        virtual ~file_watcher();
+
+        /**
+         * Returns the coalescing interval.
+         */
+        inline const duration& coalesce() const
+        {
+            return m_coalesce;
+        }
+
+        /**
+         * Returns file descriptor which becomes readable when the kernel has
+         * changes to report, and when the coalescing interval of a pending
+         * change has passed. Can be passed to poll() or select() of the
+         * system, or to an event loop, which should call poll() with zero
+         * timeout whenever the descriptor is readable. The descriptor stays
+         * readable until poll() is called.
+         */
+        int fd() const;
+
+        /**
+         * Starts watching given file or directory. For directories, changes
+         * of the files directly inside them are reported. Watching the same
+         * file again replaces the kinds of changes watched.
+         *
+         * \param file    File or directory to watch
+         * \param changes Bitmask of changes to report
+         * \throw std::runtime_error If the file cannot be watched
+         */
+        void watch(const filename& file, int changes = all);
+
+        /**
+         * Starts watching all directories of a file path, so that changes to
+         * files which would be found through the path are noticed.
+         * Directories which do not exist are skipped.
+         *
+         * \return Number of directories watched
+         */
+        std::size_t watch(const filepath& path, int changes = all);
+
+        /**
+         * Stops watching given file or directory. Pending events for it are
+         * discarded.
+         */
+        void unwatch(const filename& file);
+
+        /**
+         * Returns <code>true</code> if given file or directory is being
+         * watched.
+         */
+        bool is_watched(const filename& file) const;
+
+        /**
+         * Returns <code>true</code> if there are changes waiting for their
+         * coalescing interval to pass.
+         */
+        bool has_pending() const;
+
+        /**
+         * Reads changes reported by the kernel and delivers events of files
+         * which have been quiet for the coalescing interval. Waits at most
+         * the given timeout for at least one event to become deliverable.
+         * With zero timeout, never blocks.
+         *
+         * \return Number of events delivered
+         */
+        std::size_t poll(const callback& cb,
+                         const duration& timeout = duration());
+
+    private:
+        file_watcher(const file_watcher&);
+        file_watcher& operator=(const file_watcher&);
+
+        /**
+         * Closes file descriptors of the watcher.
+         */
+        void close();
+
+    private:
+        struct state;
+
+        /** Interval during which changes of a file are merged. */
+        const duration m_coalesce;
+        std::unique_ptr<state> m_state;
+    };
+}
+
+#endif /* !PEELO_IO_FILE_WATCHER_HPP_GUARD */
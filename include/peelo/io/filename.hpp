@@ -26,7 +26,11 @@
 #ifndef PEELO_IO_FILENAME_HPP_GUARD
 #define PEELO_IO_FILENAME_HPP_GUARD
 
+#include <peelo/container/small_vector.hpp>
+#include <peelo/io/file_status.hpp>
+#include <peelo/memory/ptr.hpp>
 #include <peelo/text/string.hpp>
+#include <atomic>
 
 namespace peelo
 {
@@ -51,6 +55,13 @@ namespace peelo
          */
         filename(const string& str);
 
+        /**
+         * Constructs file name which points to an entry with given name
+         * inside the directory pointed by <i>parent</i>. Unlike the parsing
+         * constructor, the name is taken as a single component as it is.
+         */
+        filename(const filename& parent, const string& name);
+
         static bool is_separator(const rune& r);
 
         /**
@@ -135,56 +146,156 @@ namespace peelo
             return m_filename;
         }
 
+        /**
+         * Returns the file name as null terminated UTF-8 string, suitable for
+         * passing to system calls. The encoded form is computed on first use
+         * and shared between copies of the file name. Safe to call from
+         * several threads on the same file name.
+         */
+        const char* c_str() const;
+
         /**
          * Returns <code>true</code> if file name is absolute.
          */
         bool is_absolute() const;
 
+        /**
+         * Returns file name which is formed by appending <i>that</i> to this
+         * one. Leading <code>..</code> components of <i>that</i> remove
+         * components from this one. If <i>that</i> is absolute, it is
+         * returned as it is.
+         */
+        filename join(const filename& that) const;
+
+        /**
+         * Returns file name without its last component. Root of an absolute
+         * file name is its own parent, while the parent of a relative file
+         * name with a single component is empty.
+         */
+        filename parent() const;
+
+        /**
+         * Returns lexically normalized form of the file name, where
+         * <code>.</code> components are removed and <code>..</code>
+         * components remove the preceding component. File names parsed from
+         * strings are always normalized, but those constructed from a parent
+         * and an entry name are not.
+         */
+        filename normalize() const;
+
+        /**
+         * Returns relative file name which leads from <i>base</i> to this
+         * file name.
+         *
+         * \throw std::invalid_argument If the file names do not have the
+         *                              same root, or if the base contains
+         *                              <code>..</code> components which
+         *                              cannot be resolved lexically
+         */
+        filename relative_to(const filename& base) const;
+
+        /**
+         * Returns status of the file which the file name points to. The file
+         * system is queried only once and the result is cached until
+         * refresh() is called or the file name is reassigned.
+         *
+         * The cache is protected by a lock of its own, so a const file name
+         * may be queried from several threads at once. The status is
+         * returned by value, so that a concurrent refresh() cannot change
+         * it under the caller.
+         */
+        file_status status() const;
+
+        /**
+         * Discards cached file status and queries it again from the file
+         * system.
+         */
+        file_status refresh() const;
+
         /**
          * Returns <code>true</code> if file name is pointing to a regular file
          * in the file system.
          */
-        bool is_file() const;
+        inline bool is_file() const
+        {
+            return status().is_file();
+        }
 
         /**
          * Returns <code>true</code> if file name is pointing to a directory in
          * the file system.
          */
-        bool is_dir() const;
+        inline bool is_dir() const
+        {
+            return status().is_dir();
+        }
 
         /**
          * Returns <code>true</code> if file name is pointing to a pipe in the
          * file system.
          */
-        bool is_pipe() const;
+        inline bool is_pipe() const
+        {
+            return status().is_pipe();
+        }
 
         /**
          * Returns <code>true</code> if file name is pointing to a socket in
          * the file system.
          */
-        bool is_socket() const;
+        inline bool is_socket() const
+        {
+            return status().is_socket();
+        }
 
         /**
          * Returns <code>true</code> if file name is pointing to a file which
          * has sticky bit set.
          */
-        bool is_sticky() const;
+        inline bool is_sticky() const
+        {
+            return status().is_sticky();
+        }
 
         /**
          * Returns <code>true</code> if file name is pointing to a symbolic
          * link in the file system.
          */
-        bool is_symlink() const;
+        inline bool is_symlink() const
+        {
+            return status().is_symlink();
+        }
 
         /**
          * Returns <code>true</code> if the file exists in the file system.
          */
-        bool exists() const;
+        inline bool exists() const
+        {
+            return status().exists();
+        }
+
+    private:
+        filename(const string& file,
+                 const string& root,
+                 const small_vector<string, 8>& path);
+
+        /**
+         * Queries status of the file from the file system.
+         */
+        void query(file_status& status) const;
 
     private:
         string m_filename;
         string m_root;
-        vector<string> m_path;
+        small_vector<string, 8> m_path;
+        /** Lazily encoded UTF-8 form of the file name. */
+        mutable ptr<vector<char> > m_native;
+        /** Cached status of the file. */
+        mutable file_status m_status;
+        /** Whether the cached status is up to date. */
+        mutable bool m_status_valid;
+        /** Protects the cached native form and status. */
+        mutable std::atomic_flag m_cache_lock;
     };
 
     std::ostream& operator<<(std::ostream&, const filename&);
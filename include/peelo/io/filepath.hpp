@@ -27,7 +27,9 @@
 #define PEELO_IO_FILEPATH_HPP_GUARD
 
 #include <peelo/container/set.hpp>
+#include <peelo/container/vector.hpp>
 #include <peelo/io/filename.hpp>
+#include <memory>
 
 namespace peelo
 {
@@ -67,6 +69,38 @@ namespace peelo
             return m_filenames;
         }
 
+        /**
+         * Returns file names of the file path in the order in which they
+         * were declared, without duplicates. For file paths constructed from
+         * a set, the order is the iteration order of the set.
+         */
+        inline const vector<filename>& directories() const
+        {
+            return m_directories;
+        }
+
+        /**
+         * Searches directories of the file path in declared order for an
+         * executable file with given name, like a shell searches commands
+         * from <code>PATH</code>. Names which contain a file name separator
+         * are not searched but checked as they are.
+         *
+         * Contents of each directory are listed on first use and cached,
+         * until modification time of the directory changes. The cache is
+         * shared between copies of the file path.
+         *
+         * \return File name of the executable, or empty file name if it
+         *         could not be found
+         */
+        filename resolve(const string& name) const;
+
+        /**
+         * Resolves multiple names at once, as if resolve() was called for
+         * each of them, but checks each directory for modifications only
+         * once.
+         */
+        vector<filename> resolve_all(const vector<string>& names) const;
+
         filepath& assign(const filepath& that);
         filepath& assign(const set<filename>& filenames);
         filepath& assign(const string& str);
@@ -113,8 +147,16 @@ namespace peelo
             return !equals(that);
         }
 
+    private:
+        struct cache;
+
+        void reset();
+
     private:
         set<filename> m_filenames;
+        vector<filename> m_directories;
+        /** Cached directory listings used by resolve(). */
+        std::shared_ptr<cache> m_cache;
     };
 
     std::ostream& operator<<(std::ostream&, const filepath&);
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_IO_IO_QUEUE_HPP_GUARD
+#define PEELO_IO_IO_QUEUE_HPP_GUARD
+
+#include <peelo/number/inttypes.hpp>
+#include <cstddef>
+#include <functional>
+
+namespace peelo
+{
+    /**
+     * Queue for asynchronous positional reads and writes. On Linux the
+     * operations are submitted to the kernel through io_uring, and on other
+     * systems, or when io_uring is not available, they are performed with
+     * pread() and pwrite() by a pool of worker threads.
+     *
+     * Completion callbacks are invoked from a thread owned by the queue, so
+     * they should not block for long and must not throw exceptions. They may
+     * submit more requests, but must not call drain() or destroy the queue.
+     */
+    class io_queue
+    {
+    public:
+        /**
+         * Callback which receives the number of bytes transferred, or a
+         * negated error code of the failed operation.
+         */
+        typedef std::function<void(long)> callback;
+
+        /**
+         * Type of native file handle used in requests.
+         */
+        typedef int64_t native_handle;
+
+        /**
+         * Single read or write operation.
+         */
+        struct request
+        {
+            /** Whether to write instead of read. */
+            bool write;
+            /** File to operate on. */
+            native_handle handle;
+            /** Buffer to read into or write from. */
+            void* buffer;
+            /** Number of bytes to transfer. */
+            std::size_t size;
+            /** Position in the file. */
+            uint64_t offset;
+            /**
+             * Index of registered buffer which contains the given buffer,
+             * or -1 if the buffer has not been registered.
+             */
+            int buffer_index;
+            /** Callback invoked when the operation completes. */
+            callback done;
+        };
+
+        /**
+         * Constructs new queue.
+         *
+         * \param depth          Maximum number of operations in flight
+         * \param allow_io_uring Whether io_uring may be used
+         * \param threads        Number of worker threads, when io_uring is
+         *                       not used
+         * \throw std::runtime_error If the queue cannot be initialized
+         */
+        explicit io_queue(unsigned depth = 256,
+                          bool allow_io_uring = true,
+                          unsigned threads = 4);
+
+        /**
+         * Destructor. Waits for pending operations to complete.
+         */
+        virtual ~io_queue();
+
+        /**
+         * Returns <code>true</code> if operations are submitted through
+         * io_uring instead of the thread pool.
+         */
+        bool uses_io_uring() const;
+
+        /**
+         * Registers buffers with the kernel, so that they do not have to be
+         * mapped for every operation. Requests refer to the buffers by their
+         * index. Previously registered buffers are replaced. Must not be
+         * called while operations are in flight.
+         *
+         * \throw std::runtime_error If the buffers cannot be registered
+         */
+        void register_buffers(void* const* buffers,
+                              const std::size_t* sizes,
+                              std::size_t count);
+
+        /**
+         * Submits given requests for execution. With io_uring, all of them
+         * are handed to the kernel with a single system call when the queue
+         * has room for them. Requests which do not fit are held in memory
+         * until earlier operations complete, so this never blocks with
+         * either implementation and can be called from completion
+         * callbacks.
+         *
+         * Either all of the requests are accepted, or none of them are and
+         * an exception is thrown. If the kernel refuses requests which were
+         * accepted, they complete with a negated error code.
+         *
+         * \throw std::runtime_error If the requests cannot be submitted
+         */
+        void submit(const request* requests, std::size_t count);
+
+        /**
+         * Submits single request for execution.
+         */
+        inline void submit(const request& r)
+        {
+            submit(&r, 1);
+        }
+
+        /**
+         * Waits until all submitted operations have completed and their
+         * callbacks have returned.
+         */
+        void drain();
+
+    private:
+        io_queue(const io_queue&);
+        io_queue& operator=(const io_queue&);
+
+    private:
+        class backend;
+        class uring_backend;
+        class thread_backend;
+
+        backend* m_backend;
+    };
+}
+
+#endif /* !PEELO_IO_IO_QUEUE_HPP_GUARD */
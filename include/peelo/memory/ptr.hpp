@@ -93,9 +93,9 @@ namespace peelo
             {
                 delete m_pointer;
                 delete m_counter;
-                m_pointer = 0;
-                m_counter = 0;
             }
+            m_pointer = 0;
+            m_counter = 0;
         }
 
         void swap(ptr<T>& that)
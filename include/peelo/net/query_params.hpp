@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_NET_QUERY_PARAMS_HPP_GUARD
+#define PEELO_NET_QUERY_PARAMS_HPP_GUARD
+
+#include <peelo/container/map.hpp>
+#include <peelo/container/pair.hpp>
+#include <peelo/text/string.hpp>
+#include <iterator>
+
+namespace peelo
+{
+    /**
+     * Lazy view over parameters of a query string such as
+     * "a=1&b=2&flag". Iterating yields key and value of each parameter as
+     * substrings of the query, which are neither copied nor decoded.
+     * Parameters without "=" have empty value and empty parameters are
+     * skipped.
+     */
+    class query_params
+    {
+    public:
+        class iterator;
+        typedef pair<string, string> value_type;
+        typedef iterator const_iterator;
+
+        /**
+         * Constructs view over given query string, which should not include
+         * the leading "?".
+         */
+        explicit query_params(const string& query = string());
+
+        /**
+         * Copy constructor.
+         */
+        query_params(const query_params& that);
+
+        /**
+         * Returns the query string.
+         */
+        inline const string& query() const
+        {
+            return m_query;
+        }
+
+        /**
+         * Returns <code>true</code> if the query string contains no
+         * parameters.
+         */
+        inline bool empty() const
+        {
+            return begin() == end();
+        }
+
+        iterator begin() const;
+
+        iterator end() const;
+
+        /**
+         * Inserts the parameters into given map. When a key appears multiple
+         * times, the last value is kept.
+         *
+         * \param decode Whether keys and values are percent decoded, with
+         *               "+" decoded as space
+         * \throws std::invalid_argument If decoding is requested and the
+         *                               query contains malformed
+         *                               percent encoding
+         */
+        void to_map(map<string, string>& result, bool decode = true) const;
+
+        query_params& assign(const query_params& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline query_params& operator=(const query_params& that)
+        {
+            return assign(that);
+        }
+
+        class iterator
+        {
+            friend class query_params;
+
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef query_params::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type* pointer;
+            typedef const value_type& reference;
+
+            iterator(const iterator& that)
+                : m_query(that.m_query)
+                , m_begin(that.m_begin)
+                , m_end(that.m_end)
+                , m_value(that.m_value) {}
+
+            iterator& operator=(const iterator& that)
+            {
+                m_query = that.m_query;
+                m_begin = that.m_begin;
+                m_end = that.m_end;
+                m_value = that.m_value;
+
+                return *this;
+            }
+
+            inline reference operator*() const
+            {
+                return m_value;
+            }
+
+            inline pointer operator->() const
+            {
+                return &m_value;
+            }
+
+            iterator& operator++();
+
+            inline iterator operator++(int)
+            {
+                iterator copy(*this);
+
+                ++(*this);
+
+                return copy;
+            }
+
+            inline bool operator==(const iterator& that) const
+            {
+                return m_begin == that.m_begin;
+            }
+
+            inline bool operator!=(const iterator& that) const
+            {
+                return m_begin != that.m_begin;
+            }
+
+        private:
+            iterator(const string* query, string::size_type pos);
+
+            /**
+             * Finds the first non-empty parameter starting from given
+             * position.
+             */
+            void seek(string::size_type pos);
+
+        private:
+            const string* m_query;
+            /** Position of the current parameter in the query. */
+            string::size_type m_begin;
+            /** Position of the "&" ending the current parameter. */
+            string::size_type m_end;
+            value_type m_value;
+        };
+
+    private:
+        string m_query;
+    };
+}
+
+#endif /* !PEELO_NET_QUERY_PARAMS_HPP_GUARD */
@@ -26,7 +26,9 @@
 #ifndef PEELO_NET_URI_HPP_GUARD
 #define PEELO_NET_URI_HPP_GUARD
 
-#include <peelo/text/string.hpp>
+#include <peelo/net/query_params.hpp>
+#include <atomic>
+#include <cstddef>
 
 namespace peelo
 {
@@ -35,6 +37,10 @@ namespace peelo
     public:
         /**
          * Default constructor for URI.
+         *
+         * \param has_authority Whether the URI has an authority even when
+         *                      the host name is empty, as in
+         *                      "file:///etc/hosts"
          */
         explicit uri(const string& scheme = string(),
                      const string& scheme_specific = string(),
@@ -44,7 +50,8 @@ namespace peelo
                      int port = 0,
                      const string& path = string(),
                      const string& query = string(),
-                     const string& fragment = string());
+                     const string& fragment = string(),
+                     bool has_authority = false);
 
         /**
          * Copy constructor.
@@ -53,6 +60,84 @@ namespace peelo
          */
         uri(const uri& that);
 
+        /**
+         * Destructor.
+         */
+        ~uri();
+
+        /**
+         * Parses URI reference as specified by RFC 3986. Both absolute URIs
+         * and relative references are accepted. The input is validated in
+         * a single pass and the components of the returned URI are
+         * substrings sharing the buffer of the input string, so nothing is
+         * copied.
+         *
+         * The scheme specific part of the returned URI is everything between
+         * the scheme and the fragment. Host names in IP literal form keep
+         * their brackets.
+         *
+         * \throws std::invalid_argument If the input is not valid URI
+         */
+        static uri parse(const string& input);
+
+        /**
+         * Parses URI reference from a raw character buffer. Valid URIs
+         * consist of ASCII characters only, so the input is decoded into a
+         * single string buffer which all components share.
+         *
+         * \throws std::invalid_argument If the input is not valid URI
+         */
+        static uri parse(const char* input, std::size_t length);
+
+        /**
+         * Decodes percent encoded octets of the input. The decoded octets
+         * are interpreted as UTF-8, and decoding stops at the first
+         * malformed sequence. When nothing needs to be decoded, the input
+         * itself is returned.
+         *
+         * \param plus_as_space Whether "+" is decoded as space, as in HTML
+         *                      form data
+         * \throws std::invalid_argument If "%" is not followed by two
+         *                               hexadecimal digits
+         */
+        static string percent_decode(const string& input,
+                                     bool plus_as_space = false);
+
+        /**
+         * Decodes percent encoded octets of raw input into the output
+         * buffer, which must have room for <i>length</i> characters and may
+         * be the same as the input. Runs of characters between "%" signs
+         * are located with <code>memchr()</code> and copied as blocks.
+         *
+         * \return Number of characters written into the output buffer
+         * \throws std::invalid_argument If "%" is not followed by two
+         *                               hexadecimal digits
+         */
+        static std::size_t percent_decode(const char* input,
+                                          std::size_t length,
+                                          char* output,
+                                          bool plus_as_space = false);
+
+        /**
+         * Percent encodes all characters of the input except unreserved
+         * characters of RFC 3986 and those listed in <i>safe</i>. Characters
+         * outside ASCII are encoded as UTF-8 octets. When nothing needs to
+         * be encoded, the input itself is returned.
+         */
+        static string percent_encode(const string& input,
+                                     const char* safe = "");
+
+        /**
+         * Percent encodes raw input into the output buffer, which must have
+         * room for three times <i>length</i> characters.
+         *
+         * \return Number of characters written into the output buffer
+         */
+        static std::size_t percent_encode(const char* input,
+                                          std::size_t length,
+                                          char* output,
+                                          const char* safe = "");
+
         /**
          * Returns scheme of the URI or empty string if not specified.
          */
@@ -70,6 +155,15 @@ namespace peelo
             return m_scheme_specific;
         }
 
+        /**
+         * Returns true if the URI has an authority component, which may be
+         * empty, as in "file:///etc/hosts".
+         */
+        inline bool has_authority() const
+        {
+            return m_has_authority;
+        }
+
         /**
          * Returns the authority part of the URI in form of
          * "username:password", or empty string if it's not defined in the
@@ -138,6 +232,44 @@ namespace peelo
             return m_fragment;
         }
 
+        /**
+         * Returns lazy view over parameters of the query string.
+         */
+        inline query_params params() const
+        {
+            return query_params(m_query);
+        }
+
+        /**
+         * Returns normalized copy of the URI, as specified in section 6 of
+         * RFC 3986:
+         *
+         * - Scheme and host name are converted into lower case.
+         * - Percent encoded unreserved characters are decoded and hexadecimal
+         *   digits of the remaining ones are converted into upper case.
+         * - Dot segments are removed from the path of absolute URIs.
+         * - Default port of the scheme is removed and empty path of HTTP
+         *   URIs is replaced with "/".
+         */
+        uri normalize() const;
+
+        /**
+         * Serializes the URI into a string.
+         */
+        string to_string() const;
+
+        /**
+         * Returns serialized form of the normalized URI. It is computed on
+         * first use and cached, and is used for comparing and hashing URIs.
+         * The cache is filled with an atomic compare and swap, so that the
+         * URI can be compared and hashed from several threads at once;
+         * threads racing on the first use may each compute the canonical
+         * form, but only one of them is kept. Parsing stays as cheap as
+         * before, since the URIs which are never compared do not pay for
+         * normalization.
+         */
+        const string& canonical() const;
+
         /**
          * Copies contents of another URI into this one.
          *
@@ -153,6 +285,28 @@ namespace peelo
             return assign(that);
         }
 
+        /**
+         * Tests whether the URI is equivalent to another one, by comparing
+         * their canonical forms.
+         */
+        bool equals(const uri& that) const;
+
+        /**
+         * Equality testing operator.
+         */
+        inline bool operator==(const uri& that) const
+        {
+            return equals(that);
+        }
+
+        /**
+         * Non-equality testing operator.
+         */
+        inline bool operator!=(const uri& that) const
+        {
+            return !equals(that);
+        }
+
     private:
         string m_scheme;
         string m_scheme_specific;
@@ -163,9 +317,24 @@ namespace peelo
         string m_path;
         string m_query;
         string m_fragment;
+        /** Whether "//" and authority are present, even if empty. */
+        bool m_has_authority;
+        /** Cached serialized form of the normalized URI, or null. */
+        mutable std::atomic<const string*> m_canonical;
     };
 
     std::ostream& operator<<(std::ostream&, const uri&);
+
+    template<>
+    struct hash<uri>
+    {
+        typedef std::size_t result_type;
+
+        result_type operator()(const uri& key) const
+        {
+            return hash<string>()(key.canonical());
+        }
+    };
 }
 
 #endif /* !PEELO_NET_URI_HPP_GUARD */
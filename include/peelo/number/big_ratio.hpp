@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_NUMBER_BIG_RATIO_HPP_GUARD
+#define PEELO_NUMBER_BIG_RATIO_HPP_GUARD
+
+#include <peelo/number/bigint.hpp>
+#include <peelo/number/ratio.hpp>
+
+namespace peelo
+{
+    /**
+     * Rational number with arbitrary precision numerator and denominator.
+     * Like <code>ratio</code>, the number is always kept in lowest terms
+     * with positive denominator, but arithmetic never overflows.
+     */
+    class big_ratio
+    {
+    public:
+        /**
+         * Constructs rational number which represents zero.
+         */
+        big_ratio();
+
+        /**
+         * Copy constructor.
+         */
+        big_ratio(const big_ratio& that);
+
+        /**
+         * Constructs rational number from fixed precision one.
+         */
+        big_ratio(const ratio& that);
+
+        /**
+         * Constructs new rational number.
+         *
+         * \param numerator         Numerator part
+         * \param denominator       Denominator part
+         * \throw std::domain_error If denominator is zero
+         */
+        explicit big_ratio(const bigint& numerator,
+                           const bigint& denominator = bigint(1));
+
+        /**
+         * Returns denominator.
+         */
+        inline const bigint& denominator() const
+        {
+            return m_denominator;
+        }
+
+        /**
+         * Returns numerator.
+         */
+        inline const bigint& numerator() const
+        {
+            return m_numerator;
+        }
+
+        /**
+         * Tests whether the number can be represented as <code>ratio</code>.
+         */
+        bool fits_ratio() const;
+
+        /**
+         * Converts the number into fixed precision rational number.
+         *
+         * \throw std::overflow_error If the number does not fit
+         */
+        ratio to_ratio() const;
+
+        /**
+         * Returns the number in form "numerator/denominator".
+         */
+        string to_string() const;
+
+        big_ratio& assign(const big_ratio& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline big_ratio& operator=(const big_ratio& that)
+        {
+            return assign(that);
+        }
+
+        /**
+         * Tests whether two rational numbers are equal.
+         *
+         * \param that Other rational number to test equality with
+         */
+        bool equals(const big_ratio& that) const;
+
+        /**
+         * Equality testing operator.
+         */
+        inline bool operator==(const big_ratio& that) const
+        {
+            return equals(that);
+        }
+
+        /**
+         * Non-equality testing operator.
+         */
+        inline bool operator!=(const big_ratio& that) const
+        {
+            return !equals(that);
+        }
+
+        /**
+         * Compares two rational numbers against each other.
+         *
+         * \param that Other rational number to test this one against
+         */
+        int compare(const big_ratio& that) const;
+
+        inline bool operator<(const big_ratio& that) const
+        {
+            return compare(that) < 0;
+        }
+
+        inline bool operator>(const big_ratio& that) const
+        {
+            return compare(that) > 0;
+        }
+
+        inline bool operator<=(const big_ratio& that) const
+        {
+            return compare(that) <= 0;
+        }
+
+        inline bool operator>=(const big_ratio& that) const
+        {
+            return compare(that) >= 0;
+        }
+
+        big_ratio operator-() const;
+
+        big_ratio operator+(const big_ratio& that) const;
+        big_ratio operator-(const big_ratio& that) const;
+        big_ratio operator*(const big_ratio& that) const;
+
+        /**
+         * Division operator.
+         *
+         * \throw std::domain_error If the divisor is zero
+         */
+        big_ratio operator/(const big_ratio& that) const;
+
+        big_ratio& operator+=(const big_ratio& that);
+        big_ratio& operator-=(const big_ratio& that);
+        big_ratio& operator*=(const big_ratio& that);
+        big_ratio& operator/=(const big_ratio& that);
+
+    private:
+        /** Numerator. */
+        bigint m_numerator;
+        /** Denominator. */
+        bigint m_denominator;
+    };
+
+    std::ostream& operator<<(std::ostream&, const big_ratio&);
+}
+
+#endif /* !PEELO_NUMBER_BIG_RATIO_HPP_GUARD */
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_NUMBER_BIGINT_HPP_GUARD
+#define PEELO_NUMBER_BIGINT_HPP_GUARD
+
+#include <peelo/container/small_vector.hpp>
+#include <peelo/number/inttypes.hpp>
+#include <peelo/text/string.hpp>
+#include <iostream>
+#include <stdexcept>
+
+namespace peelo
+{
+    /**
+     * Arbitrary precision integer. The magnitude is stored as 32-bit limbs,
+     * least significant first, and values up to 64 bits are kept inline
+     * without allocating memory.
+     *
+     * Multiplication switches from the schoolbook method into Karatsuba's
+     * method for large operands. Conversions from and into decimal strings
+     * split the number recursively by powers of ten, so that most of the
+     * work is done on halves of the number.
+     */
+    class bigint
+    {
+    public:
+        /**
+         * Constructs integer which represents zero.
+         */
+        bigint();
+
+        /**
+         * Copy constructor.
+         */
+        bigint(const bigint& that);
+
+        /**
+         * Constructs integer from a native integer.
+         */
+        bigint(int64_t n);
+
+        /**
+         * Parses decimal integer from a string, with optional leading sign.
+         *
+         * \throws std::invalid_argument If the input is not valid integer
+         */
+        static bigint parse(const string& input);
+
+        /**
+         * Parses decimal integer from a raw character buffer.
+         *
+         * \throws std::invalid_argument If the input is not valid integer
+         */
+        static bigint parse(const char* input, std::size_t length);
+
+        /**
+         * Returns greatest common divisor of two integers, which is always
+         * non-negative.
+         */
+        static bigint gcd(const bigint& a, const bigint& b);
+
+        /**
+         * Divides <i>a</i> with <i>b</i>, rounding towards zero, and stores
+         * both quotient and remainder. Remainder has the sign of <i>a</i>.
+         *
+         * \throw std::domain_error If <i>b</i> is zero
+         */
+        static void divide(const bigint& a,
+                           const bigint& b,
+                           bigint& quotient,
+                           bigint& remainder);
+
+        /**
+         * Returns <code>true</code> if the integer is zero.
+         */
+        inline bool is_zero() const
+        {
+            return m_limbs.empty();
+        }
+
+        /**
+         * Returns <code>true</code> if the integer is less than zero.
+         */
+        inline bool is_negative() const
+        {
+            return m_negative;
+        }
+
+        /**
+         * Returns -1, 0 or 1 depending on the sign of the integer.
+         */
+        inline int sign() const
+        {
+            return m_negative ? -1 : m_limbs.empty() ? 0 : 1;
+        }
+
+        /**
+         * Returns <code>true</code> if the integer can be represented as
+         * 64-bit signed integer.
+         */
+        bool fits_int64() const;
+
+        /**
+         * Converts the integer into 64-bit signed integer.
+         *
+         * \throw std::overflow_error If the integer does not fit
+         */
+        int64_t to_int64() const;
+
+        /**
+         * Returns decimal representation of the integer.
+         */
+        string to_string() const;
+
+        bigint& assign(const bigint& that);
+
+        /**
+         * Assignment operator.
+         */
+        inline bigint& operator=(const bigint& that)
+        {
+            return assign(that);
+        }
+
+        bool equals(const bigint& that) const;
+
+        /**
+         * Equality testing operator.
+         */
+        inline bool operator==(const bigint& that) const
+        {
+            return equals(that);
+        }
+
+        /**
+         * Non-equality testing operator.
+         */
+        inline bool operator!=(const bigint& that) const
+        {
+            return !equals(that);
+        }
+
+        int compare(const bigint& that) const;
+
+        inline bool operator<(const bigint& that) const
+        {
+            return compare(that) < 0;
+        }
+
+        inline bool operator>(const bigint& that) const
+        {
+            return compare(that) > 0;
+        }
+
+        inline bool operator<=(const bigint& that) const
+        {
+            return compare(that) <= 0;
+        }
+
+        inline bool operator>=(const bigint& that) const
+        {
+            return compare(that) >= 0;
+        }
+
+        bigint operator-() const;
+
+        bigint operator+(const bigint& that) const;
+        bigint operator-(const bigint& that) const;
+        bigint operator*(const bigint& that) const;
+        bigint operator/(const bigint& that) const;
+        bigint operator%(const bigint& that) const;
+
+        bigint& operator+=(const bigint& that);
+        bigint& operator-=(const bigint& that);
+        bigint& operator*=(const bigint& that);
+        bigint& operator/=(const bigint& that);
+        bigint& operator%=(const bigint& that);
+
+    private:
+        typedef small_vector<uint32_t, 2> limb_vector;
+
+        /**
+         * Adds magnitude of another integer, with given sign, into this one.
+         */
+        bigint& add(const bigint& that, bool negative);
+
+        /**
+         * Removes leading zero limbs and clears sign of zero.
+         */
+        void trim();
+
+    private:
+        /** Whether the integer is negative. */
+        bool m_negative;
+        /** Magnitude of the integer, least significant limb first. */
+        limb_vector m_limbs;
+    };
+
+    std::ostream& operator<<(std::ostream&, const bigint&);
+}
+
+#endif /* !PEELO_NUMBER_BIGINT_HPP_GUARD */
@@ -33,7 +33,16 @@
 namespace peelo
 {
     /**
-     * Implementation of rational number.
+     * Implementation of rational number. Rational numbers are always kept
+     * in lowest terms with positive denominator.
+     *
+     * Arithmetic is performed with 128-bit intermediate results where the
+     * compiler supports them, and operands are reduced against each other
+     * before multiplying, so results are exact whenever they fit into 64-bit
+     * numerator and denominator. Without 128-bit support, results whose
+     * intermediate values exceed 64 bits are treated as not fitting. Results
+     * which do not fit are reported by the checked variants and cause the
+     * operators to throw <code>std::overflow_error</code>.
      */
     class ratio
     {
@@ -54,9 +63,10 @@ namespace peelo
          * \param numerator         Numerator part
          * \param denominator       Denominator part
          * \throw std::domain_error If denominator is zero
+         * \throw std::overflow_error If the reduced number cannot be
+         *                            represented with positive denominator
          */
-        explicit ratio(int64_t numerator, int64_t denominator = 1)
-            throw(std::domain_error);
+        explicit ratio(int64_t numerator, int64_t denominator = 1);
 
         /**
          * Returns denominator.
@@ -134,6 +144,43 @@ namespace peelo
             return compare(that) >= 0;
         }
 
+        /**
+         * Adds another rational number to this one and stores the sum into
+         * <i>result</i>.
+         *
+         * \return <code>false</code> if the sum cannot be represented, in
+         *         which case <i>result</i> is left untouched
+         */
+        bool checked_add(const ratio& that, ratio& result) const;
+
+        /**
+         * Subtracts another rational number from this one and stores the
+         * difference into <i>result</i>.
+         *
+         * \return <code>false</code> if the difference cannot be
+         *         represented, in which case <i>result</i> is left untouched
+         */
+        bool checked_subtract(const ratio& that, ratio& result) const;
+
+        /**
+         * Multiplies this rational number with another one and stores the
+         * product into <i>result</i>.
+         *
+         * \return <code>false</code> if the product cannot be represented,
+         *         in which case <i>result</i> is left untouched
+         */
+        bool checked_multiply(const ratio& that, ratio& result) const;
+
+        /**
+         * Divides this rational number with another one and stores the
+         * quotient into <i>result</i>.
+         *
+         * \return <code>false</code> if the quotient cannot be represented,
+         *         in which case <i>result</i> is left untouched
+         * \throw std::domain_error If the divisor is zero
+         */
+        bool checked_divide(const ratio& that, ratio& result) const;
+
         ratio operator-() const;
 
         ratio operator+(const ratio& that) const;
@@ -160,6 +207,15 @@ namespace peelo
         ratio& operator/=(const ratio& that);
         ratio& operator/=(int64_t n);
 
+    private:
+        /**
+         * Stores rational number already in lowest terms, given as sign and
+         * magnitudes. Returns <code>false</code> if it cannot be represented.
+         */
+        bool set_reduced(bool negative,
+                         uint64_t numerator,
+                         uint64_t denominator);
+
     private:
         /** Numerator. */
         int64_t m_numerator;
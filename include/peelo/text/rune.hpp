@@ -45,14 +45,16 @@ namespace peelo
         /** Maximum value for rune. */
         static const rune max;
 
-        rune();
+        inline rune()
+            : m_code(0) {}
 
         explicit rune(value_type code);
 
         /**
          * Copy constructor.
          */
-        rune(const rune& that);
+        inline rune(const rune& that)
+            : m_code(that.m_code) {}
 
         /**
          * Returns <code>true</code> if rune value is zero.
@@ -77,7 +79,9 @@ namespace peelo
 
         inline rune& operator=(const rune& that)
         {
-            return assign(that);
+            m_code = that.m_code;
+
+            return *this;
         }
 
         inline rune& operator=(value_type code)
@@ -68,6 +68,12 @@ namespace peelo
          */
         string(const char* input);
 
+        /**
+         * Constructs string from given number of bytes of UTF-8 encoded
+         * input. Decoding stops at the first malformed sequence.
+         */
+        string(const char* input, size_type length);
+
         /**
          * Destructor.
          */
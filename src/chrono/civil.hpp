@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_CIVIL_HPP_GUARD
+#define PEELO_CHRONO_CIVIL_HPP_GUARD
+
+namespace peelo
+{
+    static const long seconds_per_civil_day = 86400;
+
+    /**
+     * Returns number of days since 1970-01-01 for given date in the
+     * proleptic Gregorian calendar. Based on the days_from_civil() algorithm
+     * by Howard Hinnant, which works in constant time without lookup tables.
+     */
+    static inline long days_from_civil(long year, int month, int day)
+    {
+        year -= month <= 2;
+
+        const long era = (year >= 0 ? year : year - 399) / 400;
+        const unsigned yoe = static_cast<unsigned>(year - era * 400);
+        const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5
+            + day - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+        return era * 146097 + static_cast<long>(doe) - 719468;
+    }
+
+    /**
+     * Inverse of days_from_civil(). Converts number of days since 1970-01-01
+     * into year, month (1 - 12) and day of the month (1 - 31).
+     */
+    static inline void civil_from_days(long days,
+                                       long& year,
+                                       int& month,
+                                       int& day)
+    {
+        days += 719468;
+
+        const long era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned doe = static_cast<unsigned>(days - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096)
+            / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+
+        day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        year = static_cast<long>(yoe) + era * 400 + (month <= 2);
+    }
+
+    /**
+     * Returns number of days (28 - 31) in given month of given year.
+     */
+    static inline int days_in_civil_month(long year, int month)
+    {
+        if (month == 2)
+        {
+            return 28 + ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0);
+        }
+
+        // 30 days for April, June, September and November, 31 for the rest.
+        return 30 + ((month + (month >> 3)) & 1);
+    }
+
+    /**
+     * Returns ISO weekday index (1 = Monday, 7 = Sunday) for given number of
+     * days since 1970-01-01, which was a Thursday.
+     */
+    static inline int weekday_from_days(long days)
+    {
+        const long r = (days + 3) % 7;
+
+        // Adds 7 to negative remainders without branching.
+        return static_cast<int>(r + (7 & -static_cast<long>(r < 0))) + 1;
+    }
+
+    /**
+     * Splits UNIX timestamp into number of days since 1970-01-01 and number
+     * of seconds since midnight, rounding towards negative infinity.
+     */
+    static inline void split_timestamp(long timestamp, long& days, long& seconds)
+    {
+        days = timestamp / seconds_per_civil_day;
+        seconds = timestamp % seconds_per_civil_day;
+        if (seconds < 0)
+        {
+            --days;
+            seconds += seconds_per_civil_day;
+        }
+    }
+}
+
+#endif /* !PEELO_CHRONO_CIVIL_HPP_GUARD */
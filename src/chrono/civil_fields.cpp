@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/civil_fields.hpp>
+#include "civil.hpp"
+
+namespace peelo
+{
+    static const int64_t seconds_per_day = 86400;
+    static const int64_t days_per_era = 146097;
+    // Number of eras added to day numbers so that the fast path can work
+    // with unsigned 32-bit arithmetic. Covers years from -799 999 to
+    // 800 000.
+    static const int64_t era_bias = 2000;
+    static const int64_t min_fast_days = -era_bias * days_per_era;
+    static const int64_t max_fast_days = era_bias * days_per_era;
+
+    // Number of timestamps converted at once. Day numbers and seconds of
+    // the day of a batch are kept on the stack between the passes.
+    static const std::size_t batch_size = 256;
+
+    /**
+     * Splits timestamp into day number and seconds of the day, with floor
+     * division.
+     */
+    static inline int64_t split(int64_t timestamp, uint32_t& seconds)
+    {
+        const int64_t quotient = timestamp / seconds_per_day;
+        const int64_t remainder = timestamp - quotient * seconds_per_day;
+        const int64_t borrow = remainder < 0;
+
+        seconds = static_cast<uint32_t>(remainder + borrow * seconds_per_day);
+
+        return quotient - borrow;
+    }
+
+    /**
+     * Converts biased day number and seconds of the day into calendar
+     * fields. This is the same algorithm as civil_from_days() used by date
+     * and datetime, but evaluated in unsigned 32-bit arithmetic with
+     * conditionals written as arithmetic, so that a loop over it contains
+     * no branches and can be vectorized.
+     */
+    static inline void to_fields_fast(uint32_t z,
+                                      uint32_t seconds,
+                                      civil_fields& output)
+    {
+        const uint32_t era = z / 146097;
+        const uint32_t doe = z - era * 146097;
+        const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096)
+            / 365;
+        const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const uint32_t mp = (5 * doy + 2) / 153;
+        const uint32_t early = mp >= 10;
+        // Year biased by a multiple of 400, so that the leap year rules
+        // work on it as they are.
+        const uint32_t year = yoe + era * 400 + early;
+        const uint32_t leap = ((year % 4 == 0) & (year % 100 != 0))
+            | (year % 400 == 0);
+
+        output.year = static_cast<int32_t>(year)
+            - static_cast<int32_t>(era_bias * 400);
+        output.month = static_cast<int32_t>(mp + 3 - early * 12);
+        output.day = static_cast<int32_t>(doy - (153 * mp + 2) / 5 + 1);
+        output.hour = static_cast<int32_t>(seconds / 3600);
+        output.minute = static_cast<int32_t>(seconds / 60 % 60);
+        output.second = static_cast<int32_t>(seconds % 60);
+        // 146097 is divisible by 7 and 719468 leaves remainder of 1, so
+        // (days + 3) mod 7 equals (z + 2) mod 7.
+        output.weekday = static_cast<int32_t>((z + 2) % 7 + 1);
+        // Day of the year counted from March 1st is converted into one
+        // counted from January 1st. January and February are at the end of
+        // the March based year.
+        output.day_of_year = static_cast<int32_t>(
+                doy + 60 + leap - early * (365 + leap)
+        );
+    }
+
+    /**
+     * Converts single timestamp into calendar fields with the general
+     * 64-bit algorithm, for dates outside the range of the fast path.
+     */
+    static void to_fields(int64_t timestamp, civil_fields& output)
+    {
+        uint32_t seconds;
+        const int64_t days = split(timestamp, seconds);
+        long year;
+        int month;
+        int day;
+
+        civil_from_days(static_cast<long>(days), year, month, day);
+        output.year = static_cast<int32_t>(year);
+        output.month = month;
+        output.day = day;
+        output.hour = static_cast<int32_t>(seconds / 3600);
+        output.minute = static_cast<int32_t>(seconds / 60 % 60);
+        output.second = static_cast<int32_t>(seconds % 60);
+        output.weekday = weekday_from_days(static_cast<long>(days));
+        output.day_of_year = static_cast<int32_t>(
+                days - days_from_civil(year, 1, 1) + 1
+        );
+    }
+
+    /**
+     * Converts at most batch_size timestamps. The range of the whole batch
+     * is checked once, so that the loop doing the calendar arithmetic has
+     * no branches when every date is within years -799999 and 800000.
+     */
+    static void to_civil_batch(const int64_t* timestamps,
+                               std::size_t n,
+                               civil_fields* output)
+    {
+        uint32_t days[batch_size];
+        uint32_t seconds[batch_size];
+        int64_t low = max_fast_days;
+        int64_t high = min_fast_days;
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const int64_t d = split(timestamps[i], seconds[i]);
+
+            low = d < low ? d : low;
+            high = d > high ? d : high;
+            days[i] = static_cast<uint32_t>(
+                    d + 719468 + era_bias * days_per_era
+            );
+        }
+
+        if (low < min_fast_days || high >= max_fast_days)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                to_fields(timestamps[i], output[i]);
+            }
+            return;
+        }
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            to_fields_fast(days[i], seconds[i], output[i]);
+        }
+    }
+
+    void to_civil(const int64_t* timestamps,
+                  std::size_t n,
+                  civil_fields* output)
+    {
+        for (std::size_t i = 0; i < n; i += batch_size)
+        {
+            to_civil_batch(timestamps + i,
+                           n - i < batch_size ? n - i : batch_size,
+                           output + i);
+        }
+    }
+
+    void to_civil(const int64_t* timestamps,
+                  std::size_t n,
+                  civil_fields* output,
+                  const time_zone& zone)
+    {
+        int64_t local[batch_size];
+
+        for (std::size_t i = 0; i < n; i += batch_size)
+        {
+            const std::size_t count = n - i < batch_size ? n - i : batch_size;
+
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                local[j] = zone.to_local(static_cast<long>(timestamps[i + j]));
+            }
+            to_civil_batch(local, count, output + i);
+        }
+    }
+
+    void from_civil(const civil_fields* input, std::size_t n, int64_t* output)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const civil_fields& f = input[i];
+            const int64_t early = f.month <= 2;
+            const int64_t year = static_cast<int64_t>(f.year) - early;
+            const int64_t era = (year - (year < 0) * 399) / 400;
+            const uint32_t yoe = static_cast<uint32_t>(year - era * 400);
+            const uint32_t doy = static_cast<uint32_t>(
+                    (153 * (f.month + 9 - (1 - early) * 12) + 2) / 5 + f.day - 1
+            );
+            const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            const int64_t days = era * 146097
+                + static_cast<int64_t>(doe)
+                - 719468;
+
+            output[i] = days * seconds_per_day
+                + f.hour * 3600
+                + f.minute * 60
+                + f.second;
+        }
+    }
+}
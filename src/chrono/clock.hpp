@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef PEELO_CHRONO_CLOCK_HPP_GUARD
+#define PEELO_CHRONO_CLOCK_HPP_GUARD
+
+#include <peelo/number/inttypes.hpp>
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+namespace peelo
+{
+    /**
+     * Reads the system wall clock as UNIX timestamp and nanoseconds within
+     * that second.
+     */
+    static inline void realtime_now(long& seconds, int& nanoseconds)
+    {
+#if defined(_WIN32)
+        FILETIME ft;
+        ULARGE_INTEGER ticks;
+
+        ::GetSystemTimeAsFileTime(&ft);
+        ticks.LowPart = ft.dwLowDateTime;
+        ticks.HighPart = ft.dwHighDateTime;
+        // FILETIME counts 100 nanosecond intervals since 1601-01-01.
+        ticks.QuadPart -= 116444736000000000ULL;
+        seconds = static_cast<long>(ticks.QuadPart / 10000000ULL);
+        nanoseconds = static_cast<int>(ticks.QuadPart % 10000000ULL) * 100;
+#else
+        struct timespec ts;
+
+        ::clock_gettime(CLOCK_REALTIME, &ts);
+        seconds = static_cast<long>(ts.tv_sec);
+        nanoseconds = static_cast<int>(ts.tv_nsec);
+#endif
+    }
+
+    /**
+     * Reads monotonic clock of the system in nanoseconds.
+     */
+    static inline int64_t monotonic_now()
+    {
+#if defined(_WIN32)
+        static LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+
+        if (!frequency.QuadPart)
+        {
+            ::QueryPerformanceFrequency(&frequency);
+        }
+        ::QueryPerformanceCounter(&counter);
+
+        return static_cast<int64_t>(counter.QuadPart / frequency.QuadPart)
+            * 1000000000
+            + static_cast<int64_t>(counter.QuadPart % frequency.QuadPart)
+            * 1000000000 / frequency.QuadPart;
+#else
+        struct timespec ts;
+
+        ::clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+    }
+}
+
+#endif /* !PEELO_CHRONO_CLOCK_HPP_GUARD */
@@ -28,12 +28,26 @@
 #if defined(_WIN32)
 # define WIN32_LEAN_AND_MEAN
 # include <windows.h>
-#else
-# include <ctime>
 #endif
+#include <ctime>
+#include "civil.hpp"
 
 namespace peelo
 {
+    /**
+     * Constructs date from number of days since 1970-01-01.
+     */
+    static date date_from_days(long days)
+    {
+        long year;
+        int month;
+        int day;
+
+        civil_from_days(days, year, month, day);
+
+        return date(static_cast<int>(year), peelo::month(month), day);
+    }
+
     date::date(int year, const class month& month, int day)
         : m_year(year)
         , m_month(month)
@@ -67,19 +81,26 @@ namespace peelo
         m_month = peelo::month(st.wMonth);
         m_day = st.wDay;
 #else
-        std::time_t ts = static_cast<std::time_t>(timestamp);
-        std::tm* tm = std::localtime(&ts);
-
-        if (!tm)
-        {
-            throw std::runtime_error("localtime() failed");
-        }
-        m_year = tm->tm_year + 1900;
-        m_month = peelo::month(tm->tm_mon + 1);
-        m_day = tm->tm_mday;
+        assign(date(timestamp, time_zone::local()));
 #endif
     }
 
+    date::date(long timestamp, const time_zone& zone)
+        : m_year(0)
+        , m_month(month::jan)
+        , m_day(1)
+    {
+        long days;
+        long seconds;
+        long year;
+        int month;
+
+        split_timestamp(zone.to_local(timestamp), days, seconds);
+        civil_from_days(days, year, month, m_day);
+        m_year = static_cast<int>(year);
+        m_month = peelo::month(month);
+    }
+
     date date::today()
     {
 #if defined(_WIN32)
@@ -93,110 +114,33 @@ namespace peelo
                 local_time.wDay
         );
 #else
-        std::time_t ts = std::time(0);
-        std::tm* tm = std::localtime(&ts);
-
-        if (!tm)
-        {
-            throw std::runtime_error("localtime() failed");
-        }
-
-        return date(
-                tm->tm_year + 1900,
-                peelo::month(tm->tm_mon + 1),
-                tm->tm_mday
-        );
+        return today(time_zone::local());
 #endif
     }
 
-    date date::yesterday()
+    date date::today(const time_zone& zone)
     {
-#if defined(_WIN32)
-        SYSTEMTIME local_time;
-
-        ::GetLocalTime(&local_time);
-        if (lt.wDay > 1)
-        {
-            return date(
-                    local_time.wYear,
-                    peelo::month(local_time.wMonth),
-                    local_time.wDay - 1
-            );
-        }
-        else if (lt.wMonth == 1)
-        {
-            return date(lt.wYear - 1, month::dec, 31);
-        } else {
-            class month month(lt.wMonth - 1);
-
-            return date(
-                    lt.wYear,
-                    month,
-                    month.length(is_leap_year(lt.wYear))
-            );
-        }
-#else
-        std::time_t ts = std::time(0);
-        std::tm* tm = std::localtime(&ts);
+        return date(static_cast<long>(std::time(0)), zone);
+    }
 
-        if (!tm)
-        {
-            throw std::runtime_error("localtime() failed");
-        }
-        --tm->tm_mday;
-        if ((ts = std::mktime(tm)) == -1)
-        {
-            throw std::runtime_error("mktime() failed");
-        }
+    date date::yesterday()
+    {
+        const date today = date::today();
 
-        return date(
-                tm->tm_year + 1900,
-                peelo::month(tm->tm_mon + 1),
-                tm->tm_mday
+        return date_from_days(
+                days_from_civil(today.m_year, today.m_month.index(), today.m_day)
+                - 1
         );
-#endif
     }
 
     date date::tomorrow()
     {
-#if defined(_WIN32)
-        SYSTEMTIME local_time;
-
-        ::GetLocalTime(&local_time);
-        if (lt.wDay == peelo::days_in_month(
-                    month(lt.wMonth),
-                    is_leap_year(lt.wYear)
-        ))
-        {
-            if (lt.wMonth == month_dec)
-            {
-                return date(lt.wYear + 1, month_jan, 1);
-            } else {
-                return date(lt.wYear, peelo::month(lt.wMonth + 1), 1);
-            }
-        } else {
-            return date(lt.wYear, peelo::month(lt.wMonth), lt.wDay + 1);
-        }
-#else
-        std::time_t ts = std::time(0);
-        std::tm* tm = std::localtime(&ts);
-
-        if (!tm)
-        {
-            throw std::runtime_error("localtime() failed");
-        }
-        ++tm->tm_mday;
-        if ((ts = std::mktime(tm)) == -1)
-        {
-            throw std::runtime_error("mktime() failed");
-        }
+        const date today = date::today();
 
-        return date(
-                tm->tm_year + 1900,
-                peelo::month(tm->tm_mon + 1),
-                tm->tm_mday
+        return date_from_days(
+                days_from_civil(today.m_year, today.m_month.index(), today.m_day)
+                + 1
         );
-#endif
     }
 
     bool date::is_valid(int year, const class month& month, int day)
@@ -206,65 +150,79 @@ namespace peelo
 
     const weekday& date::day_of_week() const
     {
-#if defined(_WIN32)
-        SYSTEMTIME st;
-        FILETIME ft;
+        static const weekday* const weekdays[7] =
+        {
+            &weekday::mon,
+            &weekday::tue,
+            &weekday::wed,
+            &weekday::thu,
+            &weekday::fri,
+            &weekday::sat,
+            &weekday::sun
+        };
 
-        st.wYear = m_year;
-        st.wMonth = m_month.index();
-        st.wDay = m_day;
-        ::SystemTimeToFileTime(&st, &ft);
-        ::FileTimeToSystemTime(&ft, &st);
-        switch (st.wDayOfWeek)
+        return *weekdays[
+            weekday_from_days(days_from_civil(m_year, m_month.index(), m_day))
+            - 1
+        ];
+    }
+
+    date date::next(const weekday& wd) const
+    {
+        const long days = days_from_civil(m_year, m_month.index(), m_day);
+        const int delta = day_of_week().days_until(wd);
+
+        return date_from_days(days + (delta ? delta : 7));
+    }
+
+    date date::previous(const weekday& wd) const
+    {
+        const long days = days_from_civil(m_year, m_month.index(), m_day);
+        const int delta = wd.days_until(day_of_week());
+
+        return date_from_days(days - (delta ? delta : 7));
+    }
+
+    date date::nth_weekday(int year,
+                           const class month& month,
+                           const weekday& wd,
+                           int n)
+    {
+        const int length = month.length(is_leap_year(year));
+        int day;
+
+        if (n > 0)
         {
-            case 0: return weekday::sun;
-            case 1: return weekday::mon;
-            case 2: return weekday::tue;
-            case 3: return weekday::wed;
-            case 4: return weekday::thu;
-            case 5: return weekday::fri;
-            case 6: return weekday::sat;
+            const long first = days_from_civil(year, month.index(), 1);
+
+            day = 1
+                + weekday(weekday_from_days(first)).days_until(wd)
+                + (n - 1) * 7;
         }
-#else
-        std::tm tm;
-
-        tm.tm_sec = 0;
-        tm.tm_min = 0;
-        tm.tm_hour = 0;
-        tm.tm_mday = m_day;
-        tm.tm_mon = m_month.index() - 1;
-        tm.tm_year = m_year - 1900;
-        tm.tm_isdst = -1;
-        if (std::mktime(&tm) == -1)
+        else if (n < 0)
         {
-            throw std::runtime_error("mktime() failed");
+            const long last = days_from_civil(year, month.index(), length);
+
+            day = length
+                - wd.days_until(weekday(weekday_from_days(last)))
+                + (n + 1) * 7;
+        } else {
+            throw std::out_of_range("weekday ordinal cannot be zero");
         }
-        switch (tm.tm_wday)
+        if (day < 1 || day > length)
         {
-            case 0: return weekday::sun;
-            case 1: return weekday::mon;
-            case 2: return weekday::tue;
-            case 3: return weekday::wed;
-            case 4: return weekday::thu;
-            case 5: return weekday::fri;
-            case 6: return weekday::sat;
+            throw std::out_of_range("no such weekday in the month");
         }
-#endif
 
-        throw std::runtime_error("unable to determine day of week");
+        return date(year, month, day);
     }
 
     int date::day_of_year() const
     {
-        const bool leap_year = is_leap_year(m_year);
-        int result = 0;
-
-        for (int i = 1; i < m_month.index(); ++i)
-        {
-            result += peelo::month(i).length(leap_year);
-        }
-
-        return result + m_day;
+        return static_cast<int>(
+                days_from_civil(m_year, m_month.index(), m_day)
+                - days_from_civil(m_year, 1, 1)
+        ) + 1;
     }
 
     int date::days_in_year() const
@@ -289,37 +247,8 @@ namespace peelo
 
     long date::timestamp() const
     {
-        static const int days_before_month[12] =
-        {
-            0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
-        };
-
-        // Compute days in a year
-        long days = (m_day - 1) + (days_before_month[m_month.index() - 1]);
-
-        // Leap year adjustment
-        if (m_month > month::jan && days_in_year() == 366)
-        {
-            ++days;
-        }
-
-        // Compute days in other years
-        if (m_year > 1970)
-        {
-            for (int y = 1970; y < m_year; ++y)
-            {
-                days += days_in_year(y);
-            }
-        }
-        else if (m_year < 1970)
-        {
-            for (int y = 1969; y >= m_year; --y)
-            {
-                days -= days_in_year(y);
-            }
-        }
-
-        return days * 86400;
+        return days_from_civil(m_year, m_month.index(), m_day)
+            * seconds_per_civil_day;
     }
 
     date& date::assign(const date& that)
@@ -457,7 +386,10 @@ namespace peelo
 
     duration date::operator-(const date& that) const
     {
-        return duration(0, 0, 0, static_cast<int>(timestamp() - that.timestamp()));
+        return duration(static_cast<int>(
+                days_from_civil(m_year, m_month.index(), m_day)
+                - days_from_civil(that.m_year, that.m_month.index(), that.m_day)
+        ));
     }
 
     std::ostream& operator<<(std::ostream& os, const date& d)
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/date32.hpp>
+#include <limits>
+#include <stdexcept>
+#include "civil.hpp"
+
+namespace peelo
+{
+    date32::date32(const date& d)
+    {
+        const long days = days_from_civil(d.year(), d.month().index(), d.day());
+
+        if (days < std::numeric_limits<value_type>::min()
+            || days > std::numeric_limits<value_type>::max())
+        {
+            throw std::out_of_range("date cannot be represented as date32");
+        }
+        m_days = static_cast<value_type>(days);
+    }
+
+    date date32::to_date() const
+    {
+        long year;
+        int month;
+        int day;
+
+        civil_from_days(m_days, year, month, day);
+
+        return date(static_cast<int>(year), peelo::month(month), day);
+    }
+
+    std::ostream& operator<<(std::ostream& os, const date32& d)
+    {
+        return os << d.to_date();
+    }
+
+    std::wostream& operator<<(std::wostream& os, const date32& d)
+    {
+        return os << d.to_date();
+    }
+}
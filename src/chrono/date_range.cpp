@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/date_range.hpp>
+#include <stdexcept>
+#include "civil.hpp"
+
+namespace peelo
+{
+    static long to_days(const date& d)
+    {
+        return days_from_civil(d.year(), d.month().index(), d.day());
+    }
+
+    static date from_days(long days)
+    {
+        long year;
+        int month;
+        int day;
+
+        civil_from_days(days, year, month, day);
+
+        return date(static_cast<int>(year), peelo::month(month), day);
+    }
+
+    /**
+     * Division which rounds towards negative infinity.
+     */
+    static inline long floor_div(long a, long b)
+    {
+        return a / b - (a % b < 0);
+    }
+
+    /**
+     * Returns number of business days between 1970-01-05 (a Monday) and
+     * given day, which may also be negative.
+     */
+    static inline long business_days_before(long days)
+    {
+        const long offset = days - 4;
+        const long weeks = floor_div(offset, 7);
+        const long rest = offset - weeks * 7;
+
+        return weeks * 5 + (rest < 5 ? rest : 5);
+    }
+
+    /**
+     * Adds given number of business days into a day which is known to fall
+     * between Monday and Friday.
+     */
+    static inline long add_business_days(long days, long count)
+    {
+        const long rest = count % 5;
+
+        return days
+            + count / 5 * 7
+            + rest
+            + 2 * (weekday_from_days(days) + rest > 5);
+    }
+
+    /**
+     * Adds given number of months into a day, clamping the day of the month
+     * into the length of the resulting month.
+     */
+    static inline long add_months(long days, long count)
+    {
+        long year;
+        int month;
+        int day;
+        long index;
+        int length;
+
+        civil_from_days(days, year, month, day);
+        index = year * 12 + month - 1 + count;
+        year = floor_div(index, 12);
+        month = static_cast<int>(index - year * 12) + 1;
+        length = days_in_civil_month(year, month);
+
+        return days_from_civil(year, month, day < length ? day : length);
+    }
+
+    date_range::date_range(const date& front,
+                           const date& back,
+                           enum unit u,
+                           int step)
+        : m_front(to_days(front))
+        , m_back(to_days(back))
+        , m_unit(u)
+        , m_step(step)
+        , m_first(m_front)
+        , m_size(0)
+    {
+        initialize();
+    }
+
+    date_range::date_range(const range<date>& r, enum unit u, int step)
+        : m_front(to_days(r.front()))
+        , m_back(to_days(r.back()))
+        , m_unit(u)
+        , m_step(step)
+        , m_first(m_front)
+        , m_size(0)
+    {
+        initialize();
+    }
+
+    date_range::date_range(const date_range& that)
+        : m_front(that.m_front)
+        , m_back(that.m_back)
+        , m_unit(that.m_unit)
+        , m_step(that.m_step)
+        , m_first(that.m_first)
+        , m_size(that.m_size) {}
+
+    void date_range::initialize()
+    {
+        long count = 0;
+
+        if (m_step < 1)
+        {
+            throw std::invalid_argument("date range step must be positive");
+        }
+        switch (m_unit)
+        {
+            case days:
+            case weeks:
+                if (m_back > m_front)
+                {
+                    const long length = m_unit == weeks ? 7L * m_step : m_step;
+
+                    count = (m_back - m_front + length - 1) / length;
+                }
+                break;
+
+            case months:
+                if (m_back > m_front)
+                {
+                    long front_year;
+                    long back_year;
+                    int front_month;
+                    int back_month;
+                    int day;
+
+                    civil_from_days(m_front, front_year, front_month, day);
+                    civil_from_days(m_back, back_year, back_month, day);
+                    count = ((back_year - front_year) * 12
+                            + back_month - front_month) / m_step;
+                    // The last candidate may fall into the same month as the
+                    // end of the range, but after it.
+                    if (add_months(m_front, count * m_step) < m_back)
+                    {
+                        ++count;
+                    }
+                }
+                break;
+
+            case business_days:
+            {
+                const int wd = weekday_from_days(m_front);
+
+                m_first = m_front + (wd > 5 ? 8 - wd : 0);
+                if (m_back > m_first)
+                {
+                    count = (business_days_before(m_back)
+                            - business_days_before(m_first)
+                            + m_step - 1) / m_step;
+                }
+                break;
+            }
+        }
+        m_size = static_cast<size_type>(count);
+    }
+
+    date date_range::front() const
+    {
+        return from_days(m_front);
+    }
+
+    date date_range::back() const
+    {
+        return from_days(m_back);
+    }
+
+    date date_range::at(size_type index) const
+    {
+        const long n = static_cast<long>(index) * m_step;
+
+        if (index >= m_size)
+        {
+            throw std::out_of_range("date range index out of bounds");
+        }
+        switch (m_unit)
+        {
+            case weeks:
+                return from_days(m_first + n * 7);
+
+            case months:
+                return from_days(add_months(m_first, n));
+
+            case business_days:
+                return from_days(add_business_days(m_first, n));
+
+            default:
+                return from_days(m_first + n);
+        }
+    }
+
+    date_range& date_range::assign(const date_range& that)
+    {
+        m_front = that.m_front;
+        m_back = that.m_back;
+        m_unit = that.m_unit;
+        m_step = that.m_step;
+        m_first = that.m_first;
+        m_size = that.m_size;
+
+        return *this;
+    }
+
+    bool date_range::equals(const date_range& that) const
+    {
+        return m_front == that.m_front
+            && m_back == that.m_back
+            && m_unit == that.m_unit
+            && m_step == that.m_step;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const date_range& r)
+    {
+        os << r.front() << "..." << r.back();
+
+        return os;
+    }
+
+    std::wostream& operator<<(std::wostream& os, const date_range& r)
+    {
+        os << r.front() << L"..." << r.back();
+
+        return os;
+    }
+}
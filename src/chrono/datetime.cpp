@@ -24,24 +24,32 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <peelo/chrono/datetime.hpp>
+#include <climits>
+#include <cstring>
 #include <stdexcept>
 #if defined(_WIN32)
 # define WIN32_LEAN_AND_MEAN
 # include <windows.h>
-#else
-# include <ctime>
 #endif
+#include <ctime>
+#include "civil.hpp"
+#include "clock.hpp"
 
 namespace peelo
 {
+    static const int64_t nanoseconds_per_second = 1000000000;
+
+    const std::size_t datetime::iso8601_buffer_size;
+
     datetime::datetime(int year,
                        const class month& month,
                        int day,
                        int hour,
                        int minute,
-                       int second)
+                       int second,
+                       int nanosecond)
         : m_date(year, month, day)
-        , m_time(hour, minute, second) {}
+        , m_time(hour, minute, second, nanosecond) {}
 
     datetime::datetime(const datetime& that)
         : m_date(that.m_date)
@@ -70,18 +78,28 @@ namespace peelo
         m_date.assign(st.wYear, peelo::month(st.wMonth), st.wDay);
         m_time.assign(st.wHour, st.wMinute, st.wSecond);
 #else
-        std::time_t ts = static_cast<std::time_t>(timestamp);
-        std::tm* tm = std::localtime(&ts);
-
-        if (!tm)
-        {
-            throw std::runtime_error("localtime() failed");
-        }
-        m_date.assign(tm->tm_year + 1900, peelo::month(tm->tm_mon + 1), tm->tm_mday);
-        m_time.assign(tm->tm_hour, tm->tm_min, tm->tm_sec);
+        assign(datetime(timestamp, time_zone::local()));
 #endif
     }
 
+    datetime::datetime(long timestamp, const time_zone& zone)
+    {
+        long days;
+        long seconds;
+        long year;
+        int month;
+        int day;
+
+        split_timestamp(zone.to_local(timestamp), days, seconds);
+        civil_from_days(days, year, month, day);
+        m_date.assign(static_cast<int>(year), peelo::month(month), day);
+        m_time.assign(
+                static_cast<int>(seconds / 3600),
+                static_cast<int>(seconds / 60 % 60),
+                static_cast<int>(seconds % 60)
+        );
+    }
+
     datetime datetime::now()
     {
 #if defined(_WIN32)
@@ -95,26 +113,32 @@ namespace peelo
                 local_time.wDay,
                 local_time.wHour,
                 local_time.wMinute,
-                local_time.wSecond
+                local_time.wSecond,
+                local_time.wMilliseconds * 1000000
         );
 #else
-        std::time_t ts = std::time(0);
-        std::tm* tm = std::localtime(&ts);
+        return now(time_zone::local());
+#endif
+    }
 
-        if (!tm)
-        {
-            throw std::runtime_error("localtime() failed");
-        }
+    datetime datetime::now(const time_zone& zone)
+    {
+        long timestamp;
+        int nanosecond;
+
+        realtime_now(timestamp, nanosecond);
+
+        const datetime result(timestamp, zone);
 
         return datetime(
-                tm->tm_year + 1900,
-                peelo::month(tm->tm_mon + 1),
-                tm->tm_mday,
-                tm->tm_hour,
-                tm->tm_min,
-                tm->tm_sec
+                result.m_date,
+                peelo::time(
+                    result.hour(),
+                    result.minute(),
+                    result.second(),
+                    nanosecond
+                )
         );
-#endif
     }
 
     bool datetime::is_valid(int year,
@@ -122,51 +146,340 @@ namespace peelo
                             int day,
                             int hour,
                             int minute,
-                            int second)
+                            int second,
+                            int nanosecond)
     {
         return date::is_valid(year, month, day)
-            && time::is_valid(hour, minute, second);
+            && time::is_valid(hour, minute, second, nanosecond);
     }
 
     long datetime::timestamp() const
     {
-        static const int days_before_month[12] =
+        return days_from_civil(
+                m_date.year(),
+                m_date.month().index(),
+                m_date.day()
+        ) * seconds_per_civil_day
+            + m_time.hour() * 3600
+            + m_time.minute() * 60
+            + m_time.second();
+    }
+
+    long datetime::timestamp(const time_zone& zone) const
+    {
+        return zone.to_utc(timestamp());
+    }
+
+    /**
+     * Returns value of decimal digit, or value greater than 9 if the
+     * character is not a digit.
+     */
+    static inline unsigned digit(char c)
+    {
+        return static_cast<unsigned>(static_cast<unsigned char>(c) - '0');
+    }
+
+    /**
+     * Parses fixed width decimal number. Returns <code>false</code> if any of
+     * the characters is not a digit.
+     */
+    template< std::size_t N >
+    static inline bool parse_digits(const char* input, int& result)
+    {
+        unsigned value = 0;
+        unsigned invalid = 0;
+
+        for (std::size_t i = 0; i < N; ++i)
         {
-            0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
-        };
+            const unsigned d = digit(input[i]);
 
-        // Compute hours, minutes and seconds
-        long time = m_time.second()
-                    + (m_time.minute() * 60)
-                    + (m_time.hour() * 3600);
+            invalid |= d > 9;
+            value = value * 10 + d;
+        }
+        result = static_cast<int>(value);
 
-        // Compute days in a year
-        long days = (m_date.day() - 1)
-                    + (days_before_month[m_date.month().index() - 1]);
+        return !invalid;
+    }
 
-        // Leap year adjustment
-        if (m_date.month() > month::jan && m_date.days_in_year() == 366)
+    static void invalid_iso8601()
+    {
+        throw std::invalid_argument("invalid ISO 8601 date and time");
+    }
+
+    datetime datetime::parse_iso8601(const char* input, std::size_t length)
+    {
+        const char* p = input;
+        const char* end = input + length;
+        int year;
+        int month;
+        int day;
+        int hour = 0;
+        int minute = 0;
+        int second = 0;
+        int nanosecond = 0;
+        long offset = 0;
+
+        // Date part is "YYYY-MM-DD", or "+YYYYY-MM-DD" with expanded year
+        // of at least four digits and explicit sign, as written by
+        // format_iso8601() for years outside 0 to 9999.
+        if (p < end && (*p == '+' || *p == '-'))
+        {
+            const bool negative = *p++ == '-';
+            const char* begin = p;
+            int magnitude = 0;
+
+            while (p < end && digit(*p) <= 9)
+            {
+                const int d = static_cast<int>(digit(*p++));
+
+                if (magnitude > (INT_MAX - d) / 10)
+                {
+                    invalid_iso8601();
+                }
+                magnitude = magnitude * 10 + d;
+            }
+            if (p - begin < 4)
+            {
+                invalid_iso8601();
+            }
+            year = negative ? -magnitude : magnitude;
+        }
+        else if (end - p < 4 || !parse_digits<4>(p, year))
         {
-            ++days;
+            invalid_iso8601();
+        } else {
+            p += 4;
         }
+        if (end - p < 6
+            || p[0] != '-'
+            || !parse_digits<2>(p + 1, month)
+            || p[3] != '-'
+            || !parse_digits<2>(p + 4, day))
+        {
+            invalid_iso8601();
+        }
+        p += 6;
 
-        // Compute days in other years
-        if (m_date.year() > 1970)
+        if (p < end)
         {
-            for (int y = 1970; y < m_date.year(); ++y)
+            // Time part is "THH:MM:SS", where RFC 3339 also allows lower case
+            // "t" or space as the separator.
+            if (end - p < 9
+                || (*p != 'T' && *p != 't' && *p != ' ')
+                || !parse_digits<2>(p + 1, hour)
+                || p[3] != ':'
+                || !parse_digits<2>(p + 4, minute)
+                || p[6] != ':'
+                || !parse_digits<2>(p + 7, second))
             {
-                days += date::days_in_year(y);
+                invalid_iso8601();
             }
+            p += 9;
+
+            if (p < end && (*p == '.' || *p == ','))
+            {
+                static const int scale[10] =
+                {
+                    1000000000, 100000000, 10000000, 1000000, 100000, 10000,
+                    1000, 100, 10, 1
+                };
+                const char* begin = ++p;
+
+                while (p < end && digit(*p) <= 9)
+                {
+                    // Digits beyond nanosecond precision are truncated.
+                    if (p - begin < 9)
+                    {
+                        nanosecond = nanosecond * 10 + static_cast<int>(digit(*p));
+                    }
+                    ++p;
+                }
+                if (p == begin)
+                {
+                    invalid_iso8601();
+                }
+                nanosecond *= scale[p - begin < 9 ? p - begin : 9];
+            }
+
+            if (p < end)
+            {
+                if (*p == 'Z' || *p == 'z')
+                {
+                    ++p;
+                }
+                else if (*p == '+' || *p == '-')
+                {
+                    const long sign = *p == '-' ? -1 : 1;
+                    int offset_hour;
+                    int offset_minute = 0;
+
+                    if (end - p < 3 || !parse_digits<2>(p + 1, offset_hour))
+                    {
+                        invalid_iso8601();
+                    }
+                    p += 3;
+                    if (p < end)
+                    {
+                        if (*p == ':')
+                        {
+                            ++p;
+                        }
+                        if (end - p < 2 || !parse_digits<2>(p, offset_minute))
+                        {
+                            invalid_iso8601();
+                        }
+                        p += 2;
+                    }
+                    if (offset_hour > 23 || offset_minute > 59)
+                    {
+                        invalid_iso8601();
+                    }
+                    offset = sign * (offset_hour * 3600 + offset_minute * 60);
+                } else {
+                    invalid_iso8601();
+                }
+            }
+        }
+        if (p != end)
+        {
+            invalid_iso8601();
         }
-        else if (m_date.year() < 1970)
+        if (offset)
         {
-            for (int y = 1969; y >= m_date.year(); ++y)
+            long days;
+            long seconds;
+            long utc_year;
+
+            // Validate the local value before normalizing it to UTC, so that
+            // out of range fields are not silently carried over.
+            if (!peelo::month::is_valid(month)
+                || !is_valid(year, peelo::month(month), day, hour, minute, second))
             {
-                days -= date::days_in_year(y);
+                invalid_iso8601();
             }
+            split_timestamp(
+                    days_from_civil(year, month, day) * seconds_per_civil_day
+                    + hour * 3600
+                    + minute * 60
+                    + second
+                    - offset,
+                    days,
+                    seconds
+            );
+            civil_from_days(days, utc_year, month, day);
+            year = static_cast<int>(utc_year);
+            hour = static_cast<int>(seconds / 3600);
+            minute = static_cast<int>(seconds / 60 % 60);
+            second = static_cast<int>(seconds % 60);
         }
-    
-        return time + (days * 86400);
+
+        // Constructors of date and time validate the remaining fields.
+        return datetime(
+                year,
+                peelo::month(month),
+                day,
+                hour,
+                minute,
+                second,
+                nanosecond
+        );
+    }
+
+    datetime datetime::parse_iso8601(const string& input)
+    {
+        const vector<char> encoded = input.utf8();
+
+        return parse_iso8601(encoded.data(), encoded.size() - 1);
+    }
+
+    /**
+     * Writes fixed width decimal number.
+     */
+    template< std::size_t N >
+    static inline void format_digits(char* output, unsigned value)
+    {
+        for (std::size_t i = N; i > 0; --i)
+        {
+            output[i - 1] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+
+    std::size_t datetime::format_iso8601(char* output) const
+    {
+        const int year = m_date.year();
+        const int nanosecond = m_time.nanosecond();
+        char* p = output;
+
+        if (year >= 0 && year <= 9999)
+        {
+            format_digits<4>(p, static_cast<unsigned>(year));
+            p += 4;
+        } else {
+            // Expanded representation with explicit sign.
+            unsigned long magnitude = year < 0
+                ? 0UL - static_cast<unsigned long>(year)
+                : static_cast<unsigned long>(year);
+            char digits[10];
+            std::size_t count = 0;
+
+            *p++ = year < 0 ? '-' : '+';
+            do
+            {
+                digits[count++] = static_cast<char>('0' + magnitude % 10);
+                magnitude /= 10;
+            }
+            while (magnitude);
+            while (count < 4)
+            {
+                digits[count++] = '0';
+            }
+            while (count > 0)
+            {
+                *p++ = digits[--count];
+            }
+        }
+        p[0] = '-';
+        format_digits<2>(p + 1, static_cast<unsigned>(m_date.month().index()));
+        p[3] = '-';
+        format_digits<2>(p + 4, static_cast<unsigned>(m_date.day()));
+        p[6] = 'T';
+        format_digits<2>(p + 7, static_cast<unsigned>(m_time.hour()));
+        p[9] = ':';
+        format_digits<2>(p + 10, static_cast<unsigned>(m_time.minute()));
+        p[12] = ':';
+        format_digits<2>(p + 13, static_cast<unsigned>(m_time.second()));
+        p += 15;
+        if (nanosecond)
+        {
+            *p++ = '.';
+            if (nanosecond % 1000000 == 0)
+            {
+                format_digits<3>(p, static_cast<unsigned>(nanosecond / 1000000));
+                p += 3;
+            }
+            else if (nanosecond % 1000 == 0)
+            {
+                format_digits<6>(p, static_cast<unsigned>(nanosecond / 1000));
+                p += 6;
+            } else {
+                format_digits<9>(p, static_cast<unsigned>(nanosecond));
+                p += 9;
+            }
+        }
+        *p++ = 'Z';
+        *p = 0;
+
+        return static_cast<std::size_t>(p - output);
+    }
+
+    string datetime::format_iso8601() const
+    {
+        char buffer[iso8601_buffer_size];
+
+        format_iso8601(buffer);
+
+        return string(buffer);
     }
 
     datetime& datetime::assign(const datetime& that)
@@ -231,22 +544,65 @@ namespace peelo
 
         --m_date;
 
-        return *this;
+        return clone;
+    }
+
+    /**
+     * Shifts date and time by given number of nanoseconds.
+     */
+    static datetime add_nanoseconds(const datetime& dt, int64_t nanoseconds)
+    {
+        long seconds = dt.timestamp()
+            + static_cast<long>(nanoseconds / nanoseconds_per_second);
+        int64_t nanosecond = dt.time().nanosecond()
+            + nanoseconds % nanoseconds_per_second;
+
+        if (nanosecond < 0)
+        {
+            nanosecond += nanoseconds_per_second;
+            --seconds;
+        }
+        else if (nanosecond >= nanoseconds_per_second)
+        {
+            nanosecond -= nanoseconds_per_second;
+            ++seconds;
+        }
+
+        const datetime result(seconds, time_zone::utc());
+
+        return datetime(
+                result.date(),
+                peelo::time(
+                    result.hour(),
+                    result.minute(),
+                    result.second(),
+                    static_cast<int>(nanosecond)
+                )
+        );
     }
 
     datetime datetime::operator+(const class duration& duration) const
     {
-        return datetime(timestamp() + duration.seconds());
+        return add_nanoseconds(*this, duration.nanoseconds());
     }
 
     datetime datetime::operator-(const class duration& duration) const
     {
-        return datetime(timestamp() - duration.seconds());
+        return add_nanoseconds(*this, -duration.nanoseconds());
     }
 
     duration datetime::operator-(const datetime& that) const
     {
-        return duration(0, 0, 0, static_cast<int>(timestamp() - that.timestamp()));
+        return duration(
+                0,
+                0,
+                0,
+                0,
+                static_cast<int64_t>(timestamp() - that.timestamp())
+                    * nanoseconds_per_second
+                    + m_time.nanosecond()
+                    - that.m_time.nanosecond()
+        );
     }
 
     std::ostream& operator<<(std::ostream& os, const datetime& dt)
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/datetime64.hpp>
+#include <limits>
+#include <stdexcept>
+#include "civil.hpp"
+
+namespace peelo
+{
+    static const int64_t nanoseconds_per_second = 1000000000;
+    static const int64_t nanoseconds_per_day = 86400 * nanoseconds_per_second;
+    static const int64_t min_value = std::numeric_limits<int64_t>::min();
+    static const int64_t max_value = std::numeric_limits<int64_t>::max();
+
+    datetime64::datetime64(const datetime& dt)
+    {
+        const int64_t seconds = dt.timestamp();
+
+        // The nanosecond part is always non-negative, so the lower bound
+        // can go one second further than the upper bound.
+        if (seconds > max_value / nanoseconds_per_second - 1
+            || seconds < min_value / nanoseconds_per_second)
+        {
+            throw std::out_of_range(
+                    "datetime cannot be represented as datetime64"
+            );
+        }
+        m_nanoseconds = seconds * nanoseconds_per_second + dt.nanosecond();
+    }
+
+    datetime64::datetime64(const date32& d)
+    {
+        if (d.days() > max_value / nanoseconds_per_day
+            || d.days() < min_value / nanoseconds_per_day)
+        {
+            throw std::out_of_range(
+                    "date cannot be represented as datetime64"
+            );
+        }
+        m_nanoseconds = d.days() * nanoseconds_per_day;
+    }
+
+    long datetime64::timestamp() const
+    {
+        int64_t seconds = m_nanoseconds / nanoseconds_per_second;
+
+        if (m_nanoseconds % nanoseconds_per_second < 0)
+        {
+            --seconds;
+        }
+
+        return static_cast<long>(seconds);
+    }
+
+    date32 datetime64::to_date32() const
+    {
+        int64_t days = m_nanoseconds / nanoseconds_per_day;
+
+        if (m_nanoseconds % nanoseconds_per_day < 0)
+        {
+            --days;
+        }
+
+        return date32(static_cast<date32::value_type>(days));
+    }
+
+    datetime datetime64::to_datetime() const
+    {
+        const long seconds = timestamp();
+        const int64_t nanosecond = m_nanoseconds
+            - static_cast<int64_t>(seconds) * nanoseconds_per_second;
+        long days;
+        long second_of_day;
+        long year;
+        int month;
+        int day;
+
+        split_timestamp(seconds, days, second_of_day);
+        civil_from_days(days, year, month, day);
+
+        return datetime(
+                static_cast<int>(year),
+                peelo::month(month),
+                day,
+                static_cast<int>(second_of_day / 3600),
+                static_cast<int>(second_of_day / 60 % 60),
+                static_cast<int>(second_of_day % 60),
+                static_cast<int>(nanosecond)
+        );
+    }
+
+    std::ostream& operator<<(std::ostream& os, const datetime64& dt)
+    {
+        return os << dt.to_datetime();
+    }
+
+    std::wostream& operator<<(std::wostream& os, const datetime64& dt)
+    {
+        return os << dt.to_datetime();
+    }
+}
@@ -27,73 +27,110 @@
 
 namespace peelo
 {
-    static const int hours_per_day = 24;
-    static const int minutes_per_day = 1440;
-    static const int minutes_per_hour = 60;
-    static const int seconds_per_day = 86400;
-    static const int seconds_per_hour = 3600;
-    static const int seconds_per_minute = 60;
-
-    duration::duration(int days, int hours, int minutes, int seconds)
-        : m_seconds(
-                days * seconds_per_day
-                + hours * seconds_per_hour
-                + minutes * seconds_per_minute
-                + seconds
+    static const int64_t nanoseconds_per_microsecond = 1000;
+    static const int64_t nanoseconds_per_millisecond = 1000000;
+    static const int64_t nanoseconds_per_second = 1000000000;
+    static const int64_t nanoseconds_per_minute = 60 * nanoseconds_per_second;
+    static const int64_t nanoseconds_per_hour = 60 * nanoseconds_per_minute;
+    static const int64_t nanoseconds_per_day = 24 * nanoseconds_per_hour;
+
+    duration::duration(int days,
+                       int hours,
+                       int minutes,
+                       int seconds,
+                       int64_t nanoseconds)
+        : m_nanoseconds(
+                days * nanoseconds_per_day
+                + hours * nanoseconds_per_hour
+                + minutes * nanoseconds_per_minute
+                + seconds * nanoseconds_per_second
+                + nanoseconds
         ) {}
-    
+
     duration::duration(const duration& that)
-        : m_seconds(that.m_seconds) {}
+        : m_nanoseconds(that.m_nanoseconds) {}
+
+    duration duration::from_milliseconds(int64_t milliseconds)
+    {
+        return duration(0, 0, 0, 0, milliseconds * nanoseconds_per_millisecond);
+    }
+
+    duration duration::from_microseconds(int64_t microseconds)
+    {
+        return duration(0, 0, 0, 0, microseconds * nanoseconds_per_microsecond);
+    }
+
+    duration duration::from_nanoseconds(int64_t nanoseconds)
+    {
+        return duration(0, 0, 0, 0, nanoseconds);
+    }
+
+    int64_t duration::days() const
+    {
+        return m_nanoseconds / nanoseconds_per_day;
+    }
+
+    int64_t duration::hours() const
+    {
+        return m_nanoseconds / nanoseconds_per_hour;
+    }
+
+    int64_t duration::minutes() const
+    {
+        return m_nanoseconds / nanoseconds_per_minute;
+    }
 
-    int duration::days() const
+    int64_t duration::seconds() const
     {
-        return m_seconds / seconds_per_day;
+        return m_nanoseconds / nanoseconds_per_second;
     }
 
-    int duration::hours() const
+    int64_t duration::milliseconds() const
     {
-        return m_seconds / seconds_per_hour;
+        return m_nanoseconds / nanoseconds_per_millisecond;
     }
 
-    int duration::minutes() const
+    int64_t duration::microseconds() const
     {
-        return m_seconds / seconds_per_minute;
+        return m_nanoseconds / nanoseconds_per_microsecond;
     }
 
     duration& duration::assign(const duration& that)
     {
-        m_seconds = that.m_seconds;
+        m_nanoseconds = that.m_nanoseconds;
 
         return *this;
     }
 
     bool duration::equals(const duration& that) const
     {
-        return m_seconds == that.m_seconds;
+        return m_nanoseconds == that.m_nanoseconds;
     }
 
     int duration::compare(const duration& that) const
     {
-        return m_seconds > that.m_seconds ? 1 : m_seconds < that.m_seconds ? -1 : 0;
+        return m_nanoseconds > that.m_nanoseconds
+            ? 1
+            : m_nanoseconds < that.m_nanoseconds ? -1 : 0;
     }
 
     duration duration::operator+(const duration& that) const
     {
-        return duration(0, 0, 0, m_seconds + that.m_seconds);
+        return from_nanoseconds(m_nanoseconds + that.m_nanoseconds);
     }
 
     duration duration::operator-(const duration& that) const
     {
-        return duration(0, 0, 0, m_seconds - that.m_seconds);
+        return from_nanoseconds(m_nanoseconds - that.m_nanoseconds);
     }
 
-    duration duration::operator*(int factor) const
+    duration duration::operator*(int64_t factor) const
     {
-        return duration(0, 0, 0, m_seconds * factor);
+        return from_nanoseconds(m_nanoseconds * factor);
     }
 
-    duration duration::operator/(int quotient) const
+    duration duration::operator/(int64_t quotient) const
     {
-        return duration(0, 0, 0, m_seconds / quotient);
+        return from_nanoseconds(m_nanoseconds / quotient);
     }
 }
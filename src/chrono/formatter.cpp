@@ -0,0 +1,537 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/formatter.hpp>
+#include <stdexcept>
+#include "../text/utf8utils.hpp"
+
+namespace
+{
+    /**
+     * Instructions of a compiled pattern.
+     */
+    enum opcode
+    {
+        op_literal,
+        op_year,
+        op_year2,
+        op_century,
+        op_month,
+        op_day,
+        op_day_padded,
+        op_day_of_year,
+        op_hour,
+        op_hour12,
+        op_minute,
+        op_second,
+        op_microsecond,
+        op_nanosecond,
+        op_am_pm,
+        op_weekday_abbreviation,
+        op_weekday_name,
+        op_month_abbreviation,
+        op_month_name,
+        op_weekday_iso,
+        op_weekday_sunday
+    };
+}
+
+namespace peelo
+{
+    /**
+     * Maximum output length of each opcode, except literals.
+     */
+    static const std::size_t max_lengths[] =
+    {
+        0,  // op_literal
+        11, // op_year
+        2,  // op_year2
+        9,  // op_century
+        2,  // op_month
+        2,  // op_day
+        2,  // op_day_padded
+        3,  // op_day_of_year
+        2,  // op_hour
+        2,  // op_hour12
+        2,  // op_minute
+        2,  // op_second
+        6,  // op_microsecond
+        9,  // op_nanosecond
+        2,  // op_am_pm
+        3,  // op_weekday_abbreviation
+        9,  // op_weekday_name
+        3,  // op_month_abbreviation
+        9,  // op_month_name
+        1,  // op_weekday_iso
+        1   // op_weekday_sunday
+    };
+
+    formatter::formatter(const char* pattern)
+        : m_max_length(0)
+    {
+        compile(pattern);
+    }
+
+    formatter::formatter(const string& pattern)
+        : m_max_length(0)
+    {
+        compile(pattern.utf8().data());
+    }
+
+    formatter::formatter(const formatter& that)
+        : m_instructions(that.m_instructions)
+        , m_literals(that.m_literals)
+        , m_max_length(that.m_max_length) {}
+
+    formatter::~formatter() {}
+
+    formatter& formatter::assign(const formatter& that)
+    {
+        m_instructions = that.m_instructions;
+        m_literals = that.m_literals;
+        m_max_length = that.m_max_length;
+
+        return *this;
+    }
+
+    void formatter::emit(int opcode)
+    {
+        instruction i;
+
+        i.opcode = opcode;
+        i.offset = 0;
+        i.length = 0;
+        m_instructions.push_back(i);
+        m_max_length += max_lengths[opcode];
+    }
+
+    void formatter::literal(const char* text, std::size_t length)
+    {
+        const std::size_t count = m_instructions.size();
+
+        // Consecutive literal text is merged into single instruction.
+        if (count > 0
+            && m_instructions[count - 1].opcode == op_literal
+            && m_instructions[count - 1].offset
+                + m_instructions[count - 1].length == m_literals.size())
+        {
+            m_instructions[count - 1].length += length;
+        } else {
+            instruction i;
+
+            i.opcode = op_literal;
+            i.offset = m_literals.size();
+            i.length = length;
+            m_instructions.push_back(i);
+        }
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            m_literals.push_back(text[i]);
+        }
+        m_max_length += length;
+    }
+
+    void formatter::compile(const char* pattern)
+    {
+        const char* p = pattern;
+
+        while (*p)
+        {
+            const char* begin = p;
+
+            while (*p && *p != '%')
+            {
+                ++p;
+            }
+            if (p > begin)
+            {
+                literal(begin, static_cast<std::size_t>(p - begin));
+            }
+            if (!*p)
+            {
+                break;
+            }
+            switch (*++p)
+            {
+                case 'Y': emit(op_year); break;
+                case 'y': emit(op_year2); break;
+                case 'C': emit(op_century); break;
+                case 'm': emit(op_month); break;
+                case 'd': emit(op_day); break;
+                case 'e': emit(op_day_padded); break;
+                case 'j': emit(op_day_of_year); break;
+                case 'H': emit(op_hour); break;
+                case 'I': emit(op_hour12); break;
+                case 'M': emit(op_minute); break;
+                case 'S': emit(op_second); break;
+                case 'f': emit(op_microsecond); break;
+                case 'N': emit(op_nanosecond); break;
+                case 'p': emit(op_am_pm); break;
+                case 'a': emit(op_weekday_abbreviation); break;
+                case 'A': emit(op_weekday_name); break;
+                case 'b': case 'h': emit(op_month_abbreviation); break;
+                case 'B': emit(op_month_name); break;
+                case 'u': emit(op_weekday_iso); break;
+                case 'w': emit(op_weekday_sunday); break;
+                case 'F': compile("%Y-%m-%d"); break;
+                case 'T': compile("%H:%M:%S"); break;
+                case 'R': compile("%H:%M"); break;
+                case 'D': compile("%m/%d/%y"); break;
+                case 'n': literal("\n", 1); break;
+                case 't': literal("\t", 1); break;
+                case '%': literal("%", 1); break;
+
+                default:
+                    throw std::invalid_argument(
+                            "unknown conversion specification in pattern"
+                    );
+            }
+            ++p;
+        }
+    }
+
+    /**
+     * Output sink which writes into a fixed size character buffer and keeps
+     * count of the complete output length.
+     */
+    class buffer_sink
+    {
+    public:
+        explicit buffer_sink(char* output, std::size_t size)
+            : m_output(output)
+            , m_limit(size ? size - 1 : 0)
+            , m_length(0) {}
+
+        inline void put(char c)
+        {
+            if (m_length < m_limit)
+            {
+                m_output[m_length] = c;
+            }
+            ++m_length;
+        }
+
+        /**
+         * Writes literal text, which is copied as UTF-8 octets.
+         */
+        inline void put_literal(const char* text, std::size_t length)
+        {
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                put(text[i]);
+            }
+        }
+
+        inline std::size_t length() const
+        {
+            return m_length;
+        }
+
+    private:
+        char* m_output;
+        const std::size_t m_limit;
+        std::size_t m_length;
+    };
+
+    /**
+     * Output sink which appends into a string builder.
+     */
+    class stringbuilder_sink
+    {
+    public:
+        explicit stringbuilder_sink(stringbuilder& output)
+            : m_output(output) {}
+
+        inline void put(char c)
+        {
+            m_output.append(static_cast<int>(static_cast<unsigned char>(c)));
+        }
+
+        /**
+         * Decodes literal text from UTF-8 and appends the decoded runes.
+         * Malformed sequences are replaced with U+FFFD.
+         */
+        void put_literal(const char* text, std::size_t length)
+        {
+            std::size_t i = 0;
+
+            while (i < length)
+            {
+                const unsigned char c = static_cast<unsigned char>(text[i]);
+                const std::size_t size = utf8_decode_size(c);
+                int code;
+
+                if (size == 1)
+                {
+                    m_output.append(static_cast<int>(c));
+                    ++i;
+                    continue;
+                }
+                else if (!size || size > 4 || i + size > length)
+                {
+                    m_output.append(0xfffd);
+                    ++i;
+                    continue;
+                }
+                code = c & (0x7f >> size);
+                for (std::size_t j = 1; j < size; ++j)
+                {
+                    const unsigned char cc = static_cast<unsigned char>(
+                        text[i + j]
+                    );
+
+                    if ((cc & 0xc0) != 0x80)
+                    {
+                        code = -1;
+                        break;
+                    }
+                    code = (code << 6) | (cc & 0x3f);
+                }
+                if (code < 0)
+                {
+                    m_output.append(0xfffd);
+                    ++i;
+                } else {
+                    m_output.append(code);
+                    i += size;
+                }
+            }
+        }
+
+    private:
+        stringbuilder& m_output;
+    };
+
+    template< class Sink >
+    static inline void put_string(Sink& sink, const char* str)
+    {
+        while (*str)
+        {
+            sink.put(*str++);
+        }
+    }
+
+    /**
+     * Writes non-negative number padded to given width with given padding
+     * character.
+     */
+    template< class Sink >
+    static inline void put_number(Sink& sink,
+                                  long number,
+                                  int width,
+                                  char padding = '0')
+    {
+        unsigned long value = static_cast<unsigned long>(number);
+        char digits[20];
+        int count = 0;
+
+        do
+        {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        while (value);
+        while (count < width)
+        {
+            digits[count++] = padding;
+        }
+        while (count > 0)
+        {
+            sink.put(digits[--count]);
+        }
+    }
+
+    template< class Sink >
+    static void execute(const formatter::instruction* instructions,
+                        std::size_t count,
+                        const char* literals,
+                        const datetime& dt,
+                        Sink& sink)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const formatter::instruction& ins = instructions[i];
+
+            switch (ins.opcode)
+            {
+                case op_literal:
+                    sink.put_literal(literals + ins.offset, ins.length);
+                    break;
+
+                case op_year:
+                {
+                    const int year = dt.year();
+
+                    if (year < 0)
+                    {
+                        sink.put('-');
+                        put_number(sink, -static_cast<long>(year), 4);
+                    } else {
+                        put_number(sink, year, 4);
+                    }
+                    break;
+                }
+
+                case op_year2:
+                {
+                    const int year = dt.year() % 100;
+
+                    put_number(sink, year < 0 ? year + 100 : year, 2);
+                    break;
+                }
+
+                case op_century:
+                {
+                    const int year = dt.year();
+                    int century = year >= 0 ? year / 100 : -((99 - year) / 100);
+
+                    if (century < 0)
+                    {
+                        sink.put('-');
+                        century = -century;
+                    }
+                    put_number(sink, century, 2);
+                    break;
+                }
+
+                case op_month:
+                    put_number(sink, dt.month().index(), 2);
+                    break;
+
+                case op_day:
+                    put_number(sink, dt.day(), 2);
+                    break;
+
+                case op_day_padded:
+                    put_number(sink, dt.day(), 2, ' ');
+                    break;
+
+                case op_day_of_year:
+                    put_number(sink, dt.day_of_year(), 3);
+                    break;
+
+                case op_hour:
+                    put_number(sink, dt.hour(), 2);
+                    break;
+
+                case op_hour12:
+                {
+                    const int hour = dt.hour() % 12;
+
+                    put_number(sink, hour ? hour : 12, 2);
+                    break;
+                }
+
+                case op_minute:
+                    put_number(sink, dt.minute(), 2);
+                    break;
+
+                case op_second:
+                    put_number(sink, dt.second(), 2);
+                    break;
+
+                case op_microsecond:
+                    put_number(sink, dt.nanosecond() / 1000, 6);
+                    break;
+
+                case op_nanosecond:
+                    put_number(sink, dt.nanosecond(), 9);
+                    break;
+
+                case op_am_pm:
+                    put_string(sink, dt.hour() < 12 ? "AM" : "PM");
+                    break;
+
+                case op_weekday_abbreviation:
+                    put_string(sink, dt.day_of_week().abbreviation());
+                    break;
+
+                case op_weekday_name:
+                    put_string(sink, dt.day_of_week().name());
+                    break;
+
+                case op_month_abbreviation:
+                    put_string(sink, dt.month().abbreviation());
+                    break;
+
+                case op_month_name:
+                    put_string(sink, dt.month().name());
+                    break;
+
+                case op_weekday_iso:
+                    put_number(sink, dt.day_of_week().index(), 1);
+                    break;
+
+                case op_weekday_sunday:
+                    put_number(sink, dt.day_of_week().index() % 7, 1);
+                    break;
+            }
+        }
+    }
+
+    std::size_t formatter::format(const datetime& dt,
+                                  char* output,
+                                  std::size_t size) const
+    {
+        buffer_sink sink(output, size);
+
+        execute(
+                m_instructions.data(),
+                m_instructions.size(),
+                m_literals.data(),
+                dt,
+                sink
+        );
+        if (size)
+        {
+            output[sink.length() < size ? sink.length() : size - 1] = 0;
+        }
+
+        return sink.length();
+    }
+
+    void formatter::format(const datetime& dt, stringbuilder& output) const
+    {
+        stringbuilder_sink sink(output);
+
+        output.reserve(output.length() + m_max_length);
+        execute(
+                m_instructions.data(),
+                m_instructions.size(),
+                m_literals.data(),
+                dt,
+                sink
+        );
+    }
+
+    string formatter::format(const datetime& dt) const
+    {
+        stringbuilder output(m_max_length);
+
+        format(dt, output);
+
+        return output.str();
+    }
+}
@@ -146,93 +146,55 @@ namespace peelo
         return month(index);
     }
 
-    std::ostream& operator<<(std::ostream& os, const month& m)
+    static const char* const month_names[12] =
     {
-        switch (m.index())
-        {
-            case 1:
-                os << "January";
-                break;
-            case 2:
-                os << "February";
-                break;
-            case 3:
-                os << "March";
-                break;
-            case 4:
-                os << "April";
-                break;
-            case 5:
-                os << "May";
-                break;
-            case 6:
-                os << "June";
-                break;
-            case 7:
-                os << "July";
-                break;
-            case 8:
-                os << "August";
-                break;
-            case 9:
-                os << "September";
-                break;
-            case 10:
-                os << "October";
-                break;
-            case 11:
-                os << "November";
-                break;
-            case 12:
-                os << "December";
-                break;
-        }
+        "January",
+        "February",
+        "March",
+        "April",
+        "May",
+        "June",
+        "July",
+        "August",
+        "September",
+        "October",
+        "November",
+        "December"
+    };
+
+    static const char* const month_abbreviations[12] =
+    {
+        "Jan",
+        "Feb",
+        "Mar",
+        "Apr",
+        "May",
+        "Jun",
+        "Jul",
+        "Aug",
+        "Sep",
+        "Oct",
+        "Nov",
+        "Dec"
+    };
+
+    const char* month::name() const
+    {
+        return month_names[m_index - 1];
+    }
+
+    const char* month::abbreviation() const
+    {
+        return month_abbreviations[m_index - 1];
+    }
 
-        return os;
+    std::ostream& operator<<(std::ostream& os, const month& m)
+    {
+        return os << m.name();
     }
 
     std::wostream& operator<<(std::wostream& os, const month& m)
     {
-        switch (m.index())
-        {
-            case 1:
-                os << L"January";
-                break;
-            case 2:
-                os << L"February";
-                break;
-            case 3:
-                os << L"March";
-                break;
-            case 4:
-                os << L"April";
-                break;
-            case 5:
-                os << L"May";
-                break;
-            case 6:
-                os << L"June";
-                break;
-            case 7:
-                os << L"July";
-                break;
-            case 8:
-                os << L"August";
-                break;
-            case 9:
-                os << L"September";
-                break;
-            case 10:
-                os << L"October";
-                break;
-            case 11:
-                os << L"November";
-                break;
-            case 12:
-                os << L"December";
-                break;
-        }
-
-        return os;
+        return os << m.name();
     }
 }
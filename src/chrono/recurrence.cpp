@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/recurrence.hpp>
+#include <stdexcept>
+#include "civil.hpp"
+
+namespace peelo
+{
+    /**
+     * Gregorian calendar repeats itself every 400 years, so a monthly rule
+     * which has no occurrences within this many steps never has any.
+     */
+    static const long months_per_calendar_cycle = 400 * 12;
+
+    static long to_days(const date& d)
+    {
+        return days_from_civil(d.year(), d.month().index(), d.day());
+    }
+
+    static date from_days(long days)
+    {
+        long year;
+        int month;
+        int day;
+
+        civil_from_days(days, year, month, day);
+
+        return date(static_cast<int>(year), peelo::month(month), day);
+    }
+
+    recurrence::recurrence(enum kind k,
+                           const date& start,
+                           int interval,
+                           int day,
+                           int ordinal)
+        : m_kind(k)
+        , m_start(to_days(start))
+        , m_interval(interval)
+        , m_weekday(day)
+        , m_ordinal(ordinal)
+    {
+        if (interval < 1)
+        {
+            throw std::invalid_argument("recurrence interval must be positive");
+        }
+    }
+
+    recurrence::recurrence(const recurrence& that)
+        : m_kind(that.m_kind)
+        , m_start(that.m_start)
+        , m_interval(that.m_interval)
+        , m_weekday(that.m_weekday)
+        , m_ordinal(that.m_ordinal) {}
+
+    recurrence recurrence::weekly(const date& start,
+                                  const weekday& wd,
+                                  int interval)
+    {
+        return recurrence(kind_weekly, start, interval, wd.index(), 0);
+    }
+
+    recurrence recurrence::monthly(const date& start, int day, int interval)
+    {
+        if (day < 1 || day > 31)
+        {
+            throw std::invalid_argument("invalid day of the month");
+        }
+
+        return recurrence(kind_monthly_day, start, interval, day, 0);
+    }
+
+    recurrence recurrence::monthly(const date& start,
+                                   const weekday& wd,
+                                   int n,
+                                   int interval)
+    {
+        if (n == 0 || n < -5 || n > 5)
+        {
+            throw std::invalid_argument("invalid weekday ordinal");
+        }
+
+        return recurrence(kind_monthly_weekday, start, interval, wd.index(), n);
+    }
+
+    date recurrence::start() const
+    {
+        return from_days(m_start);
+    }
+
+    bool recurrence::find(long from, long& result) const
+    {
+        long year;
+        int month;
+        int day;
+        long first;
+        long steps;
+
+        if (from < m_start)
+        {
+            from = m_start;
+        }
+
+        if (m_kind == kind_weekly)
+        {
+            // Occurrence in the week where the recurrence begins, which may
+            // also be before the starting date.
+            const long origin = m_start
+                - weekday_from_days(m_start)
+                + m_weekday;
+            const long period = 7L * m_interval;
+
+            steps = (from - origin + period - 1) / period;
+            result = origin + (steps > 0 ? steps : 0) * period;
+
+            return true;
+        }
+
+        civil_from_days(m_start, year, month, day);
+        first = year * 12 + month - 1;
+        civil_from_days(from, year, month, day);
+        steps = (year * 12 + month - 1 - first) / m_interval;
+
+        for (long i = 0; i <= months_per_calendar_cycle; ++i, ++steps)
+        {
+            const long index = first + steps * m_interval;
+            const long y = index >= 0 ? index / 12 : (index - 11) / 12;
+            const int m = static_cast<int>(index - y * 12) + 1;
+            const int length = days_in_civil_month(y, m);
+            int d;
+
+            if (m_kind == kind_monthly_day)
+            {
+                d = m_weekday;
+            }
+            else if (m_ordinal > 0)
+            {
+                const int wd = weekday_from_days(days_from_civil(y, m, 1));
+
+                d = 1 + (m_weekday - wd + 7) % 7 + (m_ordinal - 1) * 7;
+            } else {
+                const int wd = weekday_from_days(days_from_civil(y, m, length));
+
+                d = length - (wd - m_weekday + 7) % 7 + (m_ordinal + 1) * 7;
+            }
+            if (d >= 1 && d <= length)
+            {
+                const long candidate = days_from_civil(y, m, d);
+
+                if (candidate >= from)
+                {
+                    result = candidate;
+
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    date recurrence::next(const date& from) const
+    {
+        long result;
+
+        if (!find(to_days(from), result))
+        {
+            throw std::out_of_range("no more occurrences");
+        }
+
+        return from_days(result);
+    }
+
+    vector<date> recurrence::expand(const date& from, const date& until) const
+    {
+        const long end = to_days(until);
+        vector<date> result;
+        long current;
+
+        if (!find(to_days(from), current) || current >= end)
+        {
+            return result;
+        }
+
+        // Reserve room for the maximum number of occurrences up front, as
+        // the vector would otherwise grow one element at a time.
+        result.reserve(static_cast<vector<date>::size_type>(
+                m_kind == kind_weekly
+                    ? (end - current) / (7L * m_interval) + 1
+                    : (end - current) / (28L * m_interval) + 1
+        ));
+        do
+        {
+            result.push_back(from_days(current));
+        }
+        while (find(current + 1, current) && current < end);
+
+        return result;
+    }
+
+    recurrence& recurrence::assign(const recurrence& that)
+    {
+        m_kind = that.m_kind;
+        m_start = that.m_start;
+        m_interval = that.m_interval;
+        m_weekday = that.m_weekday;
+        m_ordinal = that.m_ordinal;
+
+        return *this;
+    }
+
+    bool recurrence::equals(const recurrence& that) const
+    {
+        return m_kind == that.m_kind
+            && m_start == that.m_start
+            && m_interval == that.m_interval
+            && m_weekday == that.m_weekday
+            && m_ordinal == that.m_ordinal;
+    }
+}
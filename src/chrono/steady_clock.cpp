@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/steady_clock.hpp>
+#include <atomic>
+#include <mutex>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+# include <cpuid.h>
+# include <x86intrin.h>
+# define PEELO_STEADY_CLOCK_TSC 1
+#endif
+#include "clock.hpp"
+
+namespace peelo
+{
+#if defined(PEELO_STEADY_CLOCK_TSC)
+    /**
+     * Frequency of the time stamp counter, measured once against the
+     * monotonic clock of the system.
+     */
+    struct tsc_calibration
+    {
+        /** Whether the processor has an invariant time stamp counter. */
+        bool available;
+        /**
+         * Length of one counter tick in nanoseconds, as fixed point number
+         * with 32 fractional bits.
+         */
+        uint64_t tick_length;
+    };
+
+    static tsc_calibration calibrate()
+    {
+        // Length of the calibration period in nanoseconds.
+        static const int64_t period = 10000000;
+        tsc_calibration result;
+        unsigned int eax;
+        unsigned int ebx;
+        unsigned int ecx;
+        unsigned int edx;
+        int64_t start_nanoseconds;
+        int64_t end_nanoseconds;
+        uint64_t start_ticks;
+        uint64_t end_ticks;
+
+        result.available = false;
+        result.tick_length = 0;
+        if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx)
+            || eax < 0x80000007
+            || !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)
+            || !(edx & (1u << 8)))
+        {
+            return result;
+        }
+        start_nanoseconds = monotonic_now();
+        start_ticks = __rdtsc();
+        do
+        {
+            end_nanoseconds = monotonic_now();
+            end_ticks = __rdtsc();
+        }
+        while (end_nanoseconds - start_nanoseconds < period);
+        if (end_ticks <= start_ticks)
+        {
+            return result;
+        }
+        result.tick_length = (
+            static_cast<uint64_t>(end_nanoseconds - start_nanoseconds) << 32
+        ) / (end_ticks - start_ticks);
+        result.available = result.tick_length > 0;
+
+        return result;
+    }
+
+    static const tsc_calibration& calibration()
+    {
+        static const tsc_calibration instance(calibrate());
+
+        return instance;
+    }
+
+    /**
+     * Converts counter ticks into nanoseconds. The multiplication is split
+     * into halves so that it cannot overflow and keeps full precision even
+     * when the counter has been running for a long time.
+     */
+    static inline int64_t ticks_to_nanoseconds(uint64_t ticks,
+                                               uint64_t tick_length)
+    {
+        return static_cast<int64_t>(
+            (ticks >> 32) * tick_length
+            + (((ticks & 0xffffffff) * tick_length) >> 32)
+        );
+    }
+
+    /**
+     * State of the clock, published to readers with a sequence lock. When
+     * the counter is in use, readings are extrapolated from the counter
+     * value and clock reading taken when it was enabled. Otherwise
+     * readings are those of the monotonic clock of the system shifted by
+     * an offset.
+     *
+     * Whenever the source is switched, the new one is set to continue from
+     * the current reading of the old one. Readings therefore never go
+     * backwards, even though the sources drift apart, and reading the clock
+     * never writes to shared memory.
+     */
+    static std::atomic<unsigned> state_sequence(0);
+    static std::atomic<bool> tsc_enabled(false);
+    static std::atomic<uint64_t> anchor_ticks(0);
+    static std::atomic<int64_t> anchor_nanoseconds(0);
+    static std::atomic<int64_t> monotonic_offset(0);
+    static std::mutex state_mutex;
+
+    static inline int64_t read(bool tsc,
+                               uint64_t ticks,
+                               int64_t nanoseconds,
+                               int64_t offset)
+    {
+        if (tsc)
+        {
+            const uint64_t now = __rdtsc();
+
+            // Counters of different cores may differ slightly.
+            return now > ticks
+                ? nanoseconds + ticks_to_nanoseconds(
+                    now - ticks,
+                    calibration().tick_length
+                )
+                : nanoseconds;
+        }
+
+        return monotonic_now() + offset;
+    }
+
+    static void switch_source(bool tsc)
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        const unsigned sequence = state_sequence.load(
+            std::memory_order_relaxed
+        );
+        int64_t reading;
+
+        state_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        reading = read(tsc_enabled.load(std::memory_order_relaxed),
+                       anchor_ticks.load(std::memory_order_relaxed),
+                       anchor_nanoseconds.load(std::memory_order_relaxed),
+                       monotonic_offset.load(std::memory_order_relaxed));
+        // The new source is read after the old one, so it can only start
+        // slightly ahead of it.
+        if (tsc)
+        {
+            anchor_nanoseconds.store(reading, std::memory_order_relaxed);
+            anchor_ticks.store(__rdtsc(), std::memory_order_relaxed);
+        } else {
+            monotonic_offset.store(reading - monotonic_now(),
+                                   std::memory_order_relaxed);
+        }
+        tsc_enabled.store(tsc, std::memory_order_relaxed);
+        state_sequence.store(sequence + 2, std::memory_order_release);
+    }
+#endif
+
+    duration steady_clock::now()
+    {
+#if defined(PEELO_STEADY_CLOCK_TSC)
+        unsigned sequence;
+        int64_t reading;
+
+        do
+        {
+            sequence = state_sequence.load(std::memory_order_acquire);
+            reading = read(tsc_enabled.load(std::memory_order_relaxed),
+                           anchor_ticks.load(std::memory_order_relaxed),
+                           anchor_nanoseconds.load(std::memory_order_relaxed),
+                           monotonic_offset.load(std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        while ((sequence & 1)
+               || sequence != state_sequence.load(std::memory_order_relaxed));
+
+        return duration::from_nanoseconds(reading);
+#else
+        return duration::from_nanoseconds(monotonic_now());
+#endif
+    }
+
+    bool steady_clock::enable_tsc()
+    {
+#if defined(PEELO_STEADY_CLOCK_TSC)
+        if (calibration().available)
+        {
+            switch_source(true);
+
+            return true;
+        }
+#endif
+
+        return false;
+    }
+
+    void steady_clock::disable_tsc()
+    {
+#if defined(PEELO_STEADY_CLOCK_TSC)
+        if (tsc_enabled.load())
+        {
+            switch_source(false);
+        }
+#endif
+    }
+
+    bool steady_clock::is_tsc_enabled()
+    {
+#if defined(PEELO_STEADY_CLOCK_TSC)
+        return tsc_enabled.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/stopwatch.hpp>
+
+namespace peelo
+{
+    stopwatch::stopwatch(bool running)
+        : m_running(false)
+    {
+        if (running)
+        {
+            start();
+        }
+    }
+
+    stopwatch::stopwatch(const stopwatch& that)
+        : m_running(that.m_running)
+        , m_started(that.m_started)
+        , m_elapsed(that.m_elapsed)
+        , m_last_lap(that.m_last_lap)
+        , m_laps(that.m_laps) {}
+
+    void stopwatch::start()
+    {
+        if (!m_running)
+        {
+            m_started = steady_clock::now();
+            m_running = true;
+        }
+    }
+
+    void stopwatch::stop()
+    {
+        if (m_running)
+        {
+            m_elapsed = m_elapsed + (steady_clock::now() - m_started);
+            m_running = false;
+        }
+    }
+
+    void stopwatch::reset()
+    {
+        m_running = false;
+        m_elapsed = duration();
+        m_last_lap = duration();
+        m_laps.clear();
+    }
+
+    void stopwatch::restart()
+    {
+        reset();
+        start();
+    }
+
+    duration stopwatch::elapsed() const
+    {
+        if (m_running)
+        {
+            return m_elapsed + (steady_clock::now() - m_started);
+        }
+
+        return m_elapsed;
+    }
+
+    duration stopwatch::lap()
+    {
+        const duration total = elapsed();
+        const duration result = total - m_last_lap;
+
+        if (m_laps.size() == m_laps.capacity())
+        {
+            m_laps.reserve(m_laps.capacity() ? m_laps.capacity() * 2 : 8);
+        }
+        m_laps.push_back(result);
+        m_last_lap = total;
+
+        return result;
+    }
+
+    stopwatch& stopwatch::assign(const stopwatch& that)
+    {
+        m_running = that.m_running;
+        m_started = that.m_started;
+        m_elapsed = that.m_elapsed;
+        m_last_lap = that.m_last_lap;
+        m_laps = that.m_laps;
+
+        return *this;
+    }
+}
@@ -28,18 +28,20 @@
 #if defined(_WIN32)
 # define WIN32_LEAN_AND_MEAN
 # include <windows.h>
-#else
-# include <ctime>
 #endif
+#include <ctime>
+#include "civil.hpp"
+#include "clock.hpp"
 
 namespace peelo
 {
-    time::time(int hour, int minute, int second)
+    time::time(int hour, int minute, int second, int nanosecond)
         : m_hour(hour)
         , m_minute(minute)
         , m_second(second)
+        , m_nanosecond(nanosecond)
     {
-        if (!is_valid(hour, minute, second))
+        if (!is_valid(hour, minute, second, nanosecond))
         {
             throw std::invalid_argument("invalid time value");
         }
@@ -48,7 +50,8 @@ namespace peelo
     time::time(const time& that)
         : m_hour(that.m_hour)
         , m_minute(that.m_minute)
-        , m_second(that.m_second) {}
+        , m_second(that.m_second)
+        , m_nanosecond(that.m_nanosecond) {}
 
     time time::now()
     {
@@ -57,63 +60,96 @@ namespace peelo
 
         ::GetLocalTime(&local_time);
 
-        return time(local_time.wHour, local_time.wMinute, local_time.wSecond);
+        return time(
+                local_time.wHour,
+                local_time.wMinute,
+                local_time.wSecond,
+                local_time.wMilliseconds * 1000000
+        );
 #else
-        std::time_t ts = std::time(0);
-        std::tm* tm = std::localtime(&ts);
+        return now(time_zone::local());
+#endif
+    }
 
-        if (!tm)
-        {
-            throw std::runtime_error("localtime() failed");
-        }
+    time time::now(const time_zone& zone)
+    {
+        long timestamp;
+        int nanosecond;
+        long days;
+        long seconds;
 
-        return time(tm->tm_hour, tm->tm_min, tm->tm_sec);
-#endif
+        realtime_now(timestamp, nanosecond);
+        split_timestamp(zone.to_local(timestamp), days, seconds);
+
+        return time(
+                static_cast<int>(seconds / 3600),
+                static_cast<int>(seconds / 60 % 60),
+                static_cast<int>(seconds % 60),
+                nanosecond
+        );
     }
 
-    bool time::is_valid(int hour, int minute, int second)
+    bool time::is_valid(int hour, int minute, int second, int nanosecond)
     {
-        return (hour >= 0 && hour < 23)
-            && (minute >= 0 && minute < 59)
-            && (second >= 0 && second < 59);
+        return (hour >= 0 && hour < 24)
+            && (minute >= 0 && minute < 60)
+            && (second >= 0 && second < 60)
+            && (nanosecond >= 0 && nanosecond < 1000000000);
     }
 
     time& time::assign(const time& that)
     {
-        return assign(that.m_hour, that.m_minute, that.m_second);
+        return assign(
+                that.m_hour,
+                that.m_minute,
+                that.m_second,
+                that.m_nanosecond
+        );
     }
 
-    time& time::assign(int hour, int minute, int second)
+    time& time::assign(int hour, int minute, int second, int nanosecond)
     {
-        if (!is_valid(hour, minute, second))
+        if (!is_valid(hour, minute, second, nanosecond))
         {
             throw std::invalid_argument("invalid time value");
         }
         m_hour = hour;
         m_minute = minute;
         m_second = second;
+        m_nanosecond = nanosecond;
 
         return *this;
     }
 
     bool time::equals(const time& that) const
     {
-        return equals(that.m_hour, that.m_minute, that.m_second);
+        return equals(
+                that.m_hour,
+                that.m_minute,
+                that.m_second,
+                that.m_nanosecond
+        );
     }
 
-    bool time::equals(int hour, int minute, int second) const
+    bool time::equals(int hour, int minute, int second, int nanosecond) const
     {
         return m_hour == hour
             && m_minute == minute
-            && m_second == second;
+            && m_second == second
+            && m_nanosecond == nanosecond;
     }
 
     int time::compare(const time& that) const
     {
-        return compare(that.m_hour, that.m_minute, that.m_second);
+        return compare(
+                that.m_hour,
+                that.m_minute,
+                that.m_second,
+                that.m_nanosecond
+        );
     }
 
-    int time::compare(int hour, int minute, int second) const
+    int time::compare(int hour, int minute, int second, int nanosecond) const
     {
         if (m_hour != hour)
         {
@@ -126,6 +162,10 @@ namespace peelo
         else if (m_second != second)
         {
             return m_second > second ? 1 : -1;
+        }
+        else if (m_nanosecond != nanosecond)
+        {
+            return m_nanosecond > nanosecond ? 1 : -1;
         } else {
             return 0;
         }
@@ -223,11 +263,29 @@ namespace peelo
             os << '0';
         }
         os << minute << ':';
-        if (second < 0)
+        if (second < 10)
         {
             os << '0';
         }
         os << second;
+        if (t.nanosecond())
+        {
+            char digits[10];
+            int value = t.nanosecond();
+            int length = 9;
+
+            for (int i = 8; i >= 0; --i)
+            {
+                digits[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            while (digits[length - 1] == '0')
+            {
+                --length;
+            }
+            digits[length] = 0;
+            os << '.' << digits;
+        }
 
         return os;
     }
@@ -248,11 +306,29 @@ namespace peelo
             os << L'0';
         }
         os << minute << L':';
-        if (second < 0)
+        if (second < 10)
         {
             os << L'0';
         }
         os << second;
+        if (t.nanosecond())
+        {
+            char digits[10];
+            int value = t.nanosecond();
+            int length = 9;
+
+            for (int i = 8; i >= 0; --i)
+            {
+                digits[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            while (digits[length - 1] == '0')
+            {
+                --length;
+            }
+            digits[length] = 0;
+            os << L'.' << digits;
+        }
 
         return os;
     }
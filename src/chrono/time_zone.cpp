@@ -0,0 +1,843 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/time_zone.hpp>
+#include <peelo/container/vector.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "civil.hpp"
+
+namespace peelo
+{
+    namespace
+    {
+        struct local_type
+        {
+            /** UTC offset in seconds. */
+            long offset;
+            /** Whether the type represents daylight saving time. */
+            bool dst;
+            /** Index of the abbreviation in the abbreviation pool. */
+            std::size_t abbreviation;
+        };
+
+        struct rule_date
+        {
+            enum kind
+            {
+                /** Julian day from 1 to 365, February 29th is never counted. */
+                julian,
+                /** Zero based day of the year from 0 to 365. */
+                zero_based,
+                /** Day d (0 = Sunday) of week w (5 = last) of month m. */
+                month_week_day
+            };
+
+            kind type;
+            int day;
+            int week;
+            int month;
+            /** Local time of the transition in seconds. */
+            long time;
+        };
+
+        /**
+         * POSIX TZ rule, used for timestamps after the last transition of
+         * TZif data.
+         */
+        struct rule
+        {
+            bool has_dst;
+            long std_offset;
+            long dst_offset;
+            std::string std_abbreviation;
+            std::string dst_abbreviation;
+            rule_date start;
+            rule_date end;
+        };
+
+        /**
+         * Result of a lookup.
+         */
+        struct local_info
+        {
+            long offset;
+            bool dst;
+            const char* abbreviation;
+        };
+    }
+
+    struct time_zone::data
+    {
+        /** Name of the time zone. */
+        std::string name;
+        /** Sorted transition times. */
+        vector<long> transitions;
+        /** Index of the local type which begins at each transition. */
+        vector<unsigned char> indices;
+        /** Local time types. */
+        vector<local_type> types;
+        /** NUL separated abbreviations referenced by local types. */
+        std::string abbreviations;
+        /** Whether the footer rule is present. */
+        bool has_rule;
+        /** Footer rule used after the last transition. */
+        rule footer;
+    };
+
+    static const std::shared_ptr<const time_zone::data>& utc_data();
+    static local_info lookup(const time_zone::data&, long);
+
+    time_zone::time_zone()
+        : m_data(utc_data()) {}
+
+    time_zone::time_zone(const time_zone& that)
+        : m_data(that.m_data) {}
+
+    time_zone::time_zone(const std::shared_ptr<const data>& data)
+        : m_data(data) {}
+
+    time_zone::~time_zone() {}
+
+    const time_zone& time_zone::utc()
+    {
+        static const time_zone zone;
+
+        return zone;
+    }
+
+    static time_zone load_local()
+    {
+        const char* tz = std::getenv("TZ");
+
+        try
+        {
+            if (!tz)
+            {
+                return time_zone::load("/etc/localtime");
+            }
+            if (*tz == ':')
+            {
+                ++tz;
+            }
+            if (!*tz)
+            {
+                return time_zone::utc();
+            }
+            try
+            {
+                return time_zone::load(tz);
+            }
+            catch (std::exception&)
+            {
+                return time_zone::parse_rule(tz);
+            }
+        }
+        catch (std::exception&)
+        {
+            return time_zone::utc();
+        }
+    }
+
+    const time_zone& time_zone::local()
+    {
+        static const time_zone zone(load_local());
+
+        return zone;
+    }
+
+    time_zone time_zone::load(const string& name)
+    {
+        const vector<char> encoded = name.utf8();
+        const std::string relative(encoded.data());
+        std::string path;
+        std::FILE* file;
+        std::string buffer;
+        char chunk[4096];
+        std::size_t n;
+
+        if (relative.empty() || relative.find("..") != std::string::npos)
+        {
+            throw std::invalid_argument("invalid time zone name");
+        }
+        if (relative[0] == '/')
+        {
+            path = relative;
+        } else {
+            const char* directory = std::getenv("TZDIR");
+
+            path = directory && *directory ? directory : "/usr/share/zoneinfo";
+            path += '/';
+            path += relative;
+        }
+        if (!(file = std::fopen(path.c_str(), "rb")))
+        {
+            throw std::runtime_error("unable to open time zone file");
+        }
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            buffer.append(chunk, n);
+        }
+        if (std::ferror(file))
+        {
+            std::fclose(file);
+
+            throw std::runtime_error("unable to read time zone file");
+        }
+        std::fclose(file);
+
+        return parse(
+                name,
+                reinterpret_cast<const unsigned char*>(buffer.data()),
+                buffer.size()
+        );
+    }
+
+    /**
+     * Bounds checked reader for big endian TZif data.
+     */
+    class tzif_reader
+    {
+    public:
+        explicit tzif_reader(const unsigned char* data, std::size_t size)
+            : m_data(data)
+            , m_size(size)
+            , m_offset(0) {}
+
+        inline std::size_t offset() const
+        {
+            return m_offset;
+        }
+
+        void require(std::size_t n) const
+        {
+            if (m_size - m_offset < n)
+            {
+                throw std::invalid_argument("truncated TZif data");
+            }
+        }
+
+        const unsigned char* skip(std::size_t n)
+        {
+            const unsigned char* p = m_data + m_offset;
+
+            require(n);
+            m_offset += n;
+
+            return p;
+        }
+
+        unsigned char byte()
+        {
+            return *skip(1);
+        }
+
+        long int32()
+        {
+            const unsigned char* p = skip(4);
+            const unsigned long value = (static_cast<unsigned long>(p[0]) << 24)
+                | (static_cast<unsigned long>(p[1]) << 16)
+                | (static_cast<unsigned long>(p[2]) << 8)
+                | static_cast<unsigned long>(p[3]);
+
+            return value & 0x80000000UL
+                ? static_cast<long>(value) - 0x100000000L
+                : static_cast<long>(value);
+        }
+
+        long int64()
+        {
+            const unsigned char* p = skip(8);
+            unsigned long long value = 0;
+
+            for (int i = 0; i < 8; ++i)
+            {
+                value = (value << 8) | p[i];
+            }
+
+            return static_cast<long>(static_cast<long long>(value));
+        }
+
+    private:
+        const unsigned char* m_data;
+        const std::size_t m_size;
+        std::size_t m_offset;
+    };
+
+    struct tzif_header
+    {
+        char version;
+        std::size_t isutcnt;
+        std::size_t isstdcnt;
+        std::size_t leapcnt;
+        std::size_t timecnt;
+        std::size_t typecnt;
+        std::size_t charcnt;
+    };
+
+    static tzif_header read_header(tzif_reader& reader)
+    {
+        const unsigned char* magic = reader.skip(4);
+        tzif_header header;
+
+        if (std::memcmp(magic, "TZif", 4))
+        {
+            throw std::invalid_argument("missing TZif magic");
+        }
+        header.version = static_cast<char>(reader.byte());
+        reader.skip(15);
+        header.isutcnt = static_cast<std::size_t>(reader.int32());
+        header.isstdcnt = static_cast<std::size_t>(reader.int32());
+        header.leapcnt = static_cast<std::size_t>(reader.int32());
+        header.timecnt = static_cast<std::size_t>(reader.int32());
+        header.typecnt = static_cast<std::size_t>(reader.int32());
+        header.charcnt = static_cast<std::size_t>(reader.int32());
+        if (!header.typecnt || header.typecnt > 256)
+        {
+            throw std::invalid_argument("invalid number of local time types");
+        }
+
+        return header;
+    }
+
+    static bool parse_rule(const char*, rule&);
+
+    time_zone time_zone::parse(const string& name,
+                               const unsigned char* data,
+                               std::size_t size)
+    {
+        const vector<char> encoded = name.utf8();
+        std::shared_ptr<time_zone::data> zone(new time_zone::data());
+        tzif_reader reader(data, size);
+        tzif_header header = read_header(reader);
+        std::size_t time_size = 4;
+
+        zone->name = encoded.data();
+        zone->has_rule = false;
+
+        // Version 2 and later files repeat the data with 64-bit times after
+        // the version 1 block, so the legacy block can be skipped entirely.
+        if (header.version >= '2')
+        {
+            reader.skip(
+                    header.timecnt * 5
+                    + header.typecnt * 6
+                    + header.charcnt
+                    + header.leapcnt * 8
+                    + header.isstdcnt
+                    + header.isutcnt
+            );
+            header = read_header(reader);
+            time_size = 8;
+        }
+
+        zone->transitions.reserve(header.timecnt);
+        for (std::size_t i = 0; i < header.timecnt; ++i)
+        {
+            const long transition = time_size == 8 ? reader.int64() : reader.int32();
+
+            if (i > 0 && transition <= zone->transitions[i - 1])
+            {
+                throw std::invalid_argument("unsorted transition times");
+            }
+            zone->transitions.push_back(transition);
+        }
+        zone->indices.reserve(header.timecnt);
+        for (std::size_t i = 0; i < header.timecnt; ++i)
+        {
+            const unsigned char index = reader.byte();
+
+            if (index >= header.typecnt)
+            {
+                throw std::invalid_argument("invalid local time type index");
+            }
+            zone->indices.push_back(index);
+        }
+        zone->types.reserve(header.typecnt);
+        for (std::size_t i = 0; i < header.typecnt; ++i)
+        {
+            local_type type;
+
+            type.offset = reader.int32();
+            type.dst = reader.byte() != 0;
+            type.abbreviation = reader.byte();
+            if (type.abbreviation >= header.charcnt)
+            {
+                throw std::invalid_argument("invalid abbreviation index");
+            }
+            zone->types.push_back(type);
+        }
+        zone->abbreviations.assign(
+                reinterpret_cast<const char*>(reader.skip(header.charcnt)),
+                header.charcnt
+        );
+        // Make sure that every abbreviation is terminated.
+        zone->abbreviations += '\0';
+        reader.skip(
+                header.leapcnt * (time_size + 4)
+                + header.isstdcnt
+                + header.isutcnt
+        );
+
+        if (header.version >= '2')
+        {
+            std::size_t begin;
+            std::size_t end;
+
+            reader.require(1);
+            begin = reader.offset();
+            if (*reader.skip(1) != '\n')
+            {
+                throw std::invalid_argument("missing TZif footer");
+            }
+            end = begin + 1;
+            while (end < size && data[end] != '\n')
+            {
+                ++end;
+            }
+            if (end >= size)
+            {
+                throw std::invalid_argument("unterminated TZif footer");
+            }
+            if (end > begin + 1)
+            {
+                const std::string footer(
+                        reinterpret_cast<const char*>(data + begin + 1),
+                        end - begin - 1
+                );
+
+                if (!peelo::parse_rule(footer.c_str(), zone->footer))
+                {
+                    throw std::invalid_argument("malformed TZif footer");
+                }
+                zone->has_rule = true;
+            }
+        }
+
+        return time_zone(zone);
+    }
+
+    time_zone time_zone::parse_rule(const string& rule)
+    {
+        const vector<char> encoded = rule.utf8();
+        std::shared_ptr<time_zone::data> zone(new time_zone::data());
+
+        if (!peelo::parse_rule(encoded.data(), zone->footer))
+        {
+            throw std::invalid_argument("malformed time zone rule");
+        }
+        zone->name = encoded.data();
+        zone->has_rule = true;
+
+        return time_zone(zone);
+    }
+
+    string time_zone::name() const
+    {
+        return string(m_data->name.c_str());
+    }
+
+    long time_zone::offset(long timestamp) const
+    {
+        return lookup(*m_data, timestamp).offset;
+    }
+
+    bool time_zone::is_dst(long timestamp) const
+    {
+        return lookup(*m_data, timestamp).dst;
+    }
+
+    string time_zone::abbreviation(long timestamp) const
+    {
+        return string(lookup(*m_data, timestamp).abbreviation);
+    }
+
+    long time_zone::to_utc(long local) const
+    {
+        // Offsets before and after any transition near the given local time.
+        // No zone changes its offset twice within a day.
+        const long before = offset(local - seconds_per_civil_day);
+        const long after = offset(local + seconds_per_civil_day);
+        long first;
+        long second;
+        bool first_valid;
+        bool second_valid;
+
+        if (before == after)
+        {
+            return local - before;
+        }
+        first = local - before;
+        second = local - after;
+        first_valid = offset(first) == before;
+        second_valid = offset(second) == after;
+        if (first_valid && second_valid)
+        {
+            return first < second ? first : second;
+        }
+        else if (second_valid)
+        {
+            return second;
+        }
+
+        // Either a valid time before the transition, or a time inside a gap,
+        // which is shifted forward using the offset before the gap.
+        return first;
+    }
+
+    time_zone& time_zone::assign(const time_zone& that)
+    {
+        m_data = that.m_data;
+
+        return *this;
+    }
+
+    static time_zone::data* make_utc()
+    {
+        time_zone::data* zone = new time_zone::data();
+
+        zone->name = "UTC";
+        zone->has_rule = true;
+        parse_rule("UTC0", zone->footer);
+
+        return zone;
+    }
+
+    static const std::shared_ptr<const time_zone::data>& utc_data()
+    {
+        static const std::shared_ptr<const time_zone::data> data(make_utc());
+
+        return data;
+    }
+
+    /**
+     * Returns index of the last transition which is at or before given
+     * timestamp, using branch free binary search. The timestamp must not be
+     * before the first transition.
+     */
+    static std::size_t find_transition(const vector<long>& transitions,
+                                       long timestamp)
+    {
+        const long* base = transitions.data();
+        std::size_t n = transitions.size();
+
+        while (n > 1)
+        {
+            const std::size_t half = n / 2;
+
+            base = base[half] <= timestamp ? base + half : base;
+            n -= half;
+        }
+
+        return static_cast<std::size_t>(base - transitions.data());
+    }
+
+    /**
+     * Returns number of days since 1970-01-01 for the day in given year on
+     * which a rule transition happens.
+     */
+    static long rule_day(const rule_date& date, long year)
+    {
+        const long jan1 = days_from_civil(year, 1, 1);
+        const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+        switch (date.type)
+        {
+            case rule_date::julian:
+                return jan1 + date.day - 1 + (leap && date.day >= 60 ? 1 : 0);
+
+            case rule_date::zero_based:
+                return jan1 + date.day;
+
+            case rule_date::month_week_day:
+            {
+                static const int lengths[12] =
+                {
+                    31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+                };
+                const long first = days_from_civil(year, date.month, 1);
+                const int length = lengths[date.month - 1]
+                    + (leap && date.month == 2 ? 1 : 0);
+                // Weekday of the first day of the month, 0 = Sunday.
+                const int weekday = weekday_from_days(first) % 7;
+                int day = (date.day - weekday + 7) % 7 + (date.week - 1) * 7;
+
+                while (day >= length)
+                {
+                    day -= 7;
+                }
+
+                return first + day;
+            }
+        }
+
+        return jan1;
+    }
+
+    static local_info lookup_rule(const rule& r, long timestamp)
+    {
+        local_info info;
+
+        info.dst = false;
+        if (r.has_dst)
+        {
+            long days;
+            long seconds;
+            long year;
+            int month;
+            int day;
+            long start;
+            long end;
+
+            split_timestamp(timestamp + r.std_offset, days, seconds);
+            civil_from_days(days, year, month, day);
+            start = rule_day(r.start, year) * seconds_per_civil_day
+                + r.start.time - r.std_offset;
+            end = rule_day(r.end, year) * seconds_per_civil_day
+                + r.end.time - r.dst_offset;
+            if (start < end)
+            {
+                info.dst = timestamp >= start && timestamp < end;
+            } else {
+                info.dst = timestamp < end || timestamp >= start;
+            }
+        }
+        if (info.dst)
+        {
+            info.offset = r.dst_offset;
+            info.abbreviation = r.dst_abbreviation.c_str();
+        } else {
+            info.offset = r.std_offset;
+            info.abbreviation = r.std_abbreviation.c_str();
+        }
+
+        return info;
+    }
+
+    static local_info lookup(const time_zone::data& zone, long timestamp)
+    {
+        const std::size_t count = zone.transitions.size();
+        local_info info;
+        std::size_t type = 0;
+
+        if (zone.has_rule && (!count || timestamp >= zone.transitions[count - 1]))
+        {
+            return lookup_rule(zone.footer, timestamp);
+        }
+        if (count && timestamp >= zone.transitions[0])
+        {
+            type = zone.indices[find_transition(zone.transitions, timestamp)];
+        }
+        info.offset = zone.types[type].offset;
+        info.dst = zone.types[type].dst;
+        info.abbreviation = zone.abbreviations.c_str()
+            + zone.types[type].abbreviation;
+
+        return info;
+    }
+
+    static bool parse_abbreviation(const char*& p, std::string& result)
+    {
+        const char* begin;
+
+        if (*p == '<')
+        {
+            begin = ++p;
+            while (*p && *p != '>')
+            {
+                ++p;
+            }
+            if (*p != '>')
+            {
+                return false;
+            }
+            result.assign(begin, p++);
+        } else {
+            begin = p;
+            while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'))
+            {
+                ++p;
+            }
+            result.assign(begin, p);
+        }
+
+        return result.size() >= 3;
+    }
+
+    static bool parse_number(const char*& p, long max, long& result)
+    {
+        if (*p < '0' || *p > '9')
+        {
+            return false;
+        }
+        result = 0;
+        while (*p >= '0' && *p <= '9')
+        {
+            result = result * 10 + (*p++ - '0');
+            if (result > max)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Parses signed "hh[:mm[:ss]]" value into seconds.
+     */
+    static bool parse_time(const char*& p, long& result)
+    {
+        long sign = 1;
+        long hours;
+        long minutes = 0;
+        long seconds = 0;
+
+        if (*p == '+' || *p == '-')
+        {
+            sign = *p++ == '-' ? -1 : 1;
+        }
+        if (!parse_number(p, 167, hours))
+        {
+            return false;
+        }
+        if (*p == ':')
+        {
+            ++p;
+            if (!parse_number(p, 59, minutes))
+            {
+                return false;
+            }
+            if (*p == ':')
+            {
+                ++p;
+                if (!parse_number(p, 59, seconds))
+                {
+                    return false;
+                }
+            }
+        }
+        result = sign * (hours * 3600 + minutes * 60 + seconds);
+
+        return true;
+    }
+
+    static bool parse_rule_date(const char*& p, rule_date& date)
+    {
+        long value;
+
+        date.time = 7200;
+        if (*p == 'M')
+        {
+            long week;
+            long day;
+
+            ++p;
+            if (!parse_number(p, 12, value) || value < 1 || *p++ != '.'
+                || !parse_number(p, 5, week) || week < 1 || *p++ != '.'
+                || !parse_number(p, 6, day))
+            {
+                return false;
+            }
+            date.type = rule_date::month_week_day;
+            date.month = static_cast<int>(value);
+            date.week = static_cast<int>(week);
+            date.day = static_cast<int>(day);
+        }
+        else if (*p == 'J')
+        {
+            ++p;
+            if (!parse_number(p, 365, value) || value < 1)
+            {
+                return false;
+            }
+            date.type = rule_date::julian;
+            date.day = static_cast<int>(value);
+        } else {
+            if (!parse_number(p, 365, value))
+            {
+                return false;
+            }
+            date.type = rule_date::zero_based;
+            date.day = static_cast<int>(value);
+        }
+        if (*p == '/')
+        {
+            ++p;
+
+            return parse_time(p, date.time);
+        }
+
+        return true;
+    }
+
+    static bool parse_rule(const char* p, rule& r)
+    {
+        long offset;
+
+        if (!parse_abbreviation(p, r.std_abbreviation) || !parse_time(p, offset))
+        {
+            return false;
+        }
+        // POSIX offsets are positive west of Greenwich.
+        r.std_offset = -offset;
+        r.has_dst = *p != '\0';
+        if (!r.has_dst)
+        {
+            return true;
+        }
+        if (!parse_abbreviation(p, r.dst_abbreviation))
+        {
+            return false;
+        }
+        r.dst_offset = r.std_offset + 3600;
+        if (*p && *p != ',')
+        {
+            if (!parse_time(p, offset))
+            {
+                return false;
+            }
+            r.dst_offset = -offset;
+        }
+        if (!*p)
+        {
+            // Default to the rules of the United States.
+            const char* defaults = "M3.2.0,M11.1.0";
+
+            return parse_rule_date(defaults, r.start)
+                && *defaults++ == ','
+                && parse_rule_date(defaults, r.end);
+        }
+
+        return *p++ == ','
+            && parse_rule_date(p, r.start)
+            && *p++ == ','
+            && parse_rule_date(p, r.end)
+            && !*p;
+    }
+}
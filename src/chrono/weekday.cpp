@@ -122,75 +122,67 @@ namespace peelo
         return weekday(index);
     }
 
-    std::ostream& operator<<(std::ostream& os, const weekday& w)
+    int weekday::days_until(const weekday& that) const
     {
-        switch (w.index())
-        {
-            case 1:
-                os << "Monday";
-                break;
-
-            case 2:
-                os << "Tuesday";
-                break;
-
-            case 3:
-                os << "Wednesday";
-                break;
-
-            case 4:
-                os << "Thursday";
-                break;
-
-            case 5:
-                os << "Friday";
-                break;
+        return (that.m_index - m_index + 7) % 7;
+    }
 
-            case 6:
-                os << "Saturday";
-                break;
+    weekday weekday::operator+(int days) const
+    {
+        int index = (m_index - 1 + days) % 7;
 
-            case 7:
-                os << "Sunday";
-                break;
+        if (index < 0)
+        {
+            index += 7;
         }
 
-        return os;
+        return weekday(index + 1);
     }
 
-    std::wostream& operator<<(std::wostream& os, const weekday& w)
+    weekday weekday::operator-(int days) const
     {
-        switch (w.index())
-        {
-            case 1:
-                os << L"Monday";
-                break;
-
-            case 2:
-                os << L"Tuesday";
-                break;
-
-            case 3:
-                os << L"Wednesday";
-                break;
-
-            case 4:
-                os << L"Thursday";
-                break;
+        return *this + -(days % 7);
+    }
 
-            case 5:
-                os << L"Friday";
-                break;
+    static const char* const weekday_names[7] =
+    {
+        "Monday",
+        "Tuesday",
+        "Wednesday",
+        "Thursday",
+        "Friday",
+        "Saturday",
+        "Sunday"
+    };
+
+    static const char* const weekday_abbreviations[7] =
+    {
+        "Mon",
+        "Tue",
+        "Wed",
+        "Thu",
+        "Fri",
+        "Sat",
+        "Sun"
+    };
+
+    const char* weekday::name() const
+    {
+        return weekday_names[m_index - 1];
+    }
 
-            case 6:
-                os << L"Saturday";
-                break;
+    const char* weekday::abbreviation() const
+    {
+        return weekday_abbreviations[m_index - 1];
+    }
 
-            case 7:
-                os << L"Sunday";
-                break;
-        }
+    std::ostream& operator<<(std::ostream& os, const weekday& w)
+    {
+        return os << w.name();
+    }
 
-        return os;
+    std::wostream& operator<<(std::wostream& os, const weekday& w)
+    {
+        return os << w.name();
     }
 }
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/io/async_file.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace peelo
+{
+    struct async_file::state
+    {
+        state()
+            : pending(0) {}
+
+        void begin(std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            pending += count;
+        }
+
+        void finish()
+        {
+            cancel(1);
+        }
+
+        /**
+         * Forgets operations which were counted by begin() but were never
+         * submitted.
+         */
+        void cancel(std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            pending -= count;
+            if (!pending)
+            {
+                idle.notify_all();
+            }
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (pending)
+            {
+                idle.wait(lock);
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::size_t pending;
+    };
+
+    static io_queue::native_handle open_file(const filename& file, int mode)
+    {
+#if defined(_WIN32)
+        DWORD access = 0;
+        DWORD disposition;
+        HANDLE handle;
+
+        if (mode & async_file::in)
+        {
+            access |= GENERIC_READ;
+        }
+        if (mode & async_file::out)
+        {
+            access |= GENERIC_WRITE;
+        }
+        if (mode & async_file::create)
+        {
+            disposition = mode & async_file::truncate ? CREATE_ALWAYS
+                                                      : OPEN_ALWAYS;
+        } else {
+            disposition = mode & async_file::truncate ? TRUNCATE_EXISTING
+                                                      : OPEN_EXISTING;
+        }
+        handle = ::CreateFileW(file.file().widen().data(),
+                               access,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE,
+                               NULL,
+                               disposition,
+                               FILE_ATTRIBUTE_NORMAL,
+                               NULL);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("unable to open file");
+        }
+
+        return reinterpret_cast<io_queue::native_handle>(handle);
+#else
+        int flags;
+        int fd;
+
+        if ((mode & async_file::in) && (mode & async_file::out))
+        {
+            flags = O_RDWR;
+        }
+        else if (mode & async_file::out)
+        {
+            flags = O_WRONLY;
+        } else {
+            flags = O_RDONLY;
+        }
+        if (mode & async_file::create)
+        {
+            flags |= O_CREAT;
+        }
+        if (mode & async_file::truncate)
+        {
+            flags |= O_TRUNC;
+        }
+# if defined(O_CLOEXEC)
+        flags |= O_CLOEXEC;
+# endif
+        if ((fd = ::open(file.c_str(), flags, 0666)) < 0)
+        {
+            throw std::runtime_error("unable to open file");
+        }
+
+        return fd;
+#endif
+    }
+
+    async_file::async_file(io_queue& queue, const filename& file, int mode)
+        : m_queue(queue)
+        , m_filename(file)
+        , m_handle(open_file(file, mode))
+        , m_state(new state()) {}
+
+    async_file::~async_file()
+    {
+        m_state->wait();
+#if defined(_WIN32)
+        ::CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+#else
+        ::close(static_cast<int>(m_handle));
+#endif
+    }
+
+    uint64_t async_file::size() const
+    {
+#if defined(_WIN32)
+        LARGE_INTEGER size;
+
+        if (!::GetFileSizeEx(reinterpret_cast<HANDLE>(m_handle), &size))
+        {
+            return 0;
+        }
+
+        return static_cast<uint64_t>(size.QuadPart);
+#else
+        struct stat st;
+
+        if (::fstat(static_cast<int>(m_handle), &st) < 0)
+        {
+            return 0;
+        }
+
+        return static_cast<uint64_t>(st.st_size);
+#endif
+    }
+
+    void async_file::read(void* buffer,
+                          std::size_t size,
+                          uint64_t offset,
+                          const callback& done)
+    {
+        const segment s = { buffer, size, offset, -1 };
+
+        submit(false, &s, 1, [done](std::size_t, long result)
+        {
+            if (done)
+            {
+                done(result);
+            }
+        });
+    }
+
+    std::future<long> async_file::read(void* buffer,
+                                       std::size_t size,
+                                       uint64_t offset)
+    {
+        const std::shared_ptr<std::promise<long> > promise(
+                new std::promise<long>()
+        );
+        std::future<long> result = promise->get_future();
+
+        read(buffer, size, offset, [promise](long n)
+        {
+            promise->set_value(n);
+        });
+
+        return result;
+    }
+
+    void async_file::read(const segment* segments,
+                          std::size_t count,
+                          const batch_callback& done)
+    {
+        submit(false, segments, count, done);
+    }
+
+    void async_file::write(const void* buffer,
+                           std::size_t size,
+                           uint64_t offset,
+                           const callback& done)
+    {
+        const segment s = { const_cast<void*>(buffer), size, offset, -1 };
+
+        submit(true, &s, 1, [done](std::size_t, long result)
+        {
+            if (done)
+            {
+                done(result);
+            }
+        });
+    }
+
+    std::future<long> async_file::write(const void* buffer,
+                                        std::size_t size,
+                                        uint64_t offset)
+    {
+        const std::shared_ptr<std::promise<long> > promise(
+                new std::promise<long>()
+        );
+        std::future<long> result = promise->get_future();
+
+        write(buffer, size, offset, [promise](long n)
+        {
+            promise->set_value(n);
+        });
+
+        return result;
+    }
+
+    void async_file::write(const segment* segments,
+                           std::size_t count,
+                           const batch_callback& done)
+    {
+        submit(true, segments, count, done);
+    }
+
+    void async_file::wait() const
+    {
+        m_state->wait();
+    }
+
+    void async_file::submit(bool write,
+                            const segment* segments,
+                            std::size_t count,
+                            const batch_callback& done)
+    {
+        const std::shared_ptr<state> s(m_state);
+        std::vector<io_queue::request> requests(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            io_queue::request& r = requests[i];
+
+            r.write = write;
+            r.handle = m_handle;
+            r.buffer = segments[i].buffer;
+            r.size = segments[i].size;
+            r.offset = segments[i].offset;
+            r.buffer_index = segments[i].buffer_index;
+            r.done = [s, done, i](long result)
+            {
+                if (done)
+                {
+                    done(i, result);
+                }
+                s->finish();
+            };
+        }
+        m_state->begin(count);
+        try
+        {
+            m_queue.submit(requests.data(), count);
+        }
+        catch (...)
+        {
+            // The queue accepts either all of the requests or none.
+            m_state->cancel(count);
+            throw;
+        }
+    }
+}
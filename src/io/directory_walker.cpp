@@ -0,0 +1,691 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/io/directory_walker.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <dirent.h>
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# if defined(__linux__)
+#  include <sys/syscall.h>
+#  define PEELO_DIRECTORY_WALKER_GETDENTS 1
+# endif
+#endif
+
+namespace peelo
+{
+    namespace
+    {
+        /** Size of the buffer into which directory entries are read. */
+        const std::size_t listing_buffer_size = 64 * 1024;
+
+#if defined(_WIN32)
+        const char path_separator = '\\';
+#else
+        const char path_separator = '/';
+
+# if defined(O_CLOEXEC)
+        const int open_flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+# else
+        const int open_flags = O_RDONLY | O_DIRECTORY;
+# endif
+
+# if defined(PEELO_DIRECTORY_WALKER_GETDENTS)
+        /**
+         * Entry format returned by getdents64 system call.
+         */
+        struct linux_dirent64
+        {
+            uint64_t d_ino;
+            int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[1];
+        };
+# endif
+
+        /**
+         * Open directory descriptor, shared by all subdirectories of the
+         * directory so that they can be opened relative to it.
+         */
+        struct directory_handle
+        {
+            explicit directory_handle(int descriptor)
+                : fd(descriptor) {}
+
+            ~directory_handle()
+            {
+                ::close(fd);
+            }
+
+            const int fd;
+        };
+#endif
+
+        /**
+         * Directory waiting to be traversed.
+         */
+        struct work_item
+        {
+            /** UTF-8 encoded path of the directory. */
+            std::string path;
+#if !defined(_WIN32)
+            /** Parent directory, or null for the root directory. */
+            std::shared_ptr<directory_handle> parent;
+            /** Offset of the directory name in the path. */
+            std::size_t name_offset;
+#endif
+        };
+
+        /**
+         * Double ended queue of directories owned by one thread. The owner
+         * takes directories from the back, so that each thread proceeds
+         * depth first, while other threads steal from the front where the
+         * larger subtrees are.
+         */
+        struct work_queue
+        {
+            std::mutex mutex;
+            std::deque<work_item> items;
+        };
+
+        class traversal
+        {
+        public:
+            traversal(const directory_walker::visitor& v,
+                      const directory_walker::predicate& prune,
+                      bool follow_symlinks,
+                      unsigned threads)
+                : m_visitor(v)
+                , m_prune(prune)
+                , m_follow_symlinks(follow_symlinks)
+                , m_pending(0)
+                , m_queued(0)
+                , m_sleeping(0)
+                , m_failed(false)
+            {
+                for (unsigned i = 0; i < threads; ++i)
+                {
+                    m_queues.push_back(
+                            std::unique_ptr<work_queue>(new work_queue())
+                    );
+                }
+            }
+
+            void run(const filename& root)
+            {
+                std::vector<char> buffer(listing_buffer_size);
+                std::vector<std::thread> workers;
+                work_item item;
+
+                item.path.assign(root.c_str());
+#if !defined(_WIN32)
+                item.name_offset = 0;
+                {
+                    const int fd = ::open(item.path.c_str(), open_flags);
+
+                    if (fd < 0)
+                    {
+                        throw std::runtime_error("unable to open directory");
+                    }
+                    process(0, item, fd, buffer);
+                }
+#else
+                if (!process(0, item, buffer))
+                {
+                    throw std::runtime_error("unable to open directory");
+                }
+#endif
+                for (std::size_t i = 1; i < m_queues.size(); ++i)
+                {
+                    workers.push_back(std::thread(
+                                &traversal::work,
+                                this,
+                                static_cast<unsigned>(i)
+                    ));
+                }
+                work(0);
+                for (std::size_t i = 0; i < workers.size(); ++i)
+                {
+                    workers[i].join();
+                }
+                if (m_error)
+                {
+                    std::rethrow_exception(m_error);
+                }
+            }
+
+        private:
+            void work(unsigned index)
+            {
+                std::vector<char> buffer(listing_buffer_size);
+                work_item item;
+
+                while (!m_failed.load(std::memory_order_relaxed))
+                {
+                    if (!take(index, item))
+                    {
+                        if (!wait())
+                        {
+                            return;
+                        }
+                        continue;
+                    }
+                    try
+                    {
+#if defined(_WIN32)
+                        process(index, item, buffer);
+#else
+                        const int fd = item.parent
+                            ? ::openat(
+                                    item.parent->fd,
+                                    item.path.c_str() + item.name_offset,
+                                    open_flags
+                            )
+                            : ::open(item.path.c_str(), open_flags);
+
+                        // Release the parent as soon as possible, so that
+                        // the number of open descriptors stays low.
+                        item.parent.reset();
+                        if (fd >= 0)
+                        {
+                            process(index, item, fd, buffer);
+                        }
+#endif
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(m_error_mutex);
+
+                        if (!m_error)
+                        {
+                            m_error = std::current_exception();
+                        }
+                        m_failed.store(true);
+                        wake_all();
+                    }
+                    if (!--m_pending)
+                    {
+                        wake_all();
+                    }
+                }
+            }
+
+            /**
+             * Puts an idle thread to sleep until a directory is queued or
+             * the traversal ends. Returns <code>false</code> if the
+             * traversal has ended.
+             */
+            bool wait()
+            {
+                std::unique_lock<std::mutex> lock(m_idle_mutex);
+
+                // Announced before checking for queued directories, so that
+                // either this thread sees the directory or push() sees the
+                // sleeper and takes the lock to wake it.
+                ++m_sleeping;
+                while (!m_queued.load() && m_pending.load() && !m_failed.load())
+                {
+                    m_idle.wait(lock);
+                }
+                --m_sleeping;
+
+                return m_pending.load() && !m_failed.load();
+            }
+
+            void wake_all()
+            {
+                std::lock_guard<std::mutex> lock(m_idle_mutex);
+
+                m_idle.notify_all();
+            }
+
+            /**
+             * Takes next directory from the queue of given thread, or steals
+             * one from other threads if the own queue is empty.
+             */
+            bool take(unsigned index, work_item& item)
+            {
+                const std::size_t count = m_queues.size();
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    work_queue& queue = *m_queues[(index + i) % count];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+
+                    if (queue.items.empty())
+                    {
+                        continue;
+                    }
+                    if (i == 0)
+                    {
+                        item = std::move(queue.items.back());
+                        queue.items.pop_back();
+                    } else {
+                        item = std::move(queue.items.front());
+                        queue.items.pop_front();
+                    }
+                    --m_queued;
+
+                    return true;
+                }
+
+                return false;
+            }
+
+            void push(unsigned index, work_item& item)
+            {
+                work_queue& queue = *m_queues[index];
+
+                ++m_pending;
+                {
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+
+                    queue.items.push_back(std::move(item));
+                    ++m_queued;
+                }
+                if (m_sleeping.load())
+                {
+                    std::lock_guard<std::mutex> lock(m_idle_mutex);
+
+                    m_idle.notify_one();
+                }
+            }
+
+            /**
+             * Reports an entry to the visitor and schedules it for traversal
+             * if it is a directory which is not pruned.
+             */
+            template< class Directory >
+            void report(unsigned index,
+                        const work_item& parent,
+                        const filename& directory,
+                        const Directory& handle,
+                        const char* name,
+                        bool is_dir)
+            {
+                const directory_walker::entry e(directory, name, is_dir);
+                work_item item;
+
+                m_visitor(e);
+                if (!is_dir || (m_prune && m_prune(e)))
+                {
+                    return;
+                }
+                item.path.reserve(parent.path.length() + 1 + std::strlen(name));
+                item.path.assign(parent.path);
+                if (!item.path.empty()
+                    && item.path[item.path.length() - 1] != path_separator)
+                {
+                    item.path.push_back(path_separator);
+                }
+#if !defined(_WIN32)
+                item.parent = handle;
+                item.name_offset = item.path.length();
+#else
+                (void) handle;
+#endif
+                item.path.append(name);
+                push(index, item);
+            }
+
+#if defined(_WIN32)
+            /**
+             * Reads contents of a directory. Reparse points are never
+             * traversed, as their targets cannot be identified cheaply for
+             * loop detection.
+             */
+            bool process(unsigned index,
+                         const work_item& item,
+                         std::vector<char>& buffer)
+            {
+                const string path = string(item.path.c_str());
+                const filename directory(path);
+                const vector<wchar_t> pattern = (path + "\\*").widen();
+                WIN32_FIND_DATAW data;
+                HANDLE handle = ::FindFirstFileExW(
+                        pattern.data(),
+                        FindExInfoBasic,
+                        &data,
+                        FindExSearchNameMatch,
+                        NULL,
+                        FIND_FIRST_EX_LARGE_FETCH
+                );
+
+                if (handle == INVALID_HANDLE_VALUE)
+                {
+                    return false;
+                }
+                do
+                {
+                    const wchar_t* name = data.cFileName;
+
+                    if (name[0] == L'.'
+                        && (!name[1] || (name[1] == L'.' && !name[2])))
+                    {
+                        continue;
+                    }
+                    if (!::WideCharToMultiByte(CP_UTF8,
+                                               0,
+                                               name,
+                                               -1,
+                                               buffer.data(),
+                                               static_cast<int>(buffer.size()),
+                                               NULL,
+                                               NULL))
+                    {
+                        continue;
+                    }
+                    report(
+                            index,
+                            item,
+                            directory,
+                            handle,
+                            buffer.data(),
+                            (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                            && !(data.dwFileAttributes
+                                & FILE_ATTRIBUTE_REPARSE_POINT)
+                    );
+                }
+                while (::FindNextFileW(handle, &data));
+                ::FindClose(handle);
+
+                return true;
+            }
+#else
+            /**
+             * Returns <code>false</code> if the directory has already been
+             * visited through another symbolic link.
+             */
+            bool enter(int fd)
+            {
+                struct stat st;
+
+                if (::fstat(fd, &st) < 0)
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> lock(m_visited_mutex);
+
+                return m_visited.insert(std::make_pair(
+                            static_cast<uint64_t>(st.st_dev),
+                            static_cast<uint64_t>(st.st_ino)
+                )).second;
+            }
+
+            /**
+             * Determines whether an entry is a directory. The type given by
+             * the directory listing is used when available, so that the
+             * entry does not have to be queried separately.
+             */
+            bool is_directory(int fd, const char* name, unsigned char type)
+            {
+                struct stat st;
+
+# if defined(DT_DIR)
+                if (type == DT_DIR)
+                {
+                    return true;
+                }
+                else if (type != DT_UNKNOWN
+                        && (type != DT_LNK || !m_follow_symlinks))
+                {
+                    return false;
+                }
+# else
+                (void) type;
+# endif
+                if (::fstatat(fd,
+                              name,
+                              &st,
+                              m_follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) < 0)
+                {
+                    return false;
+                }
+
+                return S_ISDIR(st.st_mode);
+            }
+
+            void process(unsigned index,
+                         const work_item& item,
+                         int fd,
+                         std::vector<char>& buffer)
+            {
+                const std::shared_ptr<directory_handle> handle(
+                        new directory_handle(fd)
+                );
+
+                if (m_follow_symlinks && !enter(fd))
+                {
+                    return;
+                }
+
+                const filename directory(string(item.path.c_str()));
+# if defined(PEELO_DIRECTORY_WALKER_GETDENTS)
+                for (;;)
+                {
+                    const long size = ::syscall(
+                            SYS_getdents64,
+                            fd,
+                            buffer.data(),
+                            buffer.size()
+                    );
+
+                    if (size <= 0)
+                    {
+                        break;
+                    }
+                    for (long offset = 0; offset < size;)
+                    {
+                        const linux_dirent64* e =
+                            reinterpret_cast<const linux_dirent64*>(
+                                    buffer.data() + offset
+                            );
+                        const char* name = e->d_name;
+
+                        offset += e->d_reclen;
+                        if (name[0] == '.'
+                            && (!name[1] || (name[1] == '.' && !name[2])))
+                        {
+                            continue;
+                        }
+                        report(
+                                index,
+                                item,
+                                directory,
+                                handle,
+                                name,
+                                is_directory(fd, name, e->d_type)
+                        );
+                    }
+                }
+# else
+                const int copy = ::dup(fd);
+                DIR* dir;
+                struct dirent* e;
+
+                (void) buffer;
+                if (copy < 0)
+                {
+                    return;
+                }
+                else if (!(dir = ::fdopendir(copy)))
+                {
+                    ::close(copy);
+                    return;
+                }
+                while ((e = ::readdir(dir)))
+                {
+                    const char* name = e->d_name;
+
+                    if (name[0] == '.'
+                        && (!name[1] || (name[1] == '.' && !name[2])))
+                    {
+                        continue;
+                    }
+#  if defined(DT_DIR)
+                    const unsigned char type = e->d_type;
+#  else
+                    const unsigned char type = 0;
+#  endif
+                    report(
+                            index,
+                            item,
+                            directory,
+                            handle,
+                            name,
+                            is_directory(fd, name, type)
+                    );
+                }
+                ::closedir(dir);
+# endif
+            }
+#endif
+
+        private:
+            const directory_walker::visitor& m_visitor;
+            const directory_walker::predicate& m_prune;
+            const bool m_follow_symlinks;
+            std::vector<std::unique_ptr<work_queue> > m_queues;
+            /** Number of directories queued or being processed. */
+            std::atomic<std::size_t> m_pending;
+            /** Number of directories queued but not yet taken. */
+            std::atomic<std::size_t> m_queued;
+            /** Number of threads sleeping in wait(). */
+            std::atomic<unsigned> m_sleeping;
+            /** Idle threads sleep on this until there is work. */
+            std::condition_variable m_idle;
+            std::mutex m_idle_mutex;
+            std::atomic<bool> m_failed;
+            std::exception_ptr m_error;
+            std::mutex m_error_mutex;
+            std::set<std::pair<uint64_t, uint64_t> > m_visited;
+            std::mutex m_visited_mutex;
+        };
+    }
+
+    directory_walker::entry::entry(const filename& directory,
+                                   const char* name,
+                                   bool is_dir)
+        : m_directory(directory)
+        , m_name(name)
+        , m_is_directory(is_dir)
+        , m_file_valid(false) {}
+
+    const filename& directory_walker::entry::file() const
+    {
+        if (!m_file_valid)
+        {
+            m_file = filename(m_directory, string(m_name));
+            m_file_valid = true;
+        }
+
+        return m_file;
+    }
+
+    directory_walker::directory_walker(const filename& root)
+        : m_root(root)
+        , m_follow_symlinks(false)
+        , m_threads(1) {}
+
+    directory_walker::directory_walker(const directory_walker& that)
+        : m_root(that.m_root)
+        , m_prune(that.m_prune)
+        , m_follow_symlinks(that.m_follow_symlinks)
+        , m_threads(that.m_threads) {}
+
+    void directory_walker::set_prune(const predicate& prune)
+    {
+        m_prune = prune;
+    }
+
+    void directory_walker::set_follow_symlinks(bool follow)
+    {
+        m_follow_symlinks = follow;
+    }
+
+    void directory_walker::set_threads(unsigned threads)
+    {
+        if (!threads && !(threads = std::thread::hardware_concurrency()))
+        {
+            threads = 1;
+        }
+        m_threads = threads;
+    }
+
+    void directory_walker::walk(const visitor& v) const
+    {
+        traversal(v, m_prune, m_follow_symlinks, m_threads).run(m_root);
+    }
+
+    vector<filename> directory_walker::list() const
+    {
+        vector<filename> result;
+        std::mutex mutex;
+
+        walk([&result, &mutex](const entry& e)
+        {
+            const filename& file = e.file();
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // The vector would otherwise grow one element at a time.
+            if (result.size() == result.capacity())
+            {
+                result.reserve(result.capacity() ? result.capacity() * 2 : 64);
+            }
+            result.push_back(file);
+        });
+
+        return result;
+    }
+
+    directory_walker& directory_walker::assign(const directory_walker& that)
+    {
+        m_root.assign(that.m_root);
+        m_prune = that.m_prune;
+        m_follow_symlinks = that.m_follow_symlinks;
+        m_threads = that.m_threads;
+
+        return *this;
+    }
+}
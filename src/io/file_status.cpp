@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/io/file_status.hpp>
+
+namespace peelo
+{
+    file_status::file_status()
+        : m_type(type_none)
+        , m_symlink(false)
+        , m_sticky(false)
+        , m_size(0)
+        , m_inode(0) {}
+
+    file_status::file_status(const file_status& that)
+        : m_type(that.m_type)
+        , m_symlink(that.m_symlink)
+        , m_sticky(that.m_sticky)
+        , m_size(that.m_size)
+        , m_mtime(that.m_mtime)
+        , m_inode(that.m_inode) {}
+
+    file_status& file_status::assign(const file_status& that)
+    {
+        m_type = that.m_type;
+        m_symlink = that.m_symlink;
+        m_sticky = that.m_sticky;
+        m_size = that.m_size;
+        m_mtime = that.m_mtime;
+        m_inode = that.m_inode;
+
+        return *this;
+    }
+}
@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/chrono/steady_clock.hpp>
+#include <peelo/io/file_watcher.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+# include <poll.h>
+# include <sys/epoll.h>
+# include <sys/inotify.h>
+# include <sys/timerfd.h>
+# include <unistd.h>
+#endif
+
+namespace peelo
+{
+    namespace
+    {
+        struct watch_entry
+        {
+            filename file;
+            int changes;
+        };
+
+        struct pending_event
+        {
+            int changes;
+            /** When the event becomes deliverable, in nanoseconds. */
+            int64_t deadline;
+            /** Order in which files were first seen changing. */
+            uint64_t sequence;
+        };
+
+        typedef std::unordered_map<int, watch_entry> watch_map;
+        typedef std::unordered_map<filename, int, hash<filename> >
+            descriptor_map;
+        typedef std::unordered_map<filename, pending_event, hash<filename> >
+            pending_map;
+        typedef std::pair<uint64_t, file_watcher::event> ready_event;
+
+        struct by_sequence
+        {
+            bool operator()(const ready_event& a, const ready_event& b) const
+            {
+                return a.first < b.first;
+            }
+        };
+    }
+
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+    static uint32_t to_native_mask(int changes)
+    {
+        uint32_t mask = 0;
+
+        if (changes & file_watcher::created)
+        {
+            mask |= IN_CREATE | IN_MOVED_TO;
+        }
+        if (changes & file_watcher::modified)
+        {
+            mask |= IN_MODIFY;
+        }
+        if (changes & file_watcher::removed)
+        {
+            mask |= IN_DELETE | IN_DELETE_SELF | IN_MOVED_FROM | IN_MOVE_SELF;
+        }
+        if (changes & file_watcher::attributes)
+        {
+            mask |= IN_ATTRIB;
+        }
+
+        return mask;
+    }
+
+    static int from_native_mask(uint32_t mask)
+    {
+        int changes = 0;
+
+        if (mask & (IN_CREATE | IN_MOVED_TO))
+        {
+            changes |= file_watcher::created;
+        }
+        if (mask & IN_MODIFY)
+        {
+            changes |= file_watcher::modified;
+        }
+        if (mask & (IN_DELETE | IN_DELETE_SELF | IN_MOVED_FROM | IN_MOVE_SELF))
+        {
+            changes |= file_watcher::removed;
+        }
+        if (mask & IN_ATTRIB)
+        {
+            changes |= file_watcher::attributes;
+        }
+
+        return changes;
+    }
+#endif
+
+    struct file_watcher::state
+    {
+        state()
+            : fd(-1)
+            , timer_fd(-1)
+            , epoll_fd(-1)
+            , sequence(0) {}
+
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+        /**
+         * Reads everything the kernel has queued and merges it into pending
+         * events, which become deliverable at given time.
+         */
+        void read_events(int64_t deadline)
+        {
+            union
+            {
+                struct inotify_event event;
+                char data[16384];
+            } buffer;
+
+            for (;;)
+            {
+                const ssize_t length = ::read(fd,
+                                              buffer.data,
+                                              sizeof(buffer.data));
+
+                if (length < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                else if (length <= 0)
+                {
+                    return;
+                }
+                for (ssize_t offset = 0; offset < length;)
+                {
+                    const struct inotify_event* e =
+                        reinterpret_cast<const struct inotify_event*>(
+                            buffer.data + offset
+                        );
+                    watch_map::iterator entry;
+                    int changes;
+
+                    offset += sizeof(struct inotify_event) + e->len;
+                    if ((entry = watches.find(e->wd)) == watches.end())
+                    {
+                        continue;
+                    }
+                    if (e->mask & IN_IGNORED)
+                    {
+                        // Watched file was removed or the watch was dropped.
+                        descriptors.erase(entry->second.file);
+                        watches.erase(entry);
+                        continue;
+                    }
+                    if (!(changes = from_native_mask(e->mask)
+                                & entry->second.changes))
+                    {
+                        continue;
+                    }
+
+                    const filename file = e->len > 0
+                        ? filename(entry->second.file, string(e->name))
+                        : entry->second.file;
+                    pending_map::iterator i = pending.find(file);
+
+                    if (i == pending.end())
+                    {
+                        const pending_event p = {
+                            changes,
+                            deadline,
+                            sequence++
+                        };
+
+                        pending.insert(std::make_pair(file, p));
+                    } else {
+                        i->second.changes |= changes;
+                        i->second.deadline = deadline;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Arms the timer to expire when the earliest pending event becomes
+         * deliverable, or disarms it when nothing is pending. Expirations
+         * which have already happened are consumed first, so that the
+         * descriptor of the watcher does not stay readable.
+         */
+        void arm_timer(int64_t now)
+        {
+            struct itimerspec spec = {};
+            uint64_t expirations;
+            int64_t wait = -1;
+
+            while (::read(timer_fd, &expirations, sizeof(expirations)) < 0
+                   && errno == EINTR);
+            for (pending_map::const_iterator i = pending.begin();
+                 i != pending.end();
+                 ++i)
+            {
+                if (wait < 0 || i->second.deadline - now < wait)
+                {
+                    wait = i->second.deadline - now;
+                }
+            }
+            if (wait >= 0)
+            {
+                // Zero would disarm the timer, so an event which is already
+                // due expires after one nanosecond instead.
+                wait = std::max<int64_t>(wait, 1);
+                spec.it_value.tv_sec = static_cast<time_t>(wait / 1000000000);
+                spec.it_value.tv_nsec = static_cast<long>(wait % 1000000000);
+            }
+            ::timerfd_settime(timer_fd, 0, &spec, 0);
+        }
+#endif
+
+        /** The inotify instance. */
+        int fd;
+        /** Timer which expires when a pending event becomes deliverable. */
+        int timer_fd;
+        /** Watches both of the above; returned by file_watcher::fd(). */
+        int epoll_fd;
+        watch_map watches;
+        descriptor_map descriptors;
+        pending_map pending;
+        uint64_t sequence;
+    };
+
+    file_watcher::file_watcher(const duration& coalesce)
+        : m_coalesce(coalesce)
+        , m_state(new state())
+    {
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+        struct epoll_event event = {};
+
+        // Both timerfd and epoll are older than inotify_init1(), so they are
+        // available whenever it is.
+        if ((m_state->fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0)
+        {
+            throw std::runtime_error("unable to initialize inotify");
+        }
+        event.events = EPOLLIN;
+        if ((m_state->timer_fd = ::timerfd_create(
+                CLOCK_MONOTONIC,
+                TFD_NONBLOCK | TFD_CLOEXEC
+            )) < 0
+            || (m_state->epoll_fd = ::epoll_create1(EPOLL_CLOEXEC)) < 0
+            || ::epoll_ctl(m_state->epoll_fd,
+                           EPOLL_CTL_ADD,
+                           m_state->fd,
+                           &event) < 0
+            || ::epoll_ctl(m_state->epoll_fd,
+                           EPOLL_CTL_ADD,
+                           m_state->timer_fd,
+                           &event) < 0)
+        {
+            close();
+            throw std::runtime_error("unable to initialize file watcher");
+        }
+#else
+        throw std::runtime_error(
+            "file watching is not supported on this platform"
+        );
+#endif
+    }
+
+    file_watcher::~file_watcher()
+    {
+        close();
+    }
+
+    void file_watcher::close()
+    {
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+        const int fds[] = {
+            m_state->epoll_fd,
+            m_state->timer_fd,
+            m_state->fd
+        };
+
+        for (std::size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); ++i)
+        {
+            if (fds[i] >= 0)
+            {
+                ::close(fds[i]);
+            }
+        }
+#endif
+    }
+
+    int file_watcher::fd() const
+    {
+        return m_state->epoll_fd;
+    }
+
+    void file_watcher::watch(const filename& file, int changes)
+    {
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+        const int wd = ::inotify_add_watch(m_state->fd,
+                                           file.c_str(),
+                                           to_native_mask(changes));
+        watch_map::iterator entry;
+
+        if (wd < 0)
+        {
+            throw std::runtime_error("unable to watch file");
+        }
+        // The kernel returns existing watch descriptor when the same inode
+        // is watched through another name, in which case the new name
+        // replaces the old one.
+        entry = m_state->watches.find(wd);
+        if (entry != m_state->watches.end())
+        {
+            m_state->descriptors.erase(entry->second.file);
+            entry->second.file = file;
+            entry->second.changes = changes;
+        } else {
+            const watch_entry e = { file, changes };
+
+            m_state->watches.insert(std::make_pair(wd, e));
+        }
+        m_state->descriptors[file] = wd;
+#else
+        throw std::runtime_error(
+            "file watching is not supported on this platform"
+        );
+#endif
+    }
+
+    std::size_t file_watcher::watch(const filepath& path, int changes)
+    {
+        const vector<filename>& directories = path.directories();
+        std::size_t count = 0;
+
+        for (std::size_t i = 0; i < directories.size(); ++i)
+        {
+            if (directories[i].is_dir())
+            {
+                watch(directories[i], changes);
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    void file_watcher::unwatch(const filename& file)
+    {
+        descriptor_map::iterator entry;
+        pending_map::iterator i;
+
+        entry = m_state->descriptors.find(file);
+        if (entry == m_state->descriptors.end())
+        {
+            return;
+        }
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+        ::inotify_rm_watch(m_state->fd, entry->second);
+#endif
+        m_state->watches.erase(entry->second);
+        m_state->descriptors.erase(entry);
+        for (i = m_state->pending.begin(); i != m_state->pending.end();)
+        {
+            if (i->first == file || i->first.parent() == file)
+            {
+                i = m_state->pending.erase(i);
+            } else {
+                ++i;
+            }
+        }
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+        m_state->arm_timer(steady_clock::now().nanoseconds());
+#endif
+    }
+
+    bool file_watcher::is_watched(const filename& file) const
+    {
+        return m_state->descriptors.find(file) != m_state->descriptors.end();
+    }
+
+    bool file_watcher::has_pending() const
+    {
+        return !m_state->pending.empty();
+    }
+
+    std::size_t file_watcher::poll(const callback& cb, const duration& timeout)
+    {
+        const int64_t interval = m_coalesce.nanoseconds();
+        const int64_t end = steady_clock::now().nanoseconds()
+            + timeout.nanoseconds();
+
+        for (;;)
+        {
+            const int64_t now = steady_clock::now().nanoseconds();
+            std::vector<ready_event> ready;
+            pending_map::iterator i;
+            int64_t wait;
+
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+            m_state->read_events(now + interval);
+#endif
+            wait = end - now;
+            for (i = m_state->pending.begin(); i != m_state->pending.end();)
+            {
+                if (i->second.deadline <= now)
+                {
+                    const event e = { i->first, i->second.changes };
+
+                    ready.push_back(std::make_pair(i->second.sequence, e));
+                    i = m_state->pending.erase(i);
+                } else {
+                    wait = std::min(wait, i->second.deadline - now);
+                    ++i;
+                }
+            }
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+            if (!ready.empty() || wait <= 0)
+            {
+                m_state->arm_timer(now);
+            }
+#endif
+            if (!ready.empty())
+            {
+                std::sort(ready.begin(), ready.end(), by_sequence());
+                for (std::size_t j = 0; j < ready.size(); ++j)
+                {
+                    cb(ready[j].second);
+                }
+
+                return ready.size();
+            }
+            if (wait <= 0)
+            {
+                return 0;
+            }
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+            struct pollfd pfd;
+
+            pfd.fd = m_state->fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            ::poll(&pfd, 1, static_cast<int>((wait + 999999) / 1000000));
+#endif
+        }
+    }
+
+}
@@ -25,6 +25,8 @@
  */
 #include <peelo/io/filename.hpp>
 #include <peelo/text/stringbuilder.hpp>
+#include <stdexcept>
+#include <thread>
 #if defined(_WIN32)
 # define WIN32_LEAN_AND_MEAN
 # include <windows.h>
@@ -41,20 +43,116 @@ namespace peelo
     const rune filename::separator('/');
 #endif
 
-    static void parse(const string&, string&, string&, vector<string>&);
+    typedef small_vector<string, 8> path_type;
 
-    filename::filename() {}
+    namespace
+    {
+        /**
+         * Holds the spin lock protecting the cached native form and status
+         * of a file name. It is only held while the caches are read or
+         * written, never during system calls.
+         */
+        class cache_lock
+        {
+        public:
+            explicit cache_lock(std::atomic_flag& flag)
+                : m_flag(flag)
+            {
+                while (m_flag.test_and_set(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            ~cache_lock()
+            {
+                m_flag.clear(std::memory_order_release);
+            }
+
+        private:
+            cache_lock(const cache_lock&);
+            cache_lock& operator=(const cache_lock&);
+
+        private:
+            std::atomic_flag& m_flag;
+        };
+    }
+
+    static void parse(const string&, string&, string&, path_type&);
+    static bool append(const string&, bool, path_type&);
+    static string compile(const string&, const path_type&);
+
+    static inline bool is_dot(const string& s)
+    {
+        return s.length() == 1 && s[0] == '.';
+    }
+
+    static inline bool is_dot_dot(const string& s)
+    {
+        return s.length() == 2 && s[0] == '.' && s[1] == '.';
+    }
+
+    static inline bool same_component(const string& a, const string& b)
+    {
+#if defined(_WIN32)
+        return a.equals_icase(b);
+#else
+        return a.equals(b);
+#endif
+    }
+
+    filename::filename()
+        : m_status_valid(false)
+    {
+        m_cache_lock.clear();
+    }
 
     filename::filename(const filename& that)
         : m_filename(that.m_filename)
         , m_root(that.m_root)
-        , m_path(that.m_path) {}
+        , m_path(that.m_path)
+    {
+        cache_lock lock(that.m_cache_lock);
+
+        m_cache_lock.clear();
+        m_native = that.m_native;
+        m_status.assign(that.m_status);
+        m_status_valid = that.m_status_valid;
+    }
 
     filename::filename(const string& str)
+        : m_status_valid(false)
     {
+        m_cache_lock.clear();
         parse(str, m_filename, m_root, m_path);
     }
 
+    filename::filename(const string& file,
+                       const string& root,
+                       const path_type& path)
+        : m_filename(file)
+        , m_root(root)
+        , m_path(path)
+        , m_status_valid(false)
+    {
+        m_cache_lock.clear();
+    }
+
+    filename::filename(const filename& parent, const string& name)
+        : m_root(parent.m_root)
+        , m_path(parent.m_path)
+        , m_status_valid(false)
+    {
+        m_cache_lock.clear();
+        if (parent.empty() || is_separator(parent.m_filename.back()))
+        {
+            m_filename.assign(parent.m_filename.concat(name));
+        } else {
+            m_filename.assign(parent.m_filename.concat(separator).concat(name));
+        }
+        m_path.push_back(name);
+    }
+
     bool filename::is_separator(const rune& r)
     {
         return r == '/' || r == '\\';
@@ -70,6 +168,14 @@ namespace peelo
         m_filename.assign(that.m_filename);
         m_root.assign(that.m_root);
         m_path.assign(that.m_path);
+        if (this != &that)
+        {
+            cache_lock lock(that.m_cache_lock);
+
+            m_native.assign(that.m_native);
+            m_status.assign(that.m_status);
+            m_status_valid = that.m_status_valid;
+        }
 
         return *this;
     }
@@ -79,6 +185,8 @@ namespace peelo
         m_filename.clear();
         m_root.clear();
         m_path.clear();
+        m_native.reset();
+        m_status_valid = false;
         parse(str, m_filename, m_root, m_path);
 
         return *this;
@@ -102,166 +210,331 @@ namespace peelo
 #endif
     }
 
+    const char* filename::c_str() const
+    {
+        cache_lock lock(m_cache_lock);
+
+        // The buffer is never replaced once built, except by assignment,
+        // so the pointer stays valid after the lock is released.
+        if (!m_native)
+        {
+            m_native = ptr<vector<char> >(
+                    new vector<char>(m_filename.utf8())
+            );
+        }
+
+        return m_native->data();
+    }
+
     bool filename::is_absolute() const
     {
         return !m_root.empty();
     }
 
-    bool filename::is_file() const
+    filename filename::join(const filename& that) const
     {
-        if (empty())
+        path_type path(m_path);
+        bool verbatim = true;
+
+        if (empty() || that.is_absolute())
         {
-            return false;
+            return that;
         }
-#if defined(_WIN32)
-        return ::GetFileAttributesW(m_filename.widen().data())
-            == FILE_ATTRIBUTE_NORMAL;
-#else
-        struct stat st;
+        else if (that.empty())
+        {
+            return *this;
+        }
+        for (path_type::size_type i = 0; i < that.m_path.size(); ++i)
+        {
+            verbatim &= append(that.m_path[i], is_absolute(), path);
+        }
+        if (!verbatim || path.size() != m_path.size() + that.m_path.size())
+        {
+            if (path.empty() && !is_absolute())
+            {
+                path.push_back(".");
+            }
 
-        if (::stat(m_filename.utf8().data(), &st) < 0)
+            return filename(compile(m_root, path), m_root, path);
+        }
+        else if (is_separator(m_filename.back()))
         {
-            return false; // File does not exist
-        } else {
-            return S_ISREG(st.st_mode);
+            return filename(m_filename.concat(that.m_filename), m_root, path);
         }
-#endif
+
+        return filename(
+                m_filename.concat(separator).concat(that.m_filename),
+                m_root,
+                path
+        );
     }
 
-    bool filename::is_dir() const
+    filename filename::parent() const
     {
-        if (empty())
+        path_type path(m_path);
+
+        if (m_path.empty())
         {
-            return false;
+            return *this;
         }
-#if defined(_WIN32)
-        return ::GetFileAttributesW(m_filename.widen().data())
-            & FILE_ATTRIBUTE_DIRECTORY;
-#else
-        struct stat st;
-
-        if (::stat(m_filename.utf8().data(), &st) < 0)
+        path.erase(path.size() - 1);
+        if (path.empty())
         {
-            return false; // File does not exist
-        } else {
-            return S_ISDIR(st.st_mode);
+            return filename(m_root, m_root, path);
         }
-#endif
+
+        // Components are separated by exactly one separator, so the parent
+        // is a prefix of the full file name.
+        return filename(
+                m_filename.substr(
+                    0,
+                    m_filename.length() - m_path.back().length() - 1
+                ),
+                m_root,
+                path
+        );
     }
 
-    bool filename::is_pipe() const
+    filename filename::normalize() const
     {
-#if !defined(_WIN32) && defined(S_IFIFO)
-# if !defined(S_ISFIFO)
-#  define S_ISFIFO(x) (((x) & S_IFMT) == S_IFIFO)
-# endif
-        if (!empty())
-        {
-            struct stat st;
+        path_type path;
+        bool verbatim = true;
 
-            if (::stat(m_filename.utf8().data(), &st) >= 0)
-            {
-                return S_ISFIFO(st.st_mode);
-            }
+        for (path_type::size_type i = 0; i < m_path.size(); ++i)
+        {
+            verbatim &= append(m_path[i], is_absolute(), path);
+        }
+        if (verbatim)
+        {
+            return *this;
+        }
+        else if (path.empty() && !is_absolute())
+        {
+            path.push_back(".");
         }
-#endif
 
-        return false;
+        return filename(compile(m_root, path), m_root, path);
     }
 
-    bool filename::is_socket() const
+    filename filename::relative_to(const filename& base) const
     {
-#if !defined(_WIN32) && defined(S_ISSOCK)
-        if (!empty())
+        const filename a = normalize();
+        const filename b = base.normalize();
+        const path_type::size_type a_begin = a.m_path.size() == 1
+            && is_dot(a.m_path[0]);
+        const path_type::size_type b_begin = b.m_path.size() == 1
+            && is_dot(b.m_path[0]);
+        path_type::size_type common = 0;
+        path_type path;
+
+        if (!same_component(a.m_root, b.m_root))
         {
-            struct stat st;
-
-            if (::stat(m_filename.utf8().data(), &st) >= 0)
+            throw std::invalid_argument("file names have different roots");
+        }
+        while (a_begin + common < a.m_path.size()
+                && b_begin + common < b.m_path.size()
+                && same_component(a.m_path[a_begin + common],
+                                  b.m_path[b_begin + common]))
+        {
+            ++common;
+        }
+        for (path_type::size_type i = b_begin + common;
+             i < b.m_path.size();
+             ++i)
+        {
+            if (is_dot_dot(b.m_path[i]))
             {
-                return S_ISSOCK(st.st_mode);
+                throw std::invalid_argument(
+                        "base file name cannot be resolved lexically"
+                );
             }
+            path.push_back("..");
+        }
+        for (path_type::size_type i = a_begin + common;
+             i < a.m_path.size();
+             ++i)
+        {
+            path.push_back(a.m_path[i]);
+        }
+        if (path.empty())
+        {
+            path.push_back(".");
         }
-#endif
 
-        return false;
+        return filename(compile(string(), path), string(), path);
     }
 
-    bool filename::is_sticky() const
+    file_status filename::status() const
     {
-#if !defined(_WIN32) && defined(S_ISVTX)
-        if (!empty())
         {
-            struct stat st;
+            cache_lock lock(m_cache_lock);
 
-            if (::stat(m_filename.utf8().data(), &st) >= 0)
+            if (m_status_valid)
             {
-                return st.st_mode & S_ISVTX;
+                return m_status;
             }
         }
-#endif
 
-        return false;
+        return refresh();
     }
 
-    bool filename::is_symlink() const
+    file_status filename::refresh() const
     {
-#if !defined(_WIN32) && defined(S_ISLNK)
-        if (!empty())
+        file_status status;
+
+        // The file system is queried without holding the lock, so that
+        // concurrent queries of the same file name do not serialize.
+        query(status);
         {
-            struct stat st;
+            cache_lock lock(m_cache_lock);
 
-            if (::stat(m_filename.utf8().data(), &st) >= 0)
-            {
-                return S_ISLNK(st.st_mode);
-            }
+            m_status.assign(status);
+            m_status_valid = true;
         }
-#endif
 
-        return false;
+        return status;
     }
 
-    bool filename::exists() const
+    void filename::query(file_status& status) const
     {
         if (empty())
         {
-            return false;
+            return;
         }
 #if defined(_WIN32)
-        return ::GetFileAttributesW(m_filename.widen().data())
-            != INVALID_FILE_ATTRIBUTES;
+        WIN32_FILE_ATTRIBUTE_DATA data;
+
+        if (!::GetFileAttributesExW(m_filename.widen().data(),
+                                    GetFileExInfoStandard,
+                                    &data))
+        {
+            return;
+        }
+        status.m_type = data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY
+            ? file_status::type_dir
+            : file_status::type_file;
+        status.m_symlink = data.dwFileAttributes
+            & FILE_ATTRIBUTE_REPARSE_POINT;
+        status.m_size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32)
+            | data.nFileSizeLow;
+        // FILETIME counts 100 nanosecond intervals since 1601-01-01.
+        status.m_mtime = datetime64((
+                    ((static_cast<int64_t>(data.ftLastWriteTime.dwHighDateTime)
+                      << 32) | data.ftLastWriteTime.dwLowDateTime)
+                    - 116444736000000000LL
+        ) * 100);
 #else
-        return !::access(m_filename.utf8().data(), F_OK);
+        const char* path = c_str();
+        struct stat st;
+
+        // Symbolic links need second query for the file they point to, but
+        // for everything else lstat() already gives the final answer.
+        if (::lstat(path, &st) < 0)
+        {
+            return;
+        }
+        if (S_ISLNK(st.st_mode))
+        {
+            status.m_symlink = true;
+            if (::stat(path, &st) < 0)
+            {
+                return;
+            }
+        }
+        if (S_ISREG(st.st_mode))
+        {
+            status.m_type = file_status::type_file;
+        }
+        else if (S_ISDIR(st.st_mode))
+        {
+            status.m_type = file_status::type_dir;
+        }
+# if defined(S_ISFIFO)
+        else if (S_ISFIFO(st.st_mode))
+        {
+            status.m_type = file_status::type_pipe;
+        }
+# endif
+# if defined(S_ISSOCK)
+        else if (S_ISSOCK(st.st_mode))
+        {
+            status.m_type = file_status::type_socket;
+        }
+# endif
+        else
+        {
+            status.m_type = file_status::type_other;
+        }
+# if defined(S_ISVTX)
+        status.m_sticky = st.st_mode & S_ISVTX;
+# endif
+        status.m_size = static_cast<uint64_t>(st.st_size);
+        status.m_inode = static_cast<uint64_t>(st.st_ino);
+# if defined(__APPLE__)
+        status.m_mtime = datetime64(
+                static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000
+                + st.st_mtimespec.tv_nsec
+        );
+# else
+        status.m_mtime = datetime64(
+                static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000
+                + st.st_mtim.tv_nsec
+        );
+# endif
 #endif
     }
 
-    static void append(const string& input, vector<string>& path)
+    /**
+     * Appends component into a path, resolving <code>.</code> and
+     * <code>..</code> components lexically. Returns <code>true</code> if the
+     * component was simply added to the end of the path.
+     */
+    static bool append(const string& input, bool absolute, path_type& path)
     {
+        const bool lone_dot = path.size() == 1 && is_dot(path[0]);
+
         if (input.empty())
         {
-            return;
+            return false;
         }
-        else if (input[0] == '.')
+        else if (is_dot(input))
         {
-            if (input.length() == 2 && input[1] == '.')
+            // Single dot is kept only when it is the whole relative path.
+            if (path.empty() && !absolute)
             {
-                if (!path.empty())
-                {
-                    path.erase(path.size() - 1);
-                    return;
-                }
+                path.push_back(input);
+
+                return true;
             }
-            else if (input.length() == 1)
+
+            return false;
+        }
+        else if (is_dot_dot(input))
+        {
+            if (!path.empty() && !lone_dot && !is_dot_dot(path.back()))
             {
-                if (!path.empty())
-                {
-                    return;
-                }
+                path.erase(path.size() - 1);
+
+                return false;
+            }
+            else if (absolute)
+            {
+                // There is nothing above the root.
+                return false;
             }
         }
+        if (lone_dot)
+        {
+            path[0] = input;
+
+            return false;
+        }
         path.push_back(input);
+
+        return true;
     }
 
-    static string compile(const string& root, const vector<string>& path)
+    static string compile(const string& root, const path_type& path)
     {
         stringbuilder sb;
 
@@ -269,7 +542,7 @@ namespace peelo
         {
             sb << root;
         }
-        for (vector<string>::size_type i = 0; i < path.size(); ++i)
+        for (path_type::size_type i = 0; i < path.size(); ++i)
         {
             if (i > 0 && !filename::is_separator(sb.back()))
             {
@@ -284,7 +557,7 @@ namespace peelo
     static void parse(const string& source,
                       string& filename,
                       string& root,
-                      vector<string>& path)
+                      path_type& path)
     {
         string::size_type begin = 0;
         string::size_type end = 0;
@@ -327,7 +600,7 @@ namespace peelo
             {
                 if (end)
                 {
-                    append(source.substr(begin, end), path);
+                    append(source.substr(begin, end), !root.empty(), path);
                 }
                 begin = i + 1;
                 end = 0;
@@ -337,7 +610,12 @@ namespace peelo
         }
         if (end)
         {
-            append(source.substr(begin, end), path);
+            append(source.substr(begin, end), !root.empty(), path);
+        }
+        if (path.empty() && root.empty())
+        {
+            // Relative path where all components cancelled each other out.
+            path.push_back(".");
         }
         filename.assign(compile(root, path));
     }
@@ -24,10 +24,51 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <peelo/io/filepath.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <peelo/text/stringbuilder.hpp>
+# include <cstdlib>
+# include <windows.h>
+#else
+# include <dirent.h>
+# include <unistd.h>
+#endif
 
 namespace peelo
 {
-    static void parse(const string&, set<filename>&);
+    static void parse(const string&, set<filename>&, vector<filename>&);
+
+    /**
+     * Cached contents of a single directory.
+     */
+    struct directory_listing
+    {
+        directory_listing()
+            : loaded(false) {}
+
+        /** Whether the directory has been listed. */
+        bool loaded;
+        /** Modification time of the directory when it was listed. */
+        datetime64 mtime;
+        /** UTF-8 encoded names of the entries in the directory. */
+        std::unordered_set<std::string> names;
+    };
+
+    /**
+     * Listings of the directories in the file path, in declared order.
+     */
+    struct filepath::cache
+    {
+        explicit cache(std::size_t size)
+            : listings(size) {}
+
+        std::mutex mutex;
+        std::vector<directory_listing> listings;
+    };
 
 #if defined(_WIN32)
     const rune filepath::separator(';');
@@ -35,17 +76,26 @@ namespace peelo
     const rune filepath::separator(':');
 #endif
 
-    filepath::filepath() {}
+    filepath::filepath()
+    {
+        reset();
+    }
 
     filepath::filepath(const filepath& that)
-        : m_filenames(that.m_filenames) {}
+        : m_filenames(that.m_filenames)
+        , m_directories(that.m_directories)
+        , m_cache(that.m_cache) {}
 
     filepath::filepath(const set<filename>& filenames)
-        : m_filenames(filenames) {}
+        : m_filenames(filenames)
+    {
+        reset();
+    }
 
     filepath::filepath(const string& str)
     {
-        parse(str, m_filenames);
+        parse(str, m_filenames, m_directories);
+        reset();
     }
 
     bool filepath::is_separator(const rune& r)
@@ -56,6 +106,8 @@ namespace peelo
     filepath& filepath::assign(const filepath& that)
     {
         m_filenames = that.m_filenames;
+        m_directories = that.m_directories;
+        m_cache = that.m_cache;
 
         return *this;
     }
@@ -63,6 +115,8 @@ namespace peelo
     filepath& filepath::assign(const set<filename>& filenames)
     {
         m_filenames = filenames;
+        m_directories.clear();
+        reset();
 
         return *this;
     }
@@ -70,17 +124,248 @@ namespace peelo
     filepath& filepath::assign(const string& str)
     {
         m_filenames.clear();
-        parse(str, m_filenames);
+        m_directories.clear();
+        parse(str, m_filenames, m_directories);
+        reset();
 
         return *this;
     }
 
+    void filepath::reset()
+    {
+        if (m_directories.empty())
+        {
+            m_directories.reserve(m_filenames.size());
+            for (set<filename>::iterator i = m_filenames.begin();
+                 i != m_filenames.end();
+                 ++i)
+            {
+                m_directories.push_back(*i);
+            }
+        }
+        m_cache.reset(new cache(m_directories.size()));
+    }
+
+    /**
+     * Reads names of the entries in a directory.
+     */
+    static void list(const filename& directory,
+                     std::unordered_set<std::string>& names)
+    {
+        names.clear();
+#if defined(_WIN32)
+        const vector<wchar_t> pattern = (directory.file() + "\\*").widen();
+        WIN32_FIND_DATAW data;
+        HANDLE handle = ::FindFirstFileExW(
+                pattern.data(),
+                FindExInfoBasic,
+                &data,
+                FindExSearchNameMatch,
+                NULL,
+                FIND_FIRST_EX_LARGE_FETCH
+        );
+
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+        do
+        {
+            stringbuilder sb;
+
+            for (const wchar_t* p = data.cFileName; *p; ++p)
+            {
+                sb << static_cast<int>(*p);
+            }
+            // File names are case insensitive.
+            names.insert(sb.str().to_lower().utf8().data());
+        }
+        while (::FindNextFileW(handle, &data));
+        ::FindClose(handle);
+#else
+        DIR* dir = ::opendir(directory.c_str());
+        struct dirent* e;
+
+        if (!dir)
+        {
+            return;
+        }
+        while ((e = ::readdir(dir)))
+        {
+            names.insert(e->d_name);
+        }
+        ::closedir(dir);
+#endif
+    }
+
+    /**
+     * Tests whether given file exists and can be executed.
+     */
+    static bool is_executable(const filename& file)
+    {
+#if defined(_WIN32)
+        return file.is_file();
+#else
+        return file.is_file() && !::access(file.c_str(), X_OK);
+#endif
+    }
+
+    /**
+     * Returns names which are searched for a command. On Windows the
+     * command can be given without extension from PATHEXT.
+     */
+    static void candidates(const string& name, vector<string>& result)
+    {
+        result.push_back(name);
+#if defined(_WIN32)
+        const char* extensions = std::getenv("PATHEXT");
+        string::size_type begin = 0;
+        string list(extensions ? extensions : ".COM;.EXE;.BAT;.CMD");
+
+        for (string::size_type i = 0; i <= list.length(); ++i)
+        {
+            if (i == list.length() || list[i] == ';')
+            {
+                if (i > begin)
+                {
+                    result.push_back(name + list.substr(begin, i - begin));
+                }
+                begin = i + 1;
+            }
+        }
+#endif
+    }
+
+    /**
+     * Searches the directories with the cache already locked. When
+     * <i>validate</i> is false, listings which have already been checked
+     * during the same batch are trusted as they are.
+     */
+    static filename search(const vector<filename>& directories,
+                           std::vector<directory_listing>& listings,
+                           std::vector<bool>& validated,
+                           const string& name)
+    {
+        vector<string> names;
+
+        candidates(name, names);
+        for (vector<filename>::size_type i = 0; i < directories.size(); ++i)
+        {
+            directory_listing& listing = listings[i];
+
+            if (!validated[i])
+            {
+                const file_status status = directories[i].refresh();
+
+                validated[i] = true;
+                if (!listing.loaded || listing.mtime != status.mtime())
+                {
+                    list(directories[i], listing.names);
+                    listing.mtime = status.mtime();
+                    listing.loaded = true;
+                }
+            }
+            for (vector<string>::size_type j = 0; j < names.size(); ++j)
+            {
+#if defined(_WIN32)
+                const vector<char> key = names[j].to_lower().utf8();
+#else
+                const vector<char> key = names[j].utf8();
+#endif
+
+                if (listing.names.find(key.data()) != listing.names.end())
+                {
+                    const filename file(directories[i], names[j]);
+
+                    if (is_executable(file))
+                    {
+                        return file;
+                    }
+                }
+            }
+        }
+
+        return filename();
+    }
+
+    filename filepath::resolve(const string& name) const
+    {
+        std::vector<bool> validated(m_directories.size());
+
+        if (name.empty())
+        {
+            return filename();
+        }
+        for (string::size_type i = 0; i < name.length(); ++i)
+        {
+            if (filename::is_separator(name[i]))
+            {
+                const filename file(name);
+
+                return is_executable(file) ? file : filename();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_cache->mutex);
+
+        return search(m_directories, m_cache->listings, validated, name);
+    }
+
+    vector<filename> filepath::resolve_all(const vector<string>& names) const
+    {
+        std::vector<bool> validated(m_directories.size());
+        vector<filename> result;
+
+        result.reserve(names.size());
+        for (vector<string>::size_type i = 0; i < names.size(); ++i)
+        {
+            const string& name = names[i];
+            bool has_separator = false;
+
+            for (string::size_type j = 0; j < name.length(); ++j)
+            {
+                if (filename::is_separator(name[j]))
+                {
+                    has_separator = true;
+                    break;
+                }
+            }
+            if (name.empty() || has_separator)
+            {
+                result.push_back(resolve(name));
+            } else {
+                std::lock_guard<std::mutex> lock(m_cache->mutex);
+
+                result.push_back(
+                        search(m_directories, m_cache->listings, validated, name)
+                );
+            }
+        }
+
+        return result;
+    }
+
     bool filepath::equals(const filepath& that) const
     {
         return m_filenames == that.m_filenames;
     }
 
-    static void parse(const string& source, set<filename>& filenames)
+    static void add(const string& str,
+                    set<filename>& filenames,
+                    vector<filename>& directories)
+    {
+        const filename file(str);
+
+        if (filenames.find(file) == filenames.end())
+        {
+            filenames.insert(file);
+            directories.push_back(file);
+        }
+    }
+
+    static void parse(const string& source,
+                      set<filename>& filenames,
+                      vector<filename>& directories)
     {
         string::size_type begin = 0;
         string::size_type end = 0;
@@ -99,7 +384,7 @@ namespace peelo
 
                     if (!str.empty() && !str.is_space())
                     {
-                        filenames.insert(str);
+                        add(str, filenames, directories);
                     }
                 }
                 begin = end = i + 1;
@@ -113,24 +398,22 @@ namespace peelo
 
             if (!str.empty() && !str.is_space())
             {
-                filenames.insert(str);
+                add(str, filenames, directories);
             }
         }
     }
 
     std::ostream& operator<<(std::ostream& os, const class filepath& filepath)
     {
-        const set<filename>& filenames = filepath.filenames();
+        const vector<filename>& directories = filepath.directories();
 
-        for (set<filename>::const_iterator i = filenames.begin();
-             i != filenames.end();
-             ++i)
+        for (vector<filename>::size_type i = 0; i < directories.size(); ++i)
         {
-            if (i != filenames.begin())
+            if (i > 0)
             {
                 os << filepath::separator;
             }
-            os << *i;
+            os << directories[i];
         }
 
         return os;
@@ -138,17 +421,15 @@ namespace peelo
 
     std::wostream& operator<<(std::wostream& os, const class filepath& filepath)
     {
-        const set<filename>& filenames = filepath.filenames();
+        const vector<filename>& directories = filepath.directories();
 
-        for (set<filename>::const_iterator i = filenames.begin();
-             i != filenames.end();
-             ++i)
+        for (vector<filename>::size_type i = 0; i < directories.size(); ++i)
         {
-            if (i != filenames.begin())
+            if (i > 0)
             {
                 os << filepath::separator;
             }
-            os << *i;
+            os << directories[i];
         }
 
         return os;
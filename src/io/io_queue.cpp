@@ -0,0 +1,834 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/io/io_queue.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <unistd.h>
+# if defined(PEELO_HAVE_LINUX_IO_URING_H)
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  if defined(__NR_io_uring_setup) && defined(__GNUC__)
+#   define PEELO_IO_QUEUE_URING 1
+#  endif
+# endif
+#endif
+
+namespace peelo
+{
+    /**
+     * Common base for the implementations, which keeps track of operations
+     * which have not yet completed.
+     */
+    class io_queue::backend
+    {
+    public:
+        backend()
+            : m_pending(0) {}
+
+        virtual ~backend() {}
+
+        virtual bool uses_io_uring() const = 0;
+
+        virtual void register_buffers(void* const* buffers,
+                                      const std::size_t* sizes,
+                                      std::size_t count) = 0;
+
+        virtual void submit(const request* requests, std::size_t count) = 0;
+
+        void drain()
+        {
+            std::unique_lock<std::mutex> lock(m_pending_mutex);
+
+            while (m_pending)
+            {
+                m_idle.wait(lock);
+            }
+        }
+
+    protected:
+        void begin(std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(m_pending_mutex);
+
+            m_pending += count;
+        }
+
+        void finish()
+        {
+            cancel(1);
+        }
+
+        /**
+         * Forgets given number of operations which were counted by begin()
+         * but will never complete.
+         */
+        void cancel(std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(m_pending_mutex);
+
+            m_pending -= count;
+            if (!m_pending)
+            {
+                m_idle.notify_all();
+            }
+        }
+
+    private:
+        std::mutex m_pending_mutex;
+        std::condition_variable m_idle;
+        /** Number of operations submitted but not yet completed. */
+        std::size_t m_pending;
+    };
+
+    /**
+     * Performs an operation synchronously with positional I/O.
+     */
+    static long execute(const io_queue::request& r)
+    {
+#if defined(_WIN32)
+        OVERLAPPED overlapped;
+        DWORD count = 0;
+        BOOL success;
+
+        std::memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = static_cast<DWORD>(r.offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(r.offset >> 32);
+        if (r.write)
+        {
+            success = ::WriteFile(reinterpret_cast<HANDLE>(r.handle),
+                                  r.buffer,
+                                  static_cast<DWORD>(r.size),
+                                  &count,
+                                  &overlapped);
+        } else {
+            success = ::ReadFile(reinterpret_cast<HANDLE>(r.handle),
+                                 r.buffer,
+                                 static_cast<DWORD>(r.size),
+                                 &count,
+                                 &overlapped);
+        }
+        if (!success)
+        {
+            const DWORD error = ::GetLastError();
+
+            return error == ERROR_HANDLE_EOF ? 0 : -static_cast<long>(error);
+        }
+
+        return static_cast<long>(count);
+#else
+        const int fd = static_cast<int>(r.handle);
+        ssize_t result;
+
+        do
+        {
+            result = r.write
+                ? ::pwrite(fd, r.buffer, r.size, static_cast<off_t>(r.offset))
+                : ::pread(fd, r.buffer, r.size, static_cast<off_t>(r.offset));
+        }
+        while (result < 0 && errno == EINTR);
+
+        return result < 0 ? -errno : static_cast<long>(result);
+#endif
+    }
+
+    /**
+     * Fallback implementation which performs the operations with blocking
+     * positional I/O on a pool of worker threads.
+     */
+    class io_queue::thread_backend : public io_queue::backend
+    {
+    public:
+        explicit thread_backend(unsigned threads)
+            : m_stopping(false)
+        {
+            for (unsigned i = 0; i < std::max(threads, 1u); ++i)
+            {
+                m_workers.push_back(std::thread(&thread_backend::work, this));
+            }
+        }
+
+        ~thread_backend()
+        {
+            drain();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                m_stopping = true;
+            }
+            m_available.notify_all();
+            for (std::size_t i = 0; i < m_workers.size(); ++i)
+            {
+                m_workers[i].join();
+            }
+        }
+
+        bool uses_io_uring() const
+        {
+            return false;
+        }
+
+        void register_buffers(void* const*, const std::size_t*, std::size_t)
+        {
+            // Requests always carry the buffer address, so there is nothing
+            // to do for the buffers here.
+        }
+
+        void submit(const request* requests, std::size_t count)
+        {
+            begin(count);
+            try
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                m_requests.insert(m_requests.end(), requests, requests + count);
+            }
+            catch (...)
+            {
+                cancel(count);
+                throw;
+            }
+            if (count == 1)
+            {
+                m_available.notify_one();
+            } else {
+                m_available.notify_all();
+            }
+        }
+
+    private:
+        void work()
+        {
+            for (;;)
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                while (m_requests.empty() && !m_stopping)
+                {
+                    m_available.wait(lock);
+                }
+                if (m_requests.empty())
+                {
+                    return;
+                }
+
+                const request r = m_requests.front();
+
+                m_requests.pop_front();
+                lock.unlock();
+
+                const long result = execute(r);
+
+                if (r.done)
+                {
+                    r.done(result);
+                }
+                finish();
+            }
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_available;
+        std::deque<request> m_requests;
+        std::vector<std::thread> m_workers;
+        bool m_stopping;
+    };
+
+#if defined(PEELO_IO_QUEUE_URING)
+    /**
+     * Implementation which hands the operations to the kernel through
+     * io_uring. Submission queue is filled by the submitting threads under a
+     * mutex, while completions are reaped by a dedicated thread which also
+     * invokes the callbacks. Requests which do not fit into the queue are
+     * held in memory and submitted by the completion thread as earlier
+     * operations complete, so submitting never blocks, not even from the
+     * callbacks.
+     */
+    class io_queue::uring_backend : public io_queue::backend
+    {
+    public:
+        /**
+         * Returns new instance, or null pointer if io_uring is not
+         * available.
+         */
+        static uring_backend* create(unsigned depth)
+        {
+            io_uring_params params;
+            int fd;
+
+            std::memset(&params, 0, sizeof(params));
+            fd = static_cast<int>(::syscall(
+                        __NR_io_uring_setup,
+                        std::min(std::max(depth, 1u), 4096u),
+                        &params
+            ));
+            if (fd < 0)
+            {
+                return 0;
+            }
+
+            uring_backend* result = new uring_backend(fd, params);
+
+            if (!result->m_sqes)
+            {
+                delete result;
+
+                return 0;
+            }
+            result->m_reaper = std::thread(&uring_backend::reap, result);
+
+            return result;
+        }
+
+        ~uring_backend()
+        {
+            if (m_reaper.joinable())
+            {
+                drain();
+                stop();
+                m_reaper.join();
+            }
+            if (m_sqes)
+            {
+                ::munmap(m_sqes, m_sqes_size);
+            }
+            if (m_cq_ring && m_cq_ring != m_sq_ring)
+            {
+                ::munmap(m_cq_ring, m_cq_ring_size);
+            }
+            if (m_sq_ring)
+            {
+                ::munmap(m_sq_ring, m_sq_ring_size);
+            }
+            ::close(m_fd);
+        }
+
+        bool uses_io_uring() const
+        {
+            return true;
+        }
+
+        void register_buffers(void* const* buffers,
+                              const std::size_t* sizes,
+                              std::size_t count)
+        {
+            std::vector<struct iovec> vectors(count);
+
+            drain();
+            ::syscall(__NR_io_uring_register,
+                      m_fd,
+                      IORING_UNREGISTER_BUFFERS,
+                      0,
+                      0);
+            if (!count)
+            {
+                return;
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                vectors[i].iov_base = buffers[i];
+                vectors[i].iov_len = sizes[i];
+            }
+            if (::syscall(__NR_io_uring_register,
+                          m_fd,
+                          IORING_REGISTER_BUFFERS,
+                          vectors.data(),
+                          static_cast<unsigned>(count)) < 0)
+            {
+                throw std::runtime_error("unable to register buffers");
+            }
+        }
+
+        void submit(const request* requests, std::size_t count)
+        {
+            std::vector<callback> failed;
+            int error = 0;
+
+            {
+                std::lock_guard<std::mutex> lock(m_submit_mutex);
+                // Requests are handed to the kernel directly only when no
+                // earlier ones are held, so that they are started in order.
+                const std::size_t direct = m_overflow.empty()
+                    ? std::min<std::size_t>(
+                        count,
+                        std::min(m_limit - m_in_flight, m_entries)
+                    )
+                    : 0;
+                // Kernel consumes all entries during io_uring_enter(), or
+                // they are taken back, so the submission queue is empty at
+                // this point.
+                const unsigned tail = *m_sq_tail;
+                std::size_t prepared = 0;
+                bool queued = false;
+                unsigned left;
+
+                begin(count);
+                try
+                {
+                    // Requests which do not fit are held until earlier
+                    // operations complete. They are queued first, so that a
+                    // failure leaves nothing submitted.
+                    m_overflow.insert(m_overflow.end(),
+                                      requests + direct,
+                                      requests + count);
+                    queued = true;
+                    for (; prepared < direct; ++prepared)
+                    {
+                        prepare(requests[prepared],
+                                tail + static_cast<unsigned>(prepared));
+                    }
+                }
+                catch (...)
+                {
+                    release(tail, tail + static_cast<unsigned>(prepared), 0);
+                    if (queued)
+                    {
+                        m_overflow.erase(m_overflow.end() - (count - direct),
+                                         m_overflow.end());
+                    }
+                    cancel(count);
+                    throw;
+                }
+                if (!direct)
+                {
+                    return;
+                }
+                left = static_cast<unsigned>(direct);
+                m_in_flight += left;
+                __atomic_store_n(m_sq_tail, tail + left, __ATOMIC_RELEASE);
+                if (enter(left))
+                {
+                    return;
+                }
+                error = errno;
+                if (left == direct)
+                {
+                    // Nothing was accepted, so the whole call is undone.
+                    unsubmit(tail + left, left, 0);
+                    m_overflow.erase(m_overflow.end() - (count - direct),
+                                     m_overflow.end());
+                    cancel(count);
+                    throw std::runtime_error("unable to submit I/O requests");
+                }
+                // Part of the requests has already been accepted by the
+                // kernel, so the rest complete with the error instead.
+                unsubmit(tail + static_cast<unsigned>(direct), left, &failed);
+            }
+            fail(failed, error);
+        }
+
+    private:
+        /**
+         * State of an operation which is kept until its completion.
+         */
+        struct operation
+        {
+            callback done;
+            struct iovec vector;
+        };
+
+        uring_backend(int fd, const io_uring_params& params)
+            : m_fd(fd)
+            , m_entries(params.sq_entries)
+            , m_limit(params.cq_entries)
+            , m_in_flight(0)
+            , m_sq_ring(0)
+            , m_cq_ring(0)
+            , m_sqes(0)
+        {
+            char* sq;
+            char* cq;
+
+            m_sq_ring_size = params.sq_off.array
+                + params.sq_entries * sizeof(unsigned);
+            m_cq_ring_size = params.cq_off.cqes
+                + params.cq_entries * sizeof(io_uring_cqe);
+            m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            if (params.features & IORING_FEAT_SINGLE_MMAP)
+            {
+                m_sq_ring_size = m_cq_ring_size = std::max(
+                        m_sq_ring_size,
+                        m_cq_ring_size
+                );
+            }
+            if (!(m_sq_ring = map(m_sq_ring_size, IORING_OFF_SQ_RING)))
+            {
+                return;
+            }
+            if (params.features & IORING_FEAT_SINGLE_MMAP)
+            {
+                m_cq_ring = m_sq_ring;
+            }
+            else if (!(m_cq_ring = map(m_cq_ring_size, IORING_OFF_CQ_RING)))
+            {
+                return;
+            }
+            sq = static_cast<char*>(m_sq_ring);
+            cq = static_cast<char*>(m_cq_ring);
+            m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            m_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            m_sqes = static_cast<io_uring_sqe*>(
+                    map(m_sqes_size, IORING_OFF_SQES)
+            );
+        }
+
+        void* map(std::size_t size, off_t offset)
+        {
+            void* result = ::mmap(0,
+                                  size,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE,
+                                  m_fd,
+                                  offset);
+
+            return result == MAP_FAILED ? 0 : result;
+        }
+
+        void prepare(const request& r, unsigned tail)
+        {
+            const unsigned index = tail & m_sq_mask;
+            io_uring_sqe* sqe = m_sqes + index;
+            operation* op = new operation();
+
+            op->done = r.done;
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+            if (r.buffer_index >= 0)
+            {
+                sqe->opcode = r.write ? IORING_OP_WRITE_FIXED
+                                      : IORING_OP_READ_FIXED;
+                sqe->addr = reinterpret_cast<uintptr_t>(r.buffer);
+                sqe->len = static_cast<uint32_t>(r.size);
+                sqe->buf_index = static_cast<uint16_t>(r.buffer_index);
+            } else {
+                op->vector.iov_base = r.buffer;
+                op->vector.iov_len = r.size;
+                sqe->opcode = r.write ? IORING_OP_WRITEV : IORING_OP_READV;
+                sqe->addr = reinterpret_cast<uintptr_t>(&op->vector);
+                sqe->len = 1;
+            }
+            sqe->fd = static_cast<int>(r.handle);
+            sqe->off = r.offset;
+            sqe->user_data = reinterpret_cast<uintptr_t>(op);
+            m_sq_array[index] = index;
+        }
+
+        /**
+         * Hands given number of prepared entries to the kernel. Returns
+         * <code>false</code> and leaves <i>count</i> at the number of
+         * entries which were not consumed, with <code>errno</code> set, if
+         * the kernel refuses them.
+         */
+        bool enter(unsigned& count)
+        {
+            while (count)
+            {
+                const long result = ::syscall(__NR_io_uring_enter,
+                                              m_fd,
+                                              count,
+                                              0,
+                                              0,
+                                              0,
+                                              0);
+
+                if (result >= 0)
+                {
+                    count -= static_cast<unsigned>(result);
+                }
+                else if (errno == EAGAIN || errno == EBUSY)
+                {
+                    std::this_thread::yield();
+                }
+                else if (errno != EINTR)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Deletes operations of the prepared entries at given positions of
+         * the submission queue. Their callbacks are moved into
+         * <i>callbacks</i> when it is not null.
+         */
+        void release(unsigned begin,
+                     unsigned end,
+                     std::vector<callback>* callbacks)
+        {
+            for (unsigned tail = begin; tail != end; ++tail)
+            {
+                operation* op = reinterpret_cast<operation*>(
+                        static_cast<uintptr_t>(
+                            m_sqes[tail & m_sq_mask].user_data
+                        )
+                );
+
+                if (callbacks)
+                {
+                    callbacks->push_back(op->done);
+                }
+                delete op;
+            }
+        }
+
+        /**
+         * Takes back given number of entries before <i>end</i> which the
+         * kernel did not consume.
+         */
+        void unsubmit(unsigned end,
+                      unsigned count,
+                      std::vector<callback>* callbacks)
+        {
+            release(end - count, end, callbacks);
+            __atomic_store_n(m_sq_tail, end - count, __ATOMIC_RELEASE);
+            m_in_flight -= count;
+        }
+
+        /**
+         * Completes operations which could not be submitted with given
+         * error. Must be called without holding the submission lock, as the
+         * callbacks may submit more requests.
+         */
+        void fail(const std::vector<callback>& callbacks, int error)
+        {
+            for (std::size_t i = 0; i < callbacks.size(); ++i)
+            {
+                if (callbacks[i])
+                {
+                    callbacks[i](-static_cast<long>(error));
+                }
+                finish();
+            }
+        }
+
+        /**
+         * Hands held requests to the kernel while there is room for them.
+         * Callbacks of the requests which the kernel refuses are moved into
+         * <i>failed</i> together with the error code.
+         */
+        void flush(std::vector<callback>& failed, int& error)
+        {
+            while (!m_overflow.empty() && m_in_flight < m_limit)
+            {
+                const unsigned tail = *m_sq_tail;
+                unsigned batch = 0;
+                unsigned left;
+
+                while (!m_overflow.empty()
+                       && m_in_flight + batch < m_limit
+                       && batch < m_entries)
+                {
+                    prepare(m_overflow.front(), tail + batch++);
+                    m_overflow.pop_front();
+                }
+                left = batch;
+                m_in_flight += batch;
+                __atomic_store_n(m_sq_tail, tail + batch, __ATOMIC_RELEASE);
+                if (!enter(left))
+                {
+                    error = errno;
+                    unsubmit(tail + batch, left, &failed);
+                    while (!m_overflow.empty())
+                    {
+                        failed.push_back(m_overflow.front().done);
+                        m_overflow.pop_front();
+                    }
+                }
+            }
+        }
+
+        /**
+         * Submits an operation which tells the completion thread to exit.
+         */
+        void stop()
+        {
+            std::lock_guard<std::mutex> lock(m_submit_mutex);
+            const unsigned tail = *m_sq_tail;
+            const unsigned index = tail & m_sq_mask;
+            io_uring_sqe* sqe = m_sqes + index;
+
+            std::memset(sqe, 0, sizeof(io_uring_sqe));
+            sqe->opcode = IORING_OP_NOP;
+            unsigned count = 1;
+
+            m_sq_array[index] = index;
+            __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+            if (!enter(count))
+            {
+                throw std::runtime_error("unable to stop I/O queue");
+            }
+        }
+
+        void reap()
+        {
+            std::vector<callback> failed;
+            int error = 0;
+
+            for (;;)
+            {
+                unsigned head = *m_cq_head;
+                const unsigned tail = __atomic_load_n(m_cq_tail,
+                                                      __ATOMIC_ACQUIRE);
+
+                if (head == tail)
+                {
+                    ::syscall(__NR_io_uring_enter,
+                              m_fd,
+                              0,
+                              1,
+                              IORING_ENTER_GETEVENTS,
+                              0,
+                              0);
+                    continue;
+                }
+                while (head != tail)
+                {
+                    const io_uring_cqe* cqe = m_cqes + (head & m_cq_mask);
+                    operation* op = reinterpret_cast<operation*>(
+                            static_cast<uintptr_t>(cqe->user_data)
+                    );
+                    const long result = cqe->res;
+
+                    __atomic_store_n(m_cq_head, ++head, __ATOMIC_RELEASE);
+                    if (!op)
+                    {
+                        return;
+                    }
+                    if (op->done)
+                    {
+                        op->done(result);
+                    }
+                    delete op;
+                    {
+                        std::lock_guard<std::mutex> lock(m_submit_mutex);
+
+                        --m_in_flight;
+                        flush(failed, error);
+                    }
+                    finish();
+                    fail(failed, error);
+                    failed.clear();
+                }
+            }
+        }
+
+    private:
+        const int m_fd;
+        /** Number of entries in the submission queue. */
+        const unsigned m_entries;
+        /**
+         * Maximum number of operations in flight, so that the completion
+         * queue cannot overflow.
+         */
+        const unsigned m_limit;
+        unsigned m_in_flight;
+        /** Requests waiting for room in the queue. */
+        std::deque<request> m_overflow;
+        std::mutex m_submit_mutex;
+        void* m_sq_ring;
+        void* m_cq_ring;
+        std::size_t m_sq_ring_size;
+        std::size_t m_cq_ring_size;
+        std::size_t m_sqes_size;
+        unsigned* m_sq_tail;
+        unsigned m_sq_mask;
+        unsigned* m_sq_array;
+        io_uring_sqe* m_sqes;
+        unsigned* m_cq_head;
+        unsigned* m_cq_tail;
+        unsigned m_cq_mask;
+        io_uring_cqe* m_cqes;
+        std::thread m_reaper;
+    };
+#endif
+
+    io_queue::io_queue(unsigned depth, bool allow_io_uring, unsigned threads)
+        : m_backend(0)
+    {
+#if defined(PEELO_IO_QUEUE_URING)
+        if (allow_io_uring)
+        {
+            m_backend = uring_backend::create(depth);
+        }
+#else
+        (void) depth;
+        (void) allow_io_uring;
+#endif
+        if (!m_backend)
+        {
+            m_backend = new thread_backend(threads);
+        }
+    }
+
+    io_queue::~io_queue()
+    {
+        delete m_backend;
+    }
+
+    bool io_queue::uses_io_uring() const
+    {
+        return m_backend->uses_io_uring();
+    }
+
+    void io_queue::register_buffers(void* const* buffers,
+                                    const std::size_t* sizes,
+                                    std::size_t count)
+    {
+        m_backend->register_buffers(buffers, sizes, count);
+    }
+
+    void io_queue::submit(const request* requests, std::size_t count)
+    {
+        if (count)
+        {
+            m_backend->submit(requests, count);
+        }
+    }
+
+    void io_queue::drain()
+    {
+        m_backend->drain();
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/net/query_params.hpp>
+#include <peelo/net/uri.hpp>
+
+namespace peelo
+{
+    query_params::query_params(const string& query)
+        : m_query(query) {}
+
+    query_params::query_params(const query_params& that)
+        : m_query(that.m_query) {}
+
+    query_params::iterator query_params::begin() const
+    {
+        return iterator(&m_query, 0);
+    }
+
+    query_params::iterator query_params::end() const
+    {
+        return iterator(&m_query, m_query.length());
+    }
+
+    void query_params::to_map(map<string, string>& result, bool decode) const
+    {
+        for (iterator i = begin(); i != end(); ++i)
+        {
+            if (decode)
+            {
+                result[uri::percent_decode(i->first(), true)]
+                    = uri::percent_decode(i->second(), true);
+            } else {
+                result[i->first()] = i->second();
+            }
+        }
+    }
+
+    query_params& query_params::assign(const query_params& that)
+    {
+        m_query.assign(that.m_query);
+
+        return *this;
+    }
+
+    query_params::iterator::iterator(const string* query,
+                                     string::size_type pos)
+        : m_query(query)
+        , m_begin(pos)
+        , m_end(pos)
+    {
+        seek(pos);
+    }
+
+    query_params::iterator& query_params::iterator::operator++()
+    {
+        if (m_begin < m_query->length())
+        {
+            seek(m_end + 1);
+        }
+
+        return *this;
+    }
+
+    void query_params::iterator::seek(string::size_type pos)
+    {
+        const string::size_type length = m_query->length();
+        string::size_type equals = string::npos;
+
+        while (pos < length && (*m_query)[pos] == '&')
+        {
+            ++pos;
+        }
+        m_begin = m_end = pos;
+        if (pos >= length)
+        {
+            m_begin = m_end = length;
+            m_value = value_type();
+
+            return;
+        }
+        while (m_end < length && (*m_query)[m_end] != '&')
+        {
+            if (equals == string::npos && (*m_query)[m_end] == '=')
+            {
+                equals = m_end;
+            }
+            ++m_end;
+        }
+        if (equals == string::npos)
+        {
+            m_value.assign(m_query->substr(m_begin, m_end - m_begin),
+                           string());
+        } else {
+            m_value.assign(m_query->substr(m_begin, equals - m_begin),
+                           m_query->substr(equals + 1, m_end - equals - 1));
+        }
+    }
+}
@@ -24,9 +24,384 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <peelo/net/uri.hpp>
+#include <peelo/text/stringbuilder.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
 
 namespace peelo
 {
+    namespace
+    {
+        /**
+         * Character classes of RFC 3986.
+         */
+        enum char_class
+        {
+            c_alpha = 1 << 0,
+            c_digit = 1 << 1,
+            c_hex = 1 << 2,
+            /** "-", "." and "_", "~" which are also unreserved. */
+            c_mark = 1 << 3,
+            c_sub_delim = 1 << 4,
+            c_colon = 1 << 5,
+            c_at = 1 << 6,
+            c_slash = 1 << 7,
+            c_question = 1 << 8,
+            /** Characters allowed in scheme after the first one. */
+            c_scheme = 1 << 9
+        };
+
+        enum
+        {
+            c_unreserved = c_alpha | c_digit | c_mark,
+            c_userinfo = c_unreserved | c_sub_delim | c_colon,
+            c_reg_name = c_unreserved | c_sub_delim,
+            c_pchar = c_unreserved | c_sub_delim | c_colon | c_at,
+            c_path = c_pchar | c_slash,
+            c_query = c_path | c_question
+        };
+
+        /**
+         * Lookup table from ASCII characters into their classes.
+         */
+        class char_table
+        {
+        public:
+            char_table()
+            {
+                static const char sub_delims[] = "!$&'()*+,;=";
+
+                for (int c = 0; c < 128; ++c)
+                {
+                    unsigned short flags = 0;
+
+                    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+                    {
+                        flags |= c_alpha | c_scheme;
+                    }
+                    if (c >= '0' && c <= '9')
+                    {
+                        flags |= c_digit | c_hex | c_scheme;
+                    }
+                    if ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))
+                    {
+                        flags |= c_hex;
+                    }
+                    if (c == '-' || c == '.' || c == '_' || c == '~')
+                    {
+                        flags |= c_mark;
+                    }
+                    if (c == '+' || c == '-' || c == '.')
+                    {
+                        flags |= c_scheme;
+                    }
+                    for (const char* p = sub_delims; *p; ++p)
+                    {
+                        if (c == *p)
+                        {
+                            flags |= c_sub_delim;
+                        }
+                    }
+                    if (c == ':')
+                    {
+                        flags |= c_colon;
+                    }
+                    else if (c == '@')
+                    {
+                        flags |= c_at;
+                    }
+                    else if (c == '/')
+                    {
+                        flags |= c_slash;
+                    }
+                    else if (c == '?')
+                    {
+                        flags |= c_question;
+                    }
+                    m_flags[c] = flags;
+                }
+            }
+
+            inline bool is(unsigned c, unsigned mask) const
+            {
+                return c < 128 && (m_flags[c] & mask);
+            }
+
+        private:
+            unsigned short m_flags[128];
+        };
+
+        static const char_table table;
+
+        /**
+         * Reads characters from raw byte buffer.
+         */
+        struct char_input
+        {
+            const char* data;
+
+            inline unsigned operator[](std::size_t index) const
+            {
+                return static_cast<unsigned char>(data[index]);
+            }
+        };
+
+        /**
+         * Reads characters from string.
+         */
+        struct string_input
+        {
+            const string& data;
+
+            inline unsigned operator[](std::size_t index) const
+            {
+                return data[index].code();
+            }
+        };
+
+        /**
+         * Positions of URI components in the input. Missing components
+         * have empty ranges.
+         */
+        struct components
+        {
+            std::size_t scheme_end;
+            std::size_t username_begin;
+            std::size_t username_end;
+            std::size_t password_begin;
+            std::size_t password_end;
+            std::size_t host_begin;
+            std::size_t host_end;
+            int port;
+            std::size_t path_begin;
+            std::size_t path_end;
+            std::size_t query_begin;
+            std::size_t query_end;
+            std::size_t fragment_begin;
+            std::size_t fragment_end;
+            bool has_authority;
+        };
+    }
+
+    static void invalid_uri()
+    {
+        throw std::invalid_argument("invalid URI");
+    }
+
+    /**
+     * Advances over characters belonging to given classes, and over percent
+     * encoded octets, and returns position of the first character which
+     * does not.
+     */
+    template< class Input >
+    static inline std::size_t scan(const Input& input,
+                                   std::size_t pos,
+                                   std::size_t length,
+                                   unsigned mask)
+    {
+        while (pos < length)
+        {
+            const unsigned c = input[pos];
+
+            if (table.is(c, mask))
+            {
+                ++pos;
+            }
+            else if (c == '%')
+            {
+                if (length - pos < 3
+                    || !table.is(input[pos + 1], c_hex)
+                    || !table.is(input[pos + 2], c_hex))
+                {
+                    invalid_uri();
+                }
+                pos += 3;
+            } else {
+                break;
+            }
+        }
+
+        return pos;
+    }
+
+    template< class Input >
+    static std::size_t parse_authority(const Input& input,
+                                       std::size_t pos,
+                                       std::size_t length,
+                                       components& result)
+    {
+        std::size_t end = scan(input, pos, length, c_userinfo);
+
+        if (end < length && input[end] == '@')
+        {
+            std::size_t colon = pos;
+
+            while (colon < end && input[colon] != ':')
+            {
+                ++colon;
+            }
+            result.username_begin = pos;
+            result.username_end = colon;
+            if (colon < end)
+            {
+                result.password_begin = colon + 1;
+                result.password_end = end;
+            }
+            pos = end + 1;
+        }
+
+        result.host_begin = pos;
+        if (pos < length && input[pos] == '[')
+        {
+            // IP literal, which is validated only for its character set.
+            end = scan(input, pos + 1, length, c_reg_name | c_colon);
+            if (end >= length || input[end] != ']' || end == pos + 1)
+            {
+                invalid_uri();
+            }
+            pos = end + 1;
+        } else {
+            pos = scan(input, pos, length, c_reg_name);
+        }
+        result.host_end = pos;
+
+        if (pos < length && input[pos] == ':')
+        {
+            long port = 0;
+
+            while (++pos < length && table.is(input[pos], c_digit))
+            {
+                if ((port = port * 10 + (input[pos] - '0')) > 65535)
+                {
+                    invalid_uri();
+                }
+            }
+            result.port = static_cast<int>(port);
+        }
+
+        // Authority can only be followed by path, query or fragment.
+        if (pos < length
+            && input[pos] != '/'
+            && input[pos] != '?'
+            && input[pos] != '#')
+        {
+            invalid_uri();
+        }
+
+        return pos;
+    }
+
+    /**
+     * Locates components of URI reference in the input, validating it at
+     * the same time.
+     */
+    template< class Input >
+    static void parse_components(const Input& input,
+                                 std::size_t length,
+                                 components& result)
+    {
+        std::size_t pos = 0;
+
+        result = components();
+
+        // Scheme, which must be followed by a colon. Otherwise the input is
+        // relative reference.
+        if (length > 0 && table.is(input[0], c_alpha))
+        {
+            pos = 1;
+            while (pos < length && table.is(input[pos], c_scheme))
+            {
+                ++pos;
+            }
+            if (pos < length && input[pos] == ':')
+            {
+                result.scheme_end = pos++;
+            } else {
+                pos = 0;
+            }
+        }
+
+        if (length - pos >= 2 && input[pos] == '/' && input[pos + 1] == '/')
+        {
+            result.has_authority = true;
+            pos = parse_authority(input, pos + 2, length, result);
+        }
+
+        result.path_begin = pos;
+        pos = scan(input, pos, length, c_path);
+        result.path_end = pos;
+
+        // In relative references without authority, the first path segment
+        // must not contain a colon, so that it is not mistaken for scheme.
+        if (!result.scheme_end
+            && !result.has_authority
+            && result.path_begin < result.path_end
+            && input[result.path_begin] != '/')
+        {
+            for (std::size_t i = result.path_begin; i < result.path_end; ++i)
+            {
+                if (input[i] == '/')
+                {
+                    break;
+                }
+                else if (input[i] == ':')
+                {
+                    invalid_uri();
+                }
+            }
+        }
+
+        if (pos < length && input[pos] == '?')
+        {
+            result.query_begin = ++pos;
+            pos = scan(input, pos, length, c_query);
+            result.query_end = pos;
+        }
+
+        if (pos < length && input[pos] == '#')
+        {
+            result.fragment_begin = ++pos;
+            pos = scan(input, pos, length, c_query);
+            result.fragment_end = pos;
+        }
+
+        if (pos != length)
+        {
+            invalid_uri();
+        }
+    }
+
+    static inline string slice(const string& input,
+                               std::size_t begin,
+                               std::size_t end)
+    {
+        return begin < end ? input.substr(begin, end - begin) : string();
+    }
+
+    static uri from_components(const string& input, const components& c)
+    {
+        // Fragment begins after "#", so its position is never zero when it
+        // is present.
+        const std::size_t scheme_specific_end = c.fragment_begin
+            ? c.fragment_begin - 1
+            : input.length();
+
+        return uri(slice(input, 0, c.scheme_end),
+                   c.scheme_end ? slice(input,
+                                        c.scheme_end + 1,
+                                        scheme_specific_end)
+                                : string(),
+                   slice(input, c.username_begin, c.username_end),
+                   slice(input, c.password_begin, c.password_end),
+                   slice(input, c.host_begin, c.host_end),
+                   c.port,
+                   slice(input, c.path_begin, c.path_end),
+                   slice(input, c.query_begin, c.query_end),
+                   slice(input, c.fragment_begin, c.fragment_end),
+                   c.has_authority);
+    }
+
     uri::uri(const string& scheme,
              const string& scheme_specific,
              const string& username,
@@ -35,7 +410,8 @@ namespace peelo
              int port,
              const string& path,
              const string& query,
-             const string& fragment)
+             const string& fragment,
+             bool has_authority)
         : m_scheme(scheme)
         , m_scheme_specific(scheme_specific)
         , m_username(username)
@@ -44,7 +420,9 @@ namespace peelo
         , m_port(port)
         , m_path(path)
         , m_query(query)
-        , m_fragment(fragment) {}
+        , m_fragment(fragment)
+        , m_has_authority(has_authority || !hostname.empty())
+        , m_canonical(NULL) {}
 
     uri::uri(const uri& that)
         : m_scheme(that.m_scheme)
@@ -55,7 +433,244 @@ namespace peelo
         , m_port(that.m_port)
         , m_path(that.m_path)
         , m_query(that.m_query)
-        , m_fragment(that.m_fragment) {}
+        , m_fragment(that.m_fragment)
+        , m_has_authority(that.m_has_authority)
+        , m_canonical(NULL)
+    {
+        const string* canonical = that.m_canonical.load(
+            std::memory_order_acquire
+        );
+
+        if (canonical)
+        {
+            m_canonical.store(new string(*canonical),
+                              std::memory_order_relaxed);
+        }
+    }
+
+    uri::~uri()
+    {
+        delete m_canonical.load(std::memory_order_relaxed);
+    }
+
+    uri uri::parse(const string& input)
+    {
+        const string_input in = { input };
+        components c;
+
+        parse_components(in, input.length(), c);
+
+        return from_components(input, c);
+    }
+
+    uri uri::parse(const char* input, std::size_t length)
+    {
+        const char_input in = { input };
+        components c;
+
+        parse_components(in, length, c);
+
+        // Valid input is ASCII, so every byte becomes one rune.
+        return from_components(string(input, length), c);
+    }
+
+    static void invalid_percent_encoding()
+    {
+        throw std::invalid_argument("invalid percent encoding");
+    }
+
+    static inline int hex_value(unsigned c)
+    {
+        return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+    }
+
+    /**
+     * Set of ASCII characters which are not percent encoded.
+     */
+    class safe_set
+    {
+    public:
+        explicit safe_set(const char* extra)
+        {
+            m_bits[0] = m_bits[1] = 0;
+            for (unsigned c = 0; c < 128; ++c)
+            {
+                if (table.is(c, c_unreserved))
+                {
+                    add(c);
+                }
+            }
+            for (; extra && *extra; ++extra)
+            {
+                add(static_cast<unsigned char>(*extra));
+            }
+        }
+
+        inline bool contains(unsigned c) const
+        {
+            return c < 128 && (m_bits[c >> 6] >> (c & 63)) & 1;
+        }
+
+    private:
+        inline void add(unsigned c)
+        {
+            if (c < 128)
+            {
+                m_bits[c >> 6] |= static_cast<uint64_t>(1) << (c & 63);
+            }
+        }
+
+    private:
+        uint64_t m_bits[2];
+    };
+
+    std::size_t uri::percent_decode(const char* input,
+                                    std::size_t length,
+                                    char* output,
+                                    bool plus_as_space)
+    {
+        const char* end = input + length;
+        char* out = output;
+
+        while (input < end)
+        {
+            const char* run;
+
+            if (plus_as_space)
+            {
+                run = input;
+                while (run < end && *run != '%' && *run != '+')
+                {
+                    ++run;
+                }
+            } else {
+                run = static_cast<const char*>(
+                    std::memchr(input, '%', end - input)
+                );
+                if (!run)
+                {
+                    run = end;
+                }
+            }
+            if (run > input)
+            {
+                std::memmove(out, input, run - input);
+                out += run - input;
+                input = run;
+            }
+            if (input >= end)
+            {
+                break;
+            }
+            else if (*input == '+')
+            {
+                *out++ = ' ';
+                ++input;
+                continue;
+            }
+            if (end - input < 3
+                || !table.is(static_cast<unsigned char>(input[1]), c_hex)
+                || !table.is(static_cast<unsigned char>(input[2]), c_hex))
+            {
+                invalid_percent_encoding();
+            }
+            *out++ = static_cast<char>(
+                (hex_value(static_cast<unsigned char>(input[1])) << 4)
+                | hex_value(static_cast<unsigned char>(input[2]))
+            );
+            input += 3;
+        }
+
+        return out - output;
+    }
+
+    string uri::percent_decode(const string& input, bool plus_as_space)
+    {
+        const string::size_type length = input.length();
+        string::size_type i = 0;
+
+        while (i < length
+               && input[i] != '%'
+               && (!plus_as_space || input[i] != '+'))
+        {
+            ++i;
+        }
+        if (i == length)
+        {
+            return input;
+        }
+
+        vector<char> buffer = input.utf8();
+
+        return string(buffer.data(),
+                      percent_decode(buffer.data(),
+                                     buffer.size() - 1,
+                                     buffer.data(),
+                                     plus_as_space));
+    }
+
+    std::size_t uri::percent_encode(const char* input,
+                                    std::size_t length,
+                                    char* output,
+                                    const char* safe)
+    {
+        static const char digits[] = "0123456789ABCDEF";
+        const safe_set set(safe);
+        const char* end = input + length;
+        char* out = output;
+
+        while (input < end)
+        {
+            const char* run = input;
+
+            while (run < end && set.contains(static_cast<unsigned char>(*run)))
+            {
+                ++run;
+            }
+            if (run > input)
+            {
+                std::memcpy(out, input, run - input);
+                out += run - input;
+                input = run;
+            }
+            if (input < end)
+            {
+                const unsigned c = static_cast<unsigned char>(*input++);
+
+                out[0] = '%';
+                out[1] = digits[c >> 4];
+                out[2] = digits[c & 15];
+                out += 3;
+            }
+        }
+
+        return out - output;
+    }
+
+    string uri::percent_encode(const string& input, const char* safe)
+    {
+        const safe_set set(safe);
+        const string::size_type length = input.length();
+        string::size_type i = 0;
+
+        while (i < length && set.contains(input[i].code()))
+        {
+            ++i;
+        }
+        if (i == length)
+        {
+            return input;
+        }
+
+        const vector<char> encoded = input.utf8();
+        vector<char> buffer(3 * (encoded.size() - 1));
+
+        return string(buffer.data(),
+                      percent_encode(encoded.data(),
+                                     encoded.size() - 1,
+                                     buffer.data(),
+                                     safe));
+    }
 
     string uri::authority() const
     {
@@ -67,72 +682,364 @@ namespace peelo
         }
     }
 
-    uri& uri::assign(const uri& that)
+    /**
+     * Decodes percent encoded unreserved characters and converts hexadecimal
+     * digits of the remaining ones into upper case. Optionally converts
+     * ASCII letters into lower case.
+     */
+    static string normalize_component(const string& input, bool lower)
     {
-        m_scheme.assign(that.m_scheme);
-        m_scheme_specific.assign(that.m_scheme_specific);
-        m_username.assign(that.m_username);
-        m_password.assign(that.m_password);
-        m_hostname.assign(that.m_hostname);
-        m_port = that.m_port;
-        m_path.assign(that.m_path);
-        m_query.assign(that.m_query);
-        m_fragment.assign(that.m_fragment);
+        static const char digits[] = "0123456789ABCDEF";
+        const string::size_type length = input.length();
+        string::size_type i = 0;
 
-        return *this;
+        while (i < length)
+        {
+            const unsigned c = input[i].code();
+
+            if (c == '%' || (lower && c >= 'A' && c <= 'Z'))
+            {
+                break;
+            }
+            ++i;
+        }
+        if (i == length)
+        {
+            return input;
+        }
+
+        stringbuilder sb(length);
+
+        for (i = 0; i < length; ++i)
+        {
+            unsigned c = input[i].code();
+
+            if (c == '%'
+                && length - i >= 3
+                && table.is(input[i + 1].code(), c_hex)
+                && table.is(input[i + 2].code(), c_hex))
+            {
+                c = (hex_value(input[i + 1].code()) << 4)
+                    | hex_value(input[i + 2].code());
+                i += 2;
+                if (!table.is(c, c_unreserved))
+                {
+                    sb.append('%');
+                    sb.append(digits[c >> 4]);
+                    sb.append(digits[c & 15]);
+                    continue;
+                }
+            }
+            if (lower && c >= 'A' && c <= 'Z')
+            {
+                c += 'a' - 'A';
+            }
+            sb.append(static_cast<int>(c));
+        }
+
+        return sb.str();
     }
 
-    std::ostream& operator<<(std::ostream& os, const class uri& uri)
+    static inline bool is_dot_segment(const string& path,
+                                      string::size_type begin,
+                                      string::size_type end)
     {
-        const string& scheme = uri.scheme();
-        const string& hostname = uri.hostname();
-        const string& path = uri.path();
-        const string& query = uri.query();
-        const string& fragment = uri.fragment();
+        return (end - begin == 1 && path[begin] == '.')
+            || (end - begin == 2
+                && path[begin] == '.'
+                && path[begin + 1] == '.');
+    }
+
+    /**
+     * Removes "." and ".." segments from the path, with the same results as
+     * the algorithm in section 5.2.4 of RFC 3986.
+     */
+    static string remove_dot_segments(const string& path)
+    {
+        const string::size_type length = path.length();
+        const bool absolute = length > 0 && path[0] == '/';
+        std::vector<std::pair<string::size_type, string::size_type> > output;
+        bool found = false;
+        bool trailing_slash = false;
+        string::size_type begin = absolute ? 1 : 0;
+        string::size_type size;
+
+        for (string::size_type i = begin; i <= length; ++i)
+        {
+            if (i < length && path[i] != '/')
+            {
+                continue;
+            }
+            if (is_dot_segment(path, begin, i))
+            {
+                found = true;
+                if (i - begin == 2 && !output.empty())
+                {
+                    output.pop_back();
+                }
+                trailing_slash = i == length;
+            } else {
+                output.push_back(std::make_pair(begin, i));
+            }
+            begin = i + 1;
+        }
+        if (!found)
+        {
+            return path;
+        }
+
+        size = (absolute ? 1 : 0) + (trailing_slash ? 1 : 0);
+        for (std::size_t i = 0; i < output.size(); ++i)
+        {
+            size += output[i].second - output[i].first + (i > 0 ? 1 : 0);
+        }
+
+        stringbuilder sb(size);
+
+        if (absolute)
+        {
+            sb.append('/');
+        }
+        for (std::size_t i = 0; i < output.size(); ++i)
+        {
+            if (i > 0)
+            {
+                sb.append('/');
+            }
+            sb.append(path.substr(output[i].first,
+                                  output[i].second - output[i].first));
+        }
+        if (trailing_slash && (!absolute || !output.empty()))
+        {
+            sb.append('/');
+        }
+
+        return sb.str();
+    }
+
+    /**
+     * Returns default port of given lower case scheme, or 0 if the scheme is
+     * not known.
+     */
+    static int default_port(const string& scheme)
+    {
+        if (scheme == "http" || scheme == "ws")
+        {
+            return 80;
+        }
+        else if (scheme == "https" || scheme == "wss")
+        {
+            return 443;
+        }
+        else if (scheme == "ftp")
+        {
+            return 21;
+        }
+
+        return 0;
+    }
+
+    uri uri::normalize() const
+    {
+        const string scheme = normalize_component(m_scheme, true);
+        const string hostname = normalize_component(m_hostname, true);
+        const bool hierarchical = m_has_authority || m_path || m_query;
+        string path = normalize_component(m_path, false);
+        int port = m_port;
 
         if (scheme)
         {
-            const string& scheme_specific = uri.scheme_specific();
+            path = remove_dot_segments(path);
+        }
+        if (port == default_port(scheme))
+        {
+            port = 0;
+        }
+        if (hostname && !path && (scheme == "http" || scheme == "https"))
+        {
+            path = "/";
+        }
+
+        uri result(scheme,
+                   hierarchical ? string() : m_scheme_specific,
+                   normalize_component(m_username, false),
+                   normalize_component(m_password, false),
+                   hostname,
+                   port,
+                   path,
+                   normalize_component(m_query, false),
+                   normalize_component(m_fragment, false),
+                   m_has_authority);
+        const string* canonical = new string(result.to_string());
+
+        result.m_canonical.store(canonical, std::memory_order_relaxed);
+        if (scheme && hierarchical)
+        {
+            // Scheme specific part of the normalized URI is taken from its
+            // serialized form.
+            result.m_scheme_specific = canonical->substr(
+                scheme.length() + 1,
+                canonical->length()
+                - scheme.length()
+                - 1
+                - (result.m_fragment ? result.m_fragment.length() + 1 : 0)
+            );
+        }
+
+        return result;
+    }
 
-            os << scheme << ':';
-            if (scheme_specific)
+    string uri::to_string() const
+    {
+        const bool hierarchical = m_has_authority || m_path || m_query;
+        const string port = m_has_authority && m_port > 0
+            ? string::to_string(m_port)
+            : string();
+        const bool slash = m_has_authority && m_path && m_path[0] != '/';
+        string::size_type size = 0;
+
+        // Compute the length beforehand, so that the buffer is allocated
+        // only once.
+        if (m_scheme)
+        {
+            size += m_scheme.length() + 1;
+            if (!hierarchical)
+            {
+                size += m_scheme_specific.length();
+            }
+        }
+        if (m_has_authority)
+        {
+            size += 2 + m_hostname.length();
+            if (m_username || m_password)
             {
-                os << scheme_specific;
+                size += m_username.length() + 1;
+                if (m_password)
+                {
+                    size += m_password.length() + 1;
+                }
             }
+            if (port)
+            {
+                size += port.length() + 1;
+            }
+        }
+        size += (slash ? 1 : 0) + m_path.length();
+        if (m_query)
+        {
+            size += m_query.length() + 1;
         }
-        if (hostname)
+        if (m_fragment)
         {
-            const string& username = uri.username();
-            const string& password = uri.password();
-            int port = uri.port();
+            size += m_fragment.length() + 1;
+        }
+
+        stringbuilder sb(size);
 
-            if (username && password)
+        if (m_scheme)
+        {
+            sb.append(m_scheme);
+            sb.append(':');
+            if (!hierarchical)
             {
-                os << username << ':' << password << '@';
+                sb.append(m_scheme_specific);
             }
-            os << hostname;
-            if (port >= 0)
+        }
+        if (m_has_authority)
+        {
+            sb.append(2, '/');
+            if (m_username || m_password)
             {
-                os << ':' << port;
+                sb.append(m_username);
+                if (m_password)
+                {
+                    sb.append(':');
+                    sb.append(m_password);
+                }
+                sb.append('@');
             }
-            if (!path.empty() && path[0] != '/')
+            sb.append(m_hostname);
+            if (port)
             {
-                os << '/';
+                sb.append(':');
+                sb.append(port);
             }
         }
-        if (path)
+        if (slash)
         {
-            os << path;
+            sb.append('/');
         }
-        if (query)
+        sb.append(m_path);
+        if (m_query)
         {
-            os << '?' << query;
+            sb.append('?');
+            sb.append(m_query);
         }
-        if (fragment)
+        if (m_fragment)
         {
-            os << '#' << fragment;
+            sb.append('#');
+            sb.append(m_fragment);
         }
 
-        return os;
+        return sb.str();
+    }
+
+    const string& uri::canonical() const
+    {
+        const string* canonical = m_canonical.load(std::memory_order_acquire);
+
+        if (!canonical)
+        {
+            const string* expected = NULL;
+
+            canonical = new string(normalize().canonical());
+            if (!m_canonical.compare_exchange_strong(expected,
+                                                     canonical,
+                                                     std::memory_order_acq_rel,
+                                                     std::memory_order_acquire))
+            {
+                // Another thread got there first.
+                delete canonical;
+                canonical = expected;
+            }
+        }
+
+        return *canonical;
+    }
+
+    bool uri::equals(const uri& that) const
+    {
+        return canonical().equals(that.canonical());
+    }
+
+    uri& uri::assign(const uri& that)
+    {
+        m_scheme.assign(that.m_scheme);
+        m_scheme_specific.assign(that.m_scheme_specific);
+        m_username.assign(that.m_username);
+        m_password.assign(that.m_password);
+        m_hostname.assign(that.m_hostname);
+        m_port = that.m_port;
+        m_path.assign(that.m_path);
+        m_query.assign(that.m_query);
+        m_fragment.assign(that.m_fragment);
+        m_has_authority = that.m_has_authority;
+        if (this != &that)
+        {
+            const string* canonical = that.m_canonical.load(
+                std::memory_order_acquire
+            );
+
+            delete m_canonical.exchange(canonical ? new string(*canonical)
+                                                  : NULL,
+                                        std::memory_order_acq_rel);
+        }
+
+        return *this;
+    }
+
+    std::ostream& operator<<(std::ostream& os, const class uri& uri)
+    {
+        return os << uri.to_string();
     }
 }
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/number/big_ratio.hpp>
+#include <peelo/text/stringbuilder.hpp>
+
+namespace peelo
+{
+    big_ratio::big_ratio()
+        : m_numerator(0)
+        , m_denominator(1) {}
+
+    big_ratio::big_ratio(const big_ratio& that)
+        : m_numerator(that.m_numerator)
+        , m_denominator(that.m_denominator) {}
+
+    big_ratio::big_ratio(const ratio& that)
+        : m_numerator(that.numerator())
+        , m_denominator(that.denominator()) {}
+
+    big_ratio::big_ratio(const bigint& numerator, const bigint& denominator)
+        : m_numerator(numerator)
+        , m_denominator(denominator)
+    {
+        bigint g;
+
+        if (denominator.is_zero())
+        {
+            throw std::domain_error("denominator cannot be zero");
+        }
+        if (m_denominator.is_negative())
+        {
+            m_numerator = -m_numerator;
+            m_denominator = -m_denominator;
+        }
+        g = bigint::gcd(m_numerator, m_denominator);
+        if (g != 1)
+        {
+            m_numerator /= g;
+            m_denominator /= g;
+        }
+    }
+
+    bool big_ratio::fits_ratio() const
+    {
+        return m_numerator.fits_int64() && m_denominator.fits_int64();
+    }
+
+    ratio big_ratio::to_ratio() const
+    {
+        if (!fits_ratio())
+        {
+            throw std::overflow_error("number does not fit into ratio");
+        }
+
+        return ratio(m_numerator.to_int64(), m_denominator.to_int64());
+    }
+
+    string big_ratio::to_string() const
+    {
+        const string numerator = m_numerator.to_string();
+        const string denominator = m_denominator.to_string();
+        stringbuilder sb(numerator.length() + denominator.length() + 1);
+
+        sb.append(numerator);
+        sb.append('/');
+        sb.append(denominator);
+
+        return sb.str();
+    }
+
+    big_ratio& big_ratio::assign(const big_ratio& that)
+    {
+        m_numerator = that.m_numerator;
+        m_denominator = that.m_denominator;
+
+        return *this;
+    }
+
+    bool big_ratio::equals(const big_ratio& that) const
+    {
+        return m_numerator == that.m_numerator
+            && m_denominator == that.m_denominator;
+    }
+
+    int big_ratio::compare(const big_ratio& that) const
+    {
+        if (m_numerator.sign() != that.m_numerator.sign())
+        {
+            return m_numerator.sign() < that.m_numerator.sign() ? -1 : 1;
+        }
+        else if (m_denominator == that.m_denominator)
+        {
+            return m_numerator.compare(that.m_numerator);
+        }
+
+        return (m_numerator * that.m_denominator).compare(
+            that.m_numerator * m_denominator
+        );
+    }
+
+    big_ratio big_ratio::operator-() const
+    {
+        big_ratio result(*this);
+
+        result.m_numerator = -m_numerator;
+
+        return result;
+    }
+
+    /**
+     * Adds fractions n1 / d1 and n2 / d2 using the reductions from TAOCP
+     * 4.5.1, which keep the intermediate values small.
+     */
+    static void add_fractions(const bigint& n1,
+                              const bigint& d1,
+                              const bigint& n2,
+                              const bigint& d2,
+                              bigint& numerator,
+                              bigint& denominator)
+    {
+        const bigint g = bigint::gcd(d1, d2);
+
+        if (g == 1)
+        {
+            numerator = n1 * d2 + n2 * d1;
+            denominator = d1 * d2;
+        } else {
+            const bigint d1g = d1 / g;
+            const bigint t = n1 * (d2 / g) + n2 * d1g;
+            const bigint g2 = bigint::gcd(t, g);
+
+            if (g2 == 1)
+            {
+                numerator = t;
+                denominator = d1g * d2;
+            } else {
+                numerator = t / g2;
+                denominator = d1g * (d2 / g2);
+            }
+        }
+        if (numerator.is_zero())
+        {
+            denominator = 1;
+        }
+    }
+
+    /**
+     * Multiplies fractions n1 / d1 and n2 / d2, reducing the operands
+     * against each other before multiplying.
+     */
+    static void multiply_fractions(const bigint& n1,
+                                   const bigint& d1,
+                                   const bigint& n2,
+                                   const bigint& d2,
+                                   bigint& numerator,
+                                   bigint& denominator)
+    {
+        const bigint g1 = bigint::gcd(n1, d2);
+        const bigint g2 = bigint::gcd(n2, d1);
+
+        if (n1.is_zero() || n2.is_zero())
+        {
+            numerator = 0;
+            denominator = 1;
+            return;
+        }
+        numerator = (n1 / g1) * (n2 / g2);
+        denominator = (d1 / g2) * (d2 / g1);
+        if (denominator.is_negative())
+        {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+    }
+
+    big_ratio big_ratio::operator+(const big_ratio& that) const
+    {
+        big_ratio result;
+
+        add_fractions(m_numerator,
+                      m_denominator,
+                      that.m_numerator,
+                      that.m_denominator,
+                      result.m_numerator,
+                      result.m_denominator);
+
+        return result;
+    }
+
+    big_ratio big_ratio::operator-(const big_ratio& that) const
+    {
+        big_ratio result;
+
+        add_fractions(m_numerator,
+                      m_denominator,
+                      -that.m_numerator,
+                      that.m_denominator,
+                      result.m_numerator,
+                      result.m_denominator);
+
+        return result;
+    }
+
+    big_ratio big_ratio::operator*(const big_ratio& that) const
+    {
+        big_ratio result;
+
+        multiply_fractions(m_numerator,
+                           m_denominator,
+                           that.m_numerator,
+                           that.m_denominator,
+                           result.m_numerator,
+                           result.m_denominator);
+
+        return result;
+    }
+
+    big_ratio big_ratio::operator/(const big_ratio& that) const
+    {
+        big_ratio result;
+
+        if (that.m_numerator.is_zero())
+        {
+            throw std::domain_error("division by zero");
+        }
+        multiply_fractions(m_numerator,
+                           m_denominator,
+                           that.m_denominator,
+                           that.m_numerator,
+                           result.m_numerator,
+                           result.m_denominator);
+
+        return result;
+    }
+
+    big_ratio& big_ratio::operator+=(const big_ratio& that)
+    {
+        return assign(operator+(that));
+    }
+
+    big_ratio& big_ratio::operator-=(const big_ratio& that)
+    {
+        return assign(operator-(that));
+    }
+
+    big_ratio& big_ratio::operator*=(const big_ratio& that)
+    {
+        return assign(operator*(that));
+    }
+
+    big_ratio& big_ratio::operator/=(const big_ratio& that)
+    {
+        return assign(operator/(that));
+    }
+
+    std::ostream& operator<<(std::ostream& os, const big_ratio& ratio)
+    {
+        os << ratio.numerator() << '/' << ratio.denominator();
+
+        return os;
+    }
+}
@@ -0,0 +1,914 @@
+/*
+ * Copyright (c) 2014, peelo.net
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <peelo/number/bigint.hpp>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace peelo
+{
+    namespace
+    {
+        typedef uint32_t limb;
+        typedef uint64_t double_limb;
+        typedef std::vector<limb> limb_buffer;
+
+        /**
+         * Operand size in limbs from which Karatsuba's method is used.
+         */
+        const std::size_t karatsuba_threshold = 40;
+
+        /**
+         * Size in limbs below which decimal conversions are done one limb
+         * at a time instead of splitting the number.
+         */
+        const std::size_t conversion_threshold = 60;
+
+        /** Largest power of ten which fits into a limb. */
+        const limb chunk_base = 1000000000;
+        /** Number of decimal digits in one chunk. */
+        const std::size_t chunk_digits = 9;
+    }
+
+    static inline std::size_t trimmed_size(const limb* a, std::size_t n)
+    {
+        while (n > 0 && !a[n - 1])
+        {
+            --n;
+        }
+
+        return n;
+    }
+
+    static int compare_limbs(const limb* a,
+                             std::size_t an,
+                             const limb* b,
+                             std::size_t bn)
+    {
+        if (an != bn)
+        {
+            return an < bn ? -1 : 1;
+        }
+        for (std::size_t i = an; i-- > 0;)
+        {
+            if (a[i] != b[i])
+            {
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+
+        return 0;
+    }
+
+    /**
+     * Adds b into a in place. The result must fit into <i>an</i> limbs.
+     */
+    static void add_into(limb* a,
+                         std::size_t an,
+                         const limb* b,
+                         std::size_t bn)
+    {
+        double_limb carry = 0;
+        std::size_t i;
+
+        for (i = 0; i < bn; ++i)
+        {
+            carry += static_cast<double_limb>(a[i]) + b[i];
+            a[i] = static_cast<limb>(carry);
+            carry >>= 32;
+        }
+        for (; carry && i < an; ++i)
+        {
+            carry += a[i];
+            a[i] = static_cast<limb>(carry);
+            carry >>= 32;
+        }
+    }
+
+    /**
+     * Subtracts b from a in place. The magnitude of a must not be less
+     * than the magnitude of b.
+     */
+    static void subtract_from(limb* a,
+                              std::size_t an,
+                              const limb* b,
+                              std::size_t bn)
+    {
+        limb borrow = 0;
+        std::size_t i;
+
+        for (i = 0; i < bn; ++i)
+        {
+            const double_limb d = static_cast<double_limb>(a[i])
+                - b[i]
+                - borrow;
+
+            a[i] = static_cast<limb>(d);
+            borrow = static_cast<limb>(d >> 63);
+        }
+        for (; borrow && i < an; ++i)
+        {
+            borrow = !a[i];
+            --a[i];
+        }
+    }
+
+    /**
+     * Schoolbook multiplication into zero filled output of an + bn limbs.
+     */
+    static void multiply_schoolbook(const limb* a,
+                                    std::size_t an,
+                                    const limb* b,
+                                    std::size_t bn,
+                                    limb* out)
+    {
+        for (std::size_t j = 0; j < bn; ++j)
+        {
+            const double_limb factor = b[j];
+            double_limb carry = 0;
+
+            if (!factor)
+            {
+                continue;
+            }
+            for (std::size_t i = 0; i < an; ++i)
+            {
+                carry += a[i] * factor + out[i + j];
+                out[i + j] = static_cast<limb>(carry);
+                carry >>= 32;
+            }
+            out[j + an] = static_cast<limb>(carry);
+        }
+    }
+
+    /**
+     * Multiplies a and b into zero filled output of an + bn limbs.
+     */
+    static void multiply_limbs(const limb* a,
+                               std::size_t an,
+                               const limb* b,
+                               std::size_t bn,
+                               limb* out)
+    {
+        if (an < bn)
+        {
+            std::swap(a, b);
+            std::swap(an, bn);
+        }
+        if (bn < karatsuba_threshold)
+        {
+            multiply_schoolbook(a, an, b, bn, out);
+        }
+        else if (an >= 2 * bn)
+        {
+            // Unbalanced operands are multiplied in slices of the shorter
+            // length.
+            limb_buffer product(2 * bn);
+
+            for (std::size_t offset = 0; offset < an; offset += bn)
+            {
+                const std::size_t length = std::min(bn, an - offset);
+
+                std::fill(product.begin(), product.end(), 0);
+                multiply_limbs(a + offset, length, b, bn, product.data());
+                add_into(out + offset,
+                         an + bn - offset,
+                         product.data(),
+                         length + bn);
+            }
+        } else {
+            // With a = a1 * B^m + a0 and b = b1 * B^m + b0, the middle part
+            // a0 * b1 + a1 * b0 is (a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1.
+            const std::size_t m = (an + 1) / 2;
+            limb_buffer sa(m + 1);
+            limb_buffer sb(m + 1);
+            limb_buffer middle(2 * m + 2);
+            std::size_t length;
+
+            multiply_limbs(a, m, b, m, out);
+            multiply_limbs(a + m, an - m, b + m, bn - m, out + 2 * m);
+
+            std::copy(a, a + m, sa.begin());
+            add_into(sa.data(), m + 1, a + m, an - m);
+            std::copy(b, b + m, sb.begin());
+            add_into(sb.data(), m + 1, b + m, bn - m);
+            multiply_limbs(sa.data(), m + 1, sb.data(), m + 1, middle.data());
+            subtract_from(middle.data(), 2 * m + 2, out, 2 * m);
+            subtract_from(middle.data(),
+                          2 * m + 2,
+                          out + 2 * m,
+                          an + bn - 2 * m);
+            length = trimmed_size(middle.data(), 2 * m + 2);
+            add_into(out + m, an + bn - m, middle.data(), length);
+        }
+    }
+
+    /**
+     * Divides a in place by a single limb and returns the remainder. The
+     * divisor is a template parameter, so that division by a constant can
+     * be replaced with multiplication by the compiler.
+     */
+    template< limb Divisor >
+    static inline limb divide_by(limb* a, std::size_t n)
+    {
+        double_limb remainder = 0;
+
+        for (std::size_t i = n; i-- > 0;)
+        {
+            remainder = (remainder << 32) | a[i];
+            a[i] = static_cast<limb>(remainder / Divisor);
+            remainder %= Divisor;
+        }
+
+        return static_cast<limb>(remainder);
+    }
+
+    static limb divide_by(limb* a, std::size_t n, limb divisor)
+    {
+        double_limb remainder = 0;
+
+        for (std::size_t i = n; i-- > 0;)
+        {
+            remainder = (remainder << 32) | a[i];
+            a[i] = static_cast<limb>(remainder / divisor);
+            remainder %= divisor;
+        }
+
+        return static_cast<limb>(remainder);
+    }
+
+    static inline int leading_zeros(limb x)
+    {
+#if defined(__GNUC__)
+        return __builtin_clz(x);
+#else
+        int n = 0;
+
+        while (!(x & 0x80000000))
+        {
+            x <<= 1;
+            ++n;
+        }
+
+        return n;
+#endif
+    }
+
+    /**
+     * Long division of u by v, with v having at least two limbs and no
+     * leading zeros, using algorithm D from TAOCP 4.3.1. Quotient must have
+     * room for un - vn + 1 limbs and remainder for vn limbs.
+     */
+    static void divide_limbs(const limb* u,
+                             std::size_t un,
+                             const limb* v,
+                             std::size_t vn,
+                             limb* quotient,
+                             limb* remainder)
+    {
+        const int shift = leading_zeros(v[vn - 1]);
+        limb_buffer vs(vn);
+        limb_buffer us(un + 1);
+
+        // Normalize so that the most significant limb of the divisor has
+        // its highest bit set.
+        for (std::size_t i = vn - 1; i > 0; --i)
+        {
+            vs[i] = (v[i] << shift)
+                | static_cast<limb>(static_cast<double_limb>(v[i - 1])
+                                    >> (32 - shift));
+        }
+        vs[0] = v[0] << shift;
+        us[un] = static_cast<limb>(static_cast<double_limb>(u[un - 1])
+                                   >> (32 - shift));
+        for (std::size_t i = un - 1; i > 0; --i)
+        {
+            us[i] = (u[i] << shift)
+                | static_cast<limb>(static_cast<double_limb>(u[i - 1])
+                                    >> (32 - shift));
+        }
+        us[0] = u[0] << shift;
+
+        for (std::size_t j = un - vn + 1; j-- > 0;)
+        {
+            const double_limb top = (static_cast<double_limb>(us[j + vn]) << 32)
+                | us[j + vn - 1];
+            double_limb qhat = top / vs[vn - 1];
+            double_limb rhat = top % vs[vn - 1];
+            int64_t borrow = 0;
+            int64_t t;
+
+            while (qhat > 0xffffffff
+                   || qhat * vs[vn - 2] > ((rhat << 32) | us[j + vn - 2]))
+            {
+                --qhat;
+                rhat += vs[vn - 1];
+                if (rhat > 0xffffffff)
+                {
+                    break;
+                }
+            }
+
+            // Multiply and subtract.
+            for (std::size_t i = 0; i < vn; ++i)
+            {
+                const double_limb p = qhat * vs[i];
+
+                t = static_cast<int64_t>(us[i + j]) - borrow
+                    - static_cast<int64_t>(p & 0xffffffff);
+                us[i + j] = static_cast<limb>(t);
+                borrow = static_cast<int64_t>(p >> 32) - (t >> 32);
+            }
+            t = static_cast<int64_t>(us[j + vn]) - borrow;
+            us[j + vn] = static_cast<limb>(t);
+
+            quotient[j] = static_cast<limb>(qhat);
+            if (t < 0)
+            {
+                // Estimate was one too large, so add the divisor back.
+                double_limb carry = 0;
+
+                --quotient[j];
+                for (std::size_t i = 0; i < vn; ++i)
+                {
+                    carry += static_cast<double_limb>(us[i + j]) + vs[i];
+                    us[i + j] = static_cast<limb>(carry);
+                    carry >>= 32;
+                }
+                us[j + vn] += static_cast<limb>(carry);
+            }
+        }
+
+        // Unnormalize the remainder.
+        for (std::size_t i = 0; i < vn; ++i)
+        {
+            remainder[i] = (us[i] >> shift)
+                | static_cast<limb>(static_cast<double_limb>(us[i + 1])
+                                    << (32 - shift));
+        }
+    }
+
+    /**
+     * Divides magnitudes, which must not have leading zeros, storing
+     * trimmed quotient and remainder.
+     */
+    static void divide_buffers(const limb* u,
+                               std::size_t un,
+                               const limb* v,
+                               std::size_t vn,
+                               limb_buffer& quotient,
+                               limb_buffer& remainder)
+    {
+        if (compare_limbs(u, un, v, vn) < 0)
+        {
+            quotient.clear();
+            remainder.assign(u, u + un);
+
+            return;
+        }
+        quotient.assign(u, u + un);
+        if (vn == 1)
+        {
+            const limb r = divide_by(quotient.data(), un, v[0]);
+
+            remainder.assign(r ? 1 : 0, r);
+        } else {
+            quotient.resize(un - vn + 1);
+            remainder.resize(vn);
+            divide_limbs(u, un, v, vn, quotient.data(), remainder.data());
+            remainder.resize(trimmed_size(remainder.data(), vn));
+        }
+        quotient.resize(trimmed_size(quotient.data(), quotient.size()));
+    }
+
+    static void square(const limb_buffer& a, limb_buffer& result)
+    {
+        result.assign(2 * a.size(), 0);
+        multiply_limbs(a.data(), a.size(), a.data(), a.size(), result.data());
+        result.resize(trimmed_size(result.data(), result.size()));
+    }
+
+    /**
+     * Computes powers 10^(9 * 2^k) for as long as they are at most half
+     * the size of a number of <i>n</i> limbs.
+     */
+    static void decimal_powers(std::size_t n, std::vector<limb_buffer>& powers)
+    {
+        powers.assign(1, limb_buffer(1, chunk_base));
+        while (powers.back().size() * 2 <= n)
+        {
+            limb_buffer next;
+
+            square(powers.back(), next);
+            powers.push_back(next);
+        }
+    }
+
+    /**
+     * Appends decimal digits of a number into the output. When
+     * <i>width</i> is not zero, the output is padded with leading zeros
+     * into that many digits.
+     */
+    static void format_decimal(limb_buffer& value,
+                               const std::vector<limb_buffer>& powers,
+                               std::size_t level,
+                               std::size_t width,
+                               std::vector<char>& output)
+    {
+        if (value.size() < conversion_threshold || !level)
+        {
+            std::vector<limb> chunks;
+            std::size_t digits;
+            char buffer[chunk_digits];
+
+            while (!value.empty())
+            {
+                chunks.push_back(divide_by<chunk_base>(value.data(),
+                                                       value.size()));
+                value.resize(trimmed_size(value.data(), value.size()));
+            }
+            for (std::size_t i = chunks.size(); i-- > 0;)
+            {
+                limb chunk = chunks[i];
+
+                for (std::size_t j = chunk_digits; j-- > 0;)
+                {
+                    buffer[j] = static_cast<char>('0' + chunk % 10);
+                    chunk /= 10;
+                }
+                if (i + 1 == chunks.size() && !width)
+                {
+                    // Leading chunk of the whole number is not padded.
+                    digits = 0;
+                    while (digits < chunk_digits - 1 && buffer[digits] == '0')
+                    {
+                        ++digits;
+                    }
+                    output.insert(output.end(),
+                                  buffer + digits,
+                                  buffer + chunk_digits);
+                } else {
+                    output.insert(output.end(), buffer, buffer + chunk_digits);
+                }
+            }
+            if (width > chunks.size() * chunk_digits)
+            {
+                output.insert(output.end() - chunks.size() * chunk_digits,
+                              width - chunks.size() * chunk_digits,
+                              '0');
+            }
+
+            return;
+        }
+
+        const limb_buffer& power = powers[level - 1];
+        const std::size_t low_width = chunk_digits << (level - 1);
+        limb_buffer high;
+        limb_buffer low;
+
+        if (compare_limbs(value.data(), value.size(),
+                          power.data(), power.size()) < 0)
+        {
+            format_decimal(value, powers, level - 1, width, output);
+
+            return;
+        }
+        divide_buffers(value.data(), value.size(),
+                       power.data(), power.size(),
+                       high, low);
+        format_decimal(high,
+                       powers,
+                       level - 1,
+                       width ? width - low_width : 0,
+                       output);
+        format_decimal(low, powers, level - 1, low_width, output);
+    }
+
+    /**
+     * Parses decimal digits into magnitude.
+     */
+    static void parse_decimal(const char* input,
+                              std::size_t length,
+                              const std::vector<limb_buffer>& powers,
+                              limb_buffer& result)
+    {
+        std::size_t level = powers.size();
+
+        while (level > 0 && (chunk_digits << (level - 1)) >= length)
+        {
+            --level;
+        }
+        if (!level || length <= conversion_threshold * chunk_digits)
+        {
+            result.clear();
+            for (std::size_t i = 0; i < length;)
+            {
+                const std::size_t count = i == 0 && length % chunk_digits
+                    ? length % chunk_digits
+                    : chunk_digits;
+                limb chunk = 0;
+                limb scale = 1;
+                double_limb carry;
+
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    chunk = chunk * 10 + static_cast<limb>(input[i + j] - '0');
+                    scale *= 10;
+                }
+                i += count;
+                carry = chunk;
+                for (std::size_t j = 0; j < result.size(); ++j)
+                {
+                    carry += static_cast<double_limb>(result[j]) * scale;
+                    result[j] = static_cast<limb>(carry);
+                    carry >>= 32;
+                }
+                if (carry)
+                {
+                    result.push_back(static_cast<limb>(carry));
+                }
+            }
+
+            return;
+        }
+
+        const std::size_t low_width = chunk_digits << (level - 1);
+        const limb_buffer& power = powers[level - 1];
+        limb_buffer high;
+        limb_buffer low;
+
+        parse_decimal(input, length - low_width, powers, high);
+        parse_decimal(input + length - low_width, low_width, powers, low);
+        result.assign(high.size() + power.size() + 1, 0);
+        if (!high.empty())
+        {
+            multiply_limbs(high.data(), high.size(),
+                           power.data(), power.size(),
+                           result.data());
+        }
+        add_into(result.data(), result.size(), low.data(), low.size());
+        result.resize(trimmed_size(result.data(), result.size()));
+    }
+
+    bigint::bigint()
+        : m_negative(false) {}
+
+    bigint::bigint(const bigint& that)
+        : m_negative(that.m_negative)
+        , m_limbs(that.m_limbs) {}
+
+    bigint::bigint(int64_t n)
+        : m_negative(n < 0)
+    {
+        uint64_t magnitude = n < 0
+            ? 0 - static_cast<uint64_t>(n)
+            : static_cast<uint64_t>(n);
+
+        while (magnitude)
+        {
+            m_limbs.push_back(static_cast<limb>(magnitude));
+            magnitude >>= 32;
+        }
+    }
+
+    bigint bigint::parse(const string& input)
+    {
+        const string::size_type length = input.length();
+        std::vector<char> encoded(length);
+
+        for (string::size_type i = 0; i < length; ++i)
+        {
+            const rune::value_type c = input[i].code();
+
+            // Anything outside ASCII is rejected by parse() anyway.
+            encoded[i] = c < 0x80 ? static_cast<char>(c) : '?';
+        }
+
+        return parse(encoded.data(), length);
+    }
+
+    bigint bigint::parse(const char* input, std::size_t length)
+    {
+        bool negative = false;
+        std::vector<limb_buffer> powers;
+        limb_buffer magnitude;
+        bigint result;
+
+        if (length > 0 && (input[0] == '-' || input[0] == '+'))
+        {
+            negative = input[0] == '-';
+            ++input;
+            --length;
+        }
+        if (!length)
+        {
+            throw std::invalid_argument("invalid integer");
+        }
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            if (input[i] < '0' || input[i] > '9')
+            {
+                throw std::invalid_argument("invalid integer");
+            }
+        }
+        // Roughly 9.63 decimal digits fit into each limb.
+        decimal_powers(length * 10 / 96 + 1, powers);
+        parse_decimal(input, length, powers, magnitude);
+        result.m_limbs.resize(magnitude.size());
+        std::copy(magnitude.begin(), magnitude.end(), result.m_limbs.data());
+        result.m_negative = negative;
+        result.trim();
+
+        return result;
+    }
+
+    bigint bigint::gcd(const bigint& a, const bigint& b)
+    {
+        bigint x(a);
+        bigint y(b);
+        bigint quotient;
+        bigint remainder;
+
+        x.m_negative = y.m_negative = false;
+        while (!y.is_zero())
+        {
+            divide(x, y, quotient, remainder);
+            x = y;
+            y = remainder;
+        }
+
+        return x;
+    }
+
+    void bigint::divide(const bigint& a,
+                        const bigint& b,
+                        bigint& quotient,
+                        bigint& remainder)
+    {
+        limb_buffer q;
+        limb_buffer r;
+        const bool negative_quotient = a.m_negative != b.m_negative;
+        const bool negative_remainder = a.m_negative;
+
+        if (b.is_zero())
+        {
+            throw std::domain_error("division by zero");
+        }
+        divide_buffers(a.m_limbs.data(), a.m_limbs.size(),
+                       b.m_limbs.data(), b.m_limbs.size(),
+                       q, r);
+        quotient.m_limbs.resize(q.size());
+        std::copy(q.begin(), q.end(), quotient.m_limbs.data());
+        quotient.m_negative = negative_quotient;
+        quotient.trim();
+        remainder.m_limbs.resize(r.size());
+        std::copy(r.begin(), r.end(), remainder.m_limbs.data());
+        remainder.m_negative = negative_remainder;
+        remainder.trim();
+    }
+
+    bool bigint::fits_int64() const
+    {
+        uint64_t magnitude;
+
+        if (m_limbs.size() > 2)
+        {
+            return false;
+        }
+        magnitude = m_limbs.size() > 0 ? m_limbs[0] : 0;
+        if (m_limbs.size() > 1)
+        {
+            magnitude |= static_cast<uint64_t>(m_limbs[1]) << 32;
+        }
+
+        return magnitude <= static_cast<uint64_t>(
+            std::numeric_limits<int64_t>::max()
+        ) + (m_negative ? 1 : 0);
+    }
+
+    int64_t bigint::to_int64() const
+    {
+        uint64_t magnitude = 0;
+
+        if (!fits_int64())
+        {
+            throw std::overflow_error("integer does not fit into 64 bits");
+        }
+        for (std::size_t i = m_limbs.size(); i-- > 0;)
+        {
+            magnitude = (magnitude << 32) | m_limbs[i];
+        }
+
+        return m_negative
+            ? static_cast<int64_t>(0 - magnitude)
+            : static_cast<int64_t>(magnitude);
+    }
+
+    string bigint::to_string() const
+    {
+        std::vector<limb_buffer> powers;
+        limb_buffer value(m_limbs.data(), m_limbs.data() + m_limbs.size());
+        std::vector<char> output;
+
+        if (is_zero())
+        {
+            return string("0");
+        }
+        if (m_negative)
+        {
+            output.push_back('-');
+        }
+        output.reserve(m_limbs.size() * 10 + 2);
+        decimal_powers(m_limbs.size(), powers);
+        format_decimal(value, powers, powers.size(), 0, output);
+
+        return string(output.data(), output.size());
+    }
+
+    bigint& bigint::assign(const bigint& that)
+    {
+        m_negative = that.m_negative;
+        m_limbs = that.m_limbs;
+
+        return *this;
+    }
+
+    bool bigint::equals(const bigint& that) const
+    {
+        return m_negative == that.m_negative
+            && !compare_limbs(m_limbs.data(), m_limbs.size(),
+                              that.m_limbs.data(), that.m_limbs.size());
+    }
+
+    int bigint::compare(const bigint& that) const
+    {
+        int result;
+
+        if (m_negative != that.m_negative)
+        {
+            return m_negative ? -1 : 1;
+        }
+        result = compare_limbs(m_limbs.data(), m_limbs.size(),
+                               that.m_limbs.data(), that.m_limbs.size());
+
+        return m_negative ? -result : result;
+    }
+
+    bigint bigint::operator-() const
+    {
+        bigint result(*this);
+
+        if (!result.is_zero())
+        {
+            result.m_negative = !m_negative;
+        }
+
+        return result;
+    }
+
+    bigint& bigint::add(const bigint& that, bool negative)
+    {
+        const std::size_t size = m_limbs.size();
+        const std::size_t that_size = that.m_limbs.size();
+
+        if (&that == this)
+        {
+            return add(bigint(that), negative);
+        }
+        if (m_negative == negative)
+        {
+            m_limbs.resize(std::max(size, that_size) + 1, 0);
+            add_into(m_limbs.data(), m_limbs.size(),
+                     that.m_limbs.data(), that_size);
+        }
+        else if (compare_limbs(m_limbs.data(), size,
+                               that.m_limbs.data(), that_size) >= 0)
+        {
+            subtract_from(m_limbs.data(), size, that.m_limbs.data(), that_size);
+        } else {
+            limb_vector difference(that.m_limbs);
+
+            subtract_from(difference.data(), that_size, m_limbs.data(), size);
+            m_limbs = difference;
+            m_negative = negative;
+        }
+        trim();
+
+        return *this;
+    }
+
+    void bigint::trim()
+    {
+        while (!m_limbs.empty() && !m_limbs.back())
+        {
+            m_limbs.pop_back();
+        }
+        if (m_limbs.empty())
+        {
+            m_negative = false;
+        }
+    }
+
+    bigint bigint::operator+(const bigint& that) const
+    {
+        return bigint(*this).add(that, that.m_negative);
+    }
+
+    bigint bigint::operator-(const bigint& that) const
+    {
+        return bigint(*this).add(that, !that.m_negative);
+    }
+
+    bigint bigint::operator*(const bigint& that) const
+    {
+        bigint result;
+
+        if (is_zero() || that.is_zero())
+        {
+            return result;
+        }
+        result.m_limbs.resize(m_limbs.size() + that.m_limbs.size(), 0);
+        multiply_limbs(m_limbs.data(), m_limbs.size(),
+                       that.m_limbs.data(), that.m_limbs.size(),
+                       result.m_limbs.data());
+        result.m_negative = m_negative != that.m_negative;
+        result.trim();
+
+        return result;
+    }
+
+    bigint bigint::operator/(const bigint& that) const
+    {
+        bigint quotient;
+        bigint remainder;
+
+        divide(*this, that, quotient, remainder);
+
+        return quotient;
+    }
+
+    bigint bigint::operator%(const bigint& that) const
+    {
+        bigint quotient;
+        bigint remainder;
+
+        divide(*this, that, quotient, remainder);
+
+        return remainder;
+    }
+
+    bigint& bigint::operator+=(const bigint& that)
+    {
+        return add(that, that.m_negative);
+    }
+
+    bigint& bigint::operator-=(const bigint& that)
+    {
+        return add(that, !that.m_negative);
+    }
+
+    bigint& bigint::operator*=(const bigint& that)
+    {
+        return assign(operator*(that));
+    }
+
+    bigint& bigint::operator/=(const bigint& that)
+    {
+        return assign(operator/(that));
+    }
+
+    bigint& bigint::operator%=(const bigint& that)
+    {
+        return assign(operator%(that));
+    }
+
+    std::ostream& operator<<(std::ostream& os, const bigint& n)
+    {
+        os << n.to_string();
+
+        return os;
+    }
+}
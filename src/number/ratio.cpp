@@ -24,36 +24,199 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <peelo/number/ratio.hpp>
+#include <limits>
 
 namespace peelo
 {
-    static inline int64_t gcd(int64_t a, int64_t b)
+    namespace
     {
-        return b == 0 ? a : gcd(b, a % b);
+#if defined(__SIZEOF_INT128__)
+        /**
+         * Unsigned type for intermediate results. Products of two 64-bit
+         * magnitudes and sums of two such products always fit into it.
+         */
+        __extension__ typedef unsigned __int128 wide_uint;
+#else
+        typedef uint64_t wide_uint;
+#endif
+    }
+
+    static const uint64_t max_uint64 = std::numeric_limits<uint64_t>::max();
+    static const uint64_t max_int64 = std::numeric_limits<int64_t>::max();
+
+    static inline int trailing_zeros(uint64_t x)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(x);
+#else
+        int n = 0;
+
+        while (!(x & 1))
+        {
+            x >>= 1;
+            ++n;
+        }
+
+        return n;
+#endif
+    }
+
+    /**
+     * Binary greatest common divisor, which needs no divisions.
+     */
+    static uint64_t gcd(uint64_t a, uint64_t b)
+    {
+        int shift;
+
+        if (!a)
+        {
+            return b;
+        }
+        else if (!b)
+        {
+            return a;
+        }
+        shift = trailing_zeros(a | b);
+        a >>= trailing_zeros(a);
+        do
+        {
+            b >>= trailing_zeros(b);
+            if (a > b)
+            {
+                const uint64_t t = a;
+
+                a = b;
+                b = t;
+            }
+            b -= a;
+        }
+        while (b);
+
+        return a << shift;
+    }
+
+    static inline uint64_t magnitude(int64_t n)
+    {
+        return n < 0 ? 0 - static_cast<uint64_t>(n) : static_cast<uint64_t>(n);
+    }
+
+    /**
+     * Multiplies two magnitudes. Can overflow only when there is no 128-bit
+     * type for the intermediate results.
+     */
+    static inline bool multiply(wide_uint a, wide_uint b, wide_uint& result)
+    {
+        if (sizeof(wide_uint) == sizeof(uint64_t) && a && b > max_uint64 / a)
+        {
+            return false;
+        }
+        result = a * b;
+
+        return true;
+    }
+
+    static inline bool add(wide_uint a, wide_uint b, wide_uint& result)
+    {
+        if (sizeof(wide_uint) == sizeof(uint64_t) && a > max_uint64 - b)
+        {
+            return false;
+        }
+        result = a + b;
+
+        return true;
+    }
+
+    /**
+     * Compares fractions a / b and c / d of magnitudes.
+     */
+    static int compare_magnitudes(uint64_t a,
+                                  uint64_t b,
+                                  uint64_t c,
+                                  uint64_t d)
+    {
+#if defined(__SIZEOF_INT128__)
+        const wide_uint left = static_cast<wide_uint>(a) * d;
+        const wide_uint right = static_cast<wide_uint>(c) * b;
+
+        return left < right ? -1 : left > right ? 1 : 0;
+#else
+        // Compare the continued fraction expansions, which avoids the
+        // products that would overflow.
+        for (int sign = 1;; sign = -sign)
+        {
+            const uint64_t q1 = a / b;
+            const uint64_t q2 = c / d;
+            uint64_t t;
+
+            if (q1 != q2)
+            {
+                return q1 < q2 ? -sign : sign;
+            }
+            a %= b;
+            c %= d;
+            if (!a || !c)
+            {
+                return !a && !c ? 0 : !a ? -sign : sign;
+            }
+            t = a;
+            a = b;
+            b = t;
+            t = c;
+            c = d;
+            d = t;
+        }
+#endif
     }
 
     ratio::ratio()
         : m_numerator(0)
-        , m_denominator(0) {}
+        , m_denominator(1) {}
 
     ratio::ratio(const ratio& that)
         : m_numerator(that.m_numerator)
         , m_denominator(that.m_denominator) {}
 
     ratio::ratio(int64_t numerator, int64_t denominator)
-        throw(std::domain_error)
         : m_numerator(0)
-        , m_denominator(0)
+        , m_denominator(1)
     {
+        uint64_t g;
+
         if (denominator == 0)
         {
             throw std::domain_error("division by zero");
         }
+        g = gcd(magnitude(numerator), magnitude(denominator));
+        if (!set_reduced((numerator < 0) != (denominator < 0),
+                         magnitude(numerator) / g,
+                         magnitude(denominator) / g))
+        {
+            throw std::overflow_error("rational number overflow");
+        }
+    }
+
+    bool ratio::set_reduced(bool negative,
+                            uint64_t numerator,
+                            uint64_t denominator)
+    {
+        if (!numerator)
+        {
+            m_numerator = 0;
+            m_denominator = 1;
 
-        const int64_t g = gcd(numerator, denominator);
+            return true;
+        }
+        else if (denominator > max_int64
+                 || numerator > max_int64 + (negative ? 1 : 0))
+        {
+            return false;
+        }
+        m_numerator = negative
+            ? static_cast<int64_t>(0 - numerator)
+            : static_cast<int64_t>(numerator);
+        m_denominator = static_cast<int64_t>(denominator);
 
-        m_numerator = numerator / g;
-        m_denominator = denominator / g;
+        return true;
     }
 
     ratio& ratio::assign(const ratio& that)
@@ -72,23 +235,221 @@ namespace peelo
 
     int ratio::compare(const ratio& that) const
     {
-        const int64_t a = m_numerator * that.m_numerator;
-        const int64_t b = m_denominator * that.m_denominator;
+        const bool negative = m_numerator < 0;
+        int result;
+
+        if (negative != (that.m_numerator < 0))
+        {
+            return negative ? -1 : 1;
+        }
+        result = compare_magnitudes(magnitude(m_numerator),
+                                    static_cast<uint64_t>(m_denominator),
+                                    magnitude(that.m_numerator),
+                                    static_cast<uint64_t>(that.m_denominator));
+
+        return negative ? -result : result;
+    }
+
+    /**
+     * Adds or subtracts fractions given as signs and magnitudes, reducing
+     * the denominators against each other first as described by Knuth in
+     * TAOCP 4.5.1.
+     */
+    static bool add_fractions(bool negative1,
+                              uint64_t n1,
+                              uint64_t d1,
+                              bool negative2,
+                              uint64_t n2,
+                              uint64_t d2,
+                              bool& negative,
+                              uint64_t& numerator,
+                              uint64_t& denominator)
+    {
+        const uint64_t g = gcd(d1, d2);
+        wide_uint a;
+        wide_uint b;
+        wide_uint t;
+        wide_uint d;
+        uint64_t g2;
+
+        if (!multiply(n1, d2 / g, a) || !multiply(n2, d1 / g, b))
+        {
+            return false;
+        }
+        if (negative1 == negative2)
+        {
+            if (!add(a, b, t))
+            {
+                return false;
+            }
+            negative = negative1;
+        }
+        else if (a >= b)
+        {
+            t = a - b;
+            negative = negative1;
+        } else {
+            t = b - a;
+            negative = negative2;
+        }
+        if (!t)
+        {
+            numerator = 0;
+            denominator = 1;
+
+            return true;
+        }
+        g2 = gcd(static_cast<uint64_t>(t % g), g);
+        t /= g2;
+        if (t > max_uint64 || !multiply(d1 / g, d2 / g2, d) || d > max_uint64)
+        {
+            return false;
+        }
+        numerator = static_cast<uint64_t>(t);
+        denominator = static_cast<uint64_t>(d);
+
+        return true;
+    }
+
+    /**
+     * Multiplies fractions given as magnitudes, reducing each numerator
+     * against the opposite denominator first so that the product is already
+     * in lowest terms.
+     */
+    static bool multiply_fractions(uint64_t n1,
+                                   uint64_t d1,
+                                   uint64_t n2,
+                                   uint64_t d2,
+                                   uint64_t& numerator,
+                                   uint64_t& denominator)
+    {
+        const uint64_t g1 = gcd(n1, d2);
+        const uint64_t g2 = gcd(n2, d1);
+        wide_uint n;
+        wide_uint d;
+
+        if (!n1 || !n2)
+        {
+            numerator = 0;
+            denominator = 1;
+
+            return true;
+        }
+        if (!multiply(n1 / g1, n2 / g2, n)
+            || !multiply(d1 / g2, d2 / g1, d)
+            || n > max_uint64
+            || d > max_uint64)
+        {
+            return false;
+        }
+        numerator = static_cast<uint64_t>(n);
+        denominator = static_cast<uint64_t>(d);
+
+        return true;
+    }
+
+    bool ratio::checked_add(const ratio& that, ratio& result) const
+    {
+        bool negative;
+        uint64_t numerator;
+        uint64_t denominator;
+
+        return add_fractions(m_numerator < 0,
+                             magnitude(m_numerator),
+                             static_cast<uint64_t>(m_denominator),
+                             that.m_numerator < 0,
+                             magnitude(that.m_numerator),
+                             static_cast<uint64_t>(that.m_denominator),
+                             negative,
+                             numerator,
+                             denominator)
+            && result.set_reduced(negative, numerator, denominator);
+    }
+
+    bool ratio::checked_subtract(const ratio& that, ratio& result) const
+    {
+        bool negative;
+        uint64_t numerator;
+        uint64_t denominator;
+
+        return add_fractions(m_numerator < 0,
+                             magnitude(m_numerator),
+                             static_cast<uint64_t>(m_denominator),
+                             !(that.m_numerator < 0),
+                             magnitude(that.m_numerator),
+                             static_cast<uint64_t>(that.m_denominator),
+                             negative,
+                             numerator,
+                             denominator)
+            && result.set_reduced(negative, numerator, denominator);
+    }
+
+    bool ratio::checked_multiply(const ratio& that, ratio& result) const
+    {
+        uint64_t numerator;
+        uint64_t denominator;
+
+        return multiply_fractions(magnitude(m_numerator),
+                                  static_cast<uint64_t>(m_denominator),
+                                  magnitude(that.m_numerator),
+                                  static_cast<uint64_t>(that.m_denominator),
+                                  numerator,
+                                  denominator)
+            && result.set_reduced((m_numerator < 0) != (that.m_numerator < 0),
+                                  numerator,
+                                  denominator);
+    }
+
+    bool ratio::checked_divide(const ratio& that, ratio& result) const
+    {
+        uint64_t numerator;
+        uint64_t denominator;
+
+        if (!that.m_numerator)
+        {
+            throw std::domain_error("division by zero");
+        }
+
+        return multiply_fractions(magnitude(m_numerator),
+                                  static_cast<uint64_t>(m_denominator),
+                                  static_cast<uint64_t>(that.m_denominator),
+                                  magnitude(that.m_numerator),
+                                  numerator,
+                                  denominator)
+            && result.set_reduced((m_numerator < 0) != (that.m_numerator < 0),
+                                  numerator,
+                                  denominator);
+    }
 
-        return a < b ? -1 : a > b ? 1 : 0;
+    static void overflow()
+    {
+        throw std::overflow_error("rational number overflow");
     }
 
     ratio ratio::operator-() const
     {
-        return ratio(-m_numerator, m_denominator);
+        ratio result;
+
+        if (!result.set_reduced(m_numerator > 0,
+                                magnitude(m_numerator),
+                                static_cast<uint64_t>(m_denominator)))
+        {
+            overflow();
+        }
+
+        return result;
     }
 
     ratio ratio::operator+(const ratio& that) const
     {
-        return ratio(
-                m_numerator * that.m_numerator + m_denominator * that.m_denominator,
-                m_denominator * that.m_denominator
-        );
+        ratio result;
+
+        if (!checked_add(that, result))
+        {
+            overflow();
+        }
+
+        return result;
     }
 
     ratio ratio::operator+(int64_t n) const
@@ -98,10 +459,14 @@ namespace peelo
 
     ratio ratio::operator-(const ratio& that) const
     {
-        return ratio(
-                m_numerator * that.m_numerator - m_denominator * that.m_denominator,
-                m_denominator * that.m_denominator
-        );
+        ratio result;
+
+        if (!checked_subtract(that, result))
+        {
+            overflow();
+        }
+
+        return result;
     }
 
     ratio ratio::operator-(int64_t n) const
@@ -111,10 +476,14 @@ namespace peelo
 
     ratio ratio::operator*(const ratio& that) const
     {
-        return ratio(
-                m_numerator * that.m_numerator,
-                m_denominator * that.m_denominator
-        );
+        ratio result;
+
+        if (!checked_multiply(that, result))
+        {
+            overflow();
+        }
+
+        return result;
     }
 
     ratio ratio::operator*(int64_t n) const
@@ -124,10 +493,14 @@ namespace peelo
 
     ratio ratio::operator/(const ratio& that) const
     {
-        return ratio(
-                m_numerator * that.m_denominator,
-                m_denominator * that.m_numerator
-        );
+        ratio result;
+
+        if (!checked_divide(that, result))
+        {
+            overflow();
+        }
+
+        return result;
     }
 
     ratio ratio::operator/(int64_t n) const
@@ -137,7 +510,7 @@ namespace peelo
 
     ratio& ratio::operator+=(const ratio& that)
     {
-        return *this;
+        return assign(operator+(that));
     }
 
     ratio& ratio::operator+=(int64_t n)
@@ -147,7 +520,7 @@ namespace peelo
 
     ratio& ratio::operator-=(const ratio& that)
     {
-        return *this;
+        return assign(operator-(that));
     }
 
     ratio& ratio::operator-=(int64_t n)
@@ -157,7 +530,7 @@ namespace peelo
 
     ratio& ratio::operator*=(const ratio& that)
     {
-        return *this;
+        return assign(operator*(that));
     }
 
     ratio& ratio::operator*=(int64_t n)
@@ -167,7 +540,7 @@ namespace peelo
 
     ratio& ratio::operator/=(const ratio& that)
     {
-        return *this;
+        return assign(operator/(that));
     }
 
     ratio& ratio::operator/=(int64_t n)
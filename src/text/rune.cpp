@@ -32,9 +32,6 @@ namespace peelo
     const rune rune::min(0);
     const rune rune::max(0x10ffff);
 
-    rune::rune()
-        : m_code(0) {}
-
     rune::rune(value_type code)
         : m_code(code)
     {
@@ -44,9 +41,6 @@ namespace peelo
         }
     }
 
-    rune::rune(const rune& that)
-        : m_code(that.m_code) {}
-
     rune& rune::assign(const rune& that)
     {
         m_code = that.m_code;
@@ -164,6 +164,60 @@ namespace peelo
         }
     }
 
+    string::string(const char* input, size_type length)
+        : m_offset(0)
+        , m_length(0)
+        , m_runes(0)
+        , m_counter(0)
+    {
+        const char* end = input + length;
+        const char* p;
+        size_type index = 0;
+
+        for (p = input; p < end;)
+        {
+            const size_type size = utf8_decode_size(*p);
+
+            if (!size || size > static_cast<size_type>(end - p))
+            {
+                break;
+            }
+            ++m_length;
+            p += size;
+        }
+        if (!m_length)
+        {
+            return;
+        }
+        m_runes = new rune[m_length];
+        m_counter = new unsigned(1);
+        for (p = input; index < m_length;)
+        {
+            const size_type size = utf8_decode_size(*p);
+            rune::value_type result;
+
+            if (size == 1)
+            {
+                m_runes[index++] = static_cast<rune::value_type>(*p++);
+                continue;
+            }
+            result = *p & (0x7f >> size);
+            for (size_type i = 1; i < size; ++i)
+            {
+                if ((p[i] & 0xc0) != 0x80)
+                {
+                    // Malformed sequence ends the string.
+                    m_length = index;
+
+                    return;
+                }
+                result = (result << 6) | (p[i] & 0x3f);
+            }
+            m_runes[index++] = result;
+            p += size;
+        }
+    }
+
     string::~string()
     {
         if (m_counter && !--(*m_counter))
@@ -394,13 +448,15 @@ namespace peelo
 
     bool string::equals(const string& that) const
     {
-        if (m_runes == that.m_runes)
+        if (m_length != that.m_length)
         {
-            return m_offset == that.m_offset && m_length == that.m_length;
+            return false;
         }
-        else if (m_length != that.m_length)
+        else if (m_runes == that.m_runes && m_offset == that.m_offset)
         {
-            return false;
+            // Substrings of the same buffer at different offsets can still
+            // be equal, so only identical ones are decided here.
+            return true;
         }
         for (size_type i = 0; i < m_length; ++i)
         {
@@ -415,13 +471,15 @@ namespace peelo
 
     bool string::equals_icase(const string& that) const
     {
-        if (m_runes == that.m_runes)
+        if (m_length != that.m_length)
         {
-            return m_offset == that.m_offset && m_length == that.m_length;
+            return false;
         }
-        else if (m_length != that.m_length)
+        else if (m_runes == that.m_runes && m_offset == that.m_offset)
         {
-            return false;
+            // Substrings of the same buffer at different offsets can still
+            // be equal, so only identical ones are decided here.
+            return true;
         }
         for (size_type i = 0; i < m_length; ++i)
         {
@@ -904,7 +962,8 @@ namespace peelo
                 size += 4;
             }
         }
-        result.reserve(size);
+        // Room for the terminating null byte as well.
+        result.reserve(size + 1);
         for (size_type i = 0; i < m_length; ++i)
         {
             const rune::value_type c = m_runes[m_offset + i].code();
@@ -0,0 +1,55 @@
+#include <peelo/chrono/civil_fields.hpp>
+#include <peelo/chrono/datetime.hpp>
+#include <cassert>
+#include <cstring>
+
+int main()
+{
+    const int64_t timestamps[] = { -86401, 0, 951782400, 1137283200 + 3723 };
+    const std::size_t count = sizeof(timestamps) / sizeof(timestamps[0]);
+    peelo::civil_fields fields[count];
+    int64_t converted[count];
+
+    peelo::to_civil(timestamps, count, fields);
+    peelo::from_civil(fields, count, converted);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const peelo::datetime dt(static_cast<long>(timestamps[i]), peelo::time_zone::utc());
+
+        assert(fields[i].year == dt.year());
+        assert(fields[i].month == dt.month().index());
+        assert(fields[i].day == dt.day());
+        assert(fields[i].hour == dt.hour());
+        assert(fields[i].minute == dt.minute());
+        assert(fields[i].second == dt.second());
+        assert(fields[i].weekday == dt.day_of_week().index());
+        assert(fields[i].day_of_year == dt.day_of_year());
+        assert(converted[i] == timestamps[i]);
+    }
+
+    // Batches with a date outside the fast range take the general path,
+    // which must give identical results.
+    const std::size_t many = 600;
+    int64_t spread[many];
+    int64_t mixed[many];
+    peelo::civil_fields fast[many];
+    peelo::civil_fields general[many];
+
+    for (std::size_t i = 0; i < many; ++i)
+    {
+        spread[i] = (static_cast<int64_t>(i) - 300) * 7654321987LL + 12345;
+        mixed[i] = spread[i];
+    }
+    mixed[0] = mixed[many - 1] = INT64_C(40000000000000);
+    peelo::to_civil(spread, many, fast);
+    peelo::to_civil(mixed, many, general);
+    for (std::size_t i = 1; i < many - 1; ++i)
+    {
+        assert(!std::memcmp(&fast[i], &general[i], sizeof(fast[i])));
+    }
+    assert(general[0].year == 1269519);
+    assert(general[0].month == 7);
+    assert(general[0].day == 17);
+
+    return 0;
+}
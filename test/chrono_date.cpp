@@ -8,6 +8,16 @@ int main()
     assert(date.day_of_year() == 15);
     assert(date.day_of_week() == peelo::weekday::sun);
     assert(!date.is_leap_year());
+    assert(date.timestamp() == 1137283200L);
+    assert(peelo::date(1969, peelo::month::dec, 31).timestamp() == -86400L);
+    assert(peelo::date(2000, peelo::month::dec, 31).day_of_year() == 366);
+    assert(date.next(peelo::weekday::sun) == peelo::date(2006, peelo::month::jan, 22));
+    assert(date.previous(peelo::weekday::fri) == peelo::date(2006, peelo::month::jan, 13));
+    assert(peelo::date::nth_weekday(2006, peelo::month::nov, peelo::weekday::thu, 4)
+           == peelo::date(2006, peelo::month::nov, 23));
+    assert(peelo::date::nth_weekday(2006, peelo::month::may, peelo::weekday::mon, -1)
+           == peelo::date(2006, peelo::month::may, 29));
+    assert((date - peelo::date(2005, peelo::month::jan, 15)).days() == 365);
 
     return 0;
 }
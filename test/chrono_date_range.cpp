@@ -0,0 +1,58 @@
+#include <peelo/chrono/date_range.hpp>
+#include <cassert>
+
+int main()
+{
+    using peelo::date;
+    using peelo::date_range;
+    using peelo::month;
+
+    date_range days(date(2024, month::feb, 27), date(2024, month::mar, 2));
+
+    assert(days.size() == 4);
+    assert(days[2] == date(2024, month::feb, 29));
+    assert(*days.begin() == date(2024, month::feb, 27));
+
+    date_range weeks(
+            date(2024, month::jan, 1),
+            date(2024, month::feb, 1),
+            date_range::weeks,
+            2
+    );
+
+    assert(weeks.size() == 3);
+    assert(weeks[2] == date(2024, month::jan, 29));
+
+    date_range months(
+            date(2023, month::jan, 31),
+            date(2023, month::may, 31),
+            date_range::months
+    );
+
+    assert(months.size() == 4);
+    assert(months[1] == date(2023, month::feb, 28));
+    assert(months[2] == date(2023, month::mar, 31));
+
+    // Starts from Saturday, so the first business day is the next Monday.
+    date_range business(
+            date(2024, month::mar, 2),
+            date(2024, month::mar, 16),
+            date_range::business_days
+    );
+    int count = 0;
+
+    assert(business.size() == 10);
+    assert(business[0] == date(2024, month::mar, 4));
+    assert(business[5] == date(2024, month::mar, 11));
+    for (date_range::iterator i = business.begin(); i != business.end(); ++i)
+    {
+        assert(!(*i).day_of_week().is_weekend());
+        ++count;
+    }
+    assert(count == 10);
+
+    assert(date_range(date(2024, month::mar, 2),
+                      date(2024, month::mar, 2)).empty());
+
+    return 0;
+}
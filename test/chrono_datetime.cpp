@@ -0,0 +1,54 @@
+#include <peelo/chrono/datetime.hpp>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+int main()
+{
+    const peelo::datetime dt(2014, peelo::month::jun, 17, 23, 59, 59, 750000000);
+    const peelo::datetime later = dt + peelo::duration::from_milliseconds(500);
+
+    assert(later == peelo::datetime(2014, peelo::month::jun, 18, 0, 0, 0, 250000000));
+    assert((later - dt).milliseconds() == 500);
+    assert(later - peelo::duration::from_milliseconds(500) == dt);
+    assert(dt.nanosecond() == 750000000);
+
+    char buffer[peelo::datetime::iso8601_buffer_size];
+    const char* input = "2014-06-18T03:00:00.25+03:00";
+
+    assert(peelo::datetime::parse_iso8601(input, std::strlen(input)) == later);
+    assert(later.format_iso8601(buffer) == 24);
+    assert(!std::strcmp(buffer, "2014-06-18T00:00:00.250Z"));
+    assert(peelo::datetime::parse_iso8601(later.format_iso8601()) == later);
+    try
+    {
+        peelo::datetime::parse_iso8601("2014-06-18T24:00:00Z");
+        assert(false);
+    }
+    catch (std::invalid_argument&) {}
+
+    // Years outside 0 to 9999 use the expanded form and read back.
+    const peelo::datetime far(10000, peelo::month::jan, 1, 12, 0, 0);
+    const peelo::datetime bc(-1, peelo::month::dec, 31, 0, 0, 0);
+
+    assert(far.format_iso8601() == "+10000-01-01T12:00:00Z");
+    assert(peelo::datetime::parse_iso8601(far.format_iso8601()) == far);
+    assert(bc.format_iso8601() == "-0001-12-31T00:00:00Z");
+    assert(peelo::datetime::parse_iso8601(bc.format_iso8601()) == bc);
+    assert(peelo::datetime::parse_iso8601("+2014-06-18T00:00:00.25Z")
+           == later);
+    try
+    {
+        peelo::datetime::parse_iso8601("+201-06-18");
+        assert(false);
+    }
+    catch (std::invalid_argument&) {}
+    try
+    {
+        peelo::datetime::parse_iso8601("+99999999999-01-01");
+        assert(false);
+    }
+    catch (std::invalid_argument&) {}
+
+    return 0;
+}
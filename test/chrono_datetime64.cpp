@@ -0,0 +1,29 @@
+#include <peelo/chrono/datetime64.hpp>
+#include <cassert>
+#include <stdexcept>
+
+int main()
+{
+    const peelo::date d(1969, peelo::month::dec, 31);
+    const peelo::datetime dt(1969, peelo::month::dec, 31, 23, 59, 59, 500);
+    const peelo::date32 compact_date(d);
+    const peelo::datetime64 compact(dt);
+
+    assert(compact_date.days() == -1);
+    assert(compact_date.to_date() == d);
+    assert(compact_date + 1 == peelo::date32(peelo::date(1970, peelo::month::jan, 1)));
+    assert(compact.nanoseconds() == -999999500LL);
+    assert(compact.timestamp() == -1);
+    assert(compact.to_datetime() == dt);
+    assert(compact.to_date32() == compact_date);
+    assert(peelo::datetime64(compact_date) < compact);
+    assert((compact + peelo::duration::from_nanoseconds(999999500LL)).nanoseconds() == 0);
+    try
+    {
+        peelo::datetime64 overflow(peelo::datetime(2300, peelo::month::jan, 1));
+        assert(false);
+    }
+    catch (std::out_of_range&) {}
+
+    return 0;
+}
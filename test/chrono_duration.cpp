@@ -6,6 +6,13 @@ int main()
     peelo::duration duration = peelo::date::today() - peelo::date::yesterday();
 
     assert(duration.days() == 1);
+    assert(duration.nanoseconds() == 86400000000000LL);
+
+    duration = peelo::duration::from_microseconds(1500);
+    assert(duration.milliseconds() == 1);
+    assert(duration.microseconds() == 1500);
+    assert(duration.seconds() == 0);
+    assert(peelo::duration(25000).seconds() == 25000LL * 86400);
 
     return 0;
 }
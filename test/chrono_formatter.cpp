@@ -0,0 +1,40 @@
+#include <peelo/chrono/formatter.hpp>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+int main()
+{
+    const peelo::datetime dt(2006, peelo::month::jan, 5, 15, 4, 7, 123456789);
+    const peelo::formatter formatter("%a, %d %b %Y %T.%f %p %j%%");
+    char buffer[64];
+
+    assert(formatter.format(dt, buffer, sizeof(buffer)) == 40);
+    assert(!std::strcmp(buffer, "Thu, 05 Jan 2006 15:04:07.123456 PM 005%"));
+    assert(formatter.max_length() >= 40);
+    assert(formatter.format(dt, buffer, 4) == 40);
+    assert(!std::strcmp(buffer, "Thu"));
+    assert(peelo::formatter("%A %B %e, %I:%M").format(dt) == "Thursday January  5, 03:04");
+    assert(peelo::formatter("%F %u %w").format(peelo::date(2006, peelo::month::jan, 8)) == "2006-01-08 7 0");
+
+    // Literal text outside ASCII.
+    const peelo::formatter unicode("%Y\xe5\xb9\xb4%m\xe6\x9c\x88 \xc3\xa9");
+    const peelo::string expected("2006\xe5\xb9\xb4" "01\xe6\x9c\x88 \xc3\xa9");
+
+    assert(unicode.format(dt) == expected);
+    assert(unicode.format(dt).length() == 10);
+    assert(peelo::formatter(expected).format(dt) == expected);
+    assert(unicode.format(dt, buffer, sizeof(buffer)) == 15);
+    assert(!std::strcmp(buffer, "2006\xe5\xb9\xb4" "01\xe6\x9c\x88 \xc3\xa9"));
+    assert(peelo::formatter("\xe5\xb9").format(dt).length() == 2);
+    assert(peelo::formatter("\xe5\xb9").format(dt)[0].code() == 0xfffd);
+
+    try
+    {
+        peelo::formatter("%Q");
+        assert(false);
+    }
+    catch (std::invalid_argument&) {}
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <peelo/chrono/recurrence.hpp>
+#include <cassert>
+
+int main()
+{
+    using peelo::date;
+    using peelo::month;
+    using peelo::recurrence;
+    using peelo::weekday;
+
+    // Every other Tuesday.
+    const recurrence biweekly = recurrence::weekly(
+            date(2024, month::jan, 3),
+            weekday::tue,
+            2
+    );
+    peelo::vector<date> dates = biweekly.expand(
+            date(2024, month::jan, 1),
+            date(2024, month::feb, 28)
+    );
+
+    assert(dates.size() == 4);
+    assert(dates[0] == date(2024, month::jan, 16));
+    assert(dates[3] == date(2024, month::feb, 27));
+
+    // Second Tuesday of every month.
+    const recurrence second = recurrence::monthly(
+            date(2024, month::jan, 1),
+            weekday::tue,
+            2
+    );
+
+    dates = second.expand(date(2024, month::jan, 1), date(2024, month::apr, 1));
+    assert(dates.size() == 3);
+    assert(dates[0] == date(2024, month::jan, 9));
+    assert(dates[1] == date(2024, month::feb, 13));
+    assert(dates[2] == date(2024, month::mar, 12));
+
+    // Last Friday of every month.
+    assert(recurrence::monthly(date(2024, month::jan, 1), weekday::fri, -1)
+            .next(date(2024, month::feb, 1)) == date(2024, month::feb, 23));
+
+    // Months without 31st day are skipped.
+    dates = recurrence::monthly(date(2024, month::jan, 1), 31).expand(
+            date(2024, month::jan, 1),
+            date(2025, month::jan, 1)
+    );
+    assert(dates.size() == 7);
+    assert(dates[1] == date(2024, month::mar, 31));
+
+    // Leap day recurs only on leap years.
+    assert(recurrence::monthly(date(2024, month::feb, 1), 29, 12)
+            .next(date(2024, month::mar, 1)) == date(2028, month::feb, 29));
+
+    return 0;
+}
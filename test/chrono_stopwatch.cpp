@@ -0,0 +1,71 @@
+#include <peelo/chrono/stopwatch.hpp>
+#include <cassert>
+#include <thread>
+
+int main()
+{
+    peelo::stopwatch stopwatch(true);
+    peelo::duration first;
+    peelo::duration second;
+    peelo::duration before;
+
+    assert(stopwatch.is_running());
+    first = stopwatch.lap();
+    second = stopwatch.lap();
+    stopwatch.stop();
+    assert(!stopwatch.is_running());
+    assert(stopwatch.laps().size() == 2);
+    assert(first + second <= stopwatch.elapsed());
+    assert(stopwatch.elapsed() == stopwatch.elapsed());
+
+    stopwatch.reset();
+    assert(stopwatch.laps().empty());
+    assert(stopwatch.elapsed() == peelo::duration());
+
+    before = peelo::steady_clock::now();
+    assert(before <= peelo::steady_clock::now());
+    if (peelo::steady_clock::enable_tsc())
+    {
+        assert(peelo::steady_clock::is_tsc_enabled());
+        before = peelo::steady_clock::now();
+        assert(before <= peelo::steady_clock::now());
+        peelo::steady_clock::disable_tsc();
+    }
+    assert(!peelo::steady_clock::is_tsc_enabled());
+
+    // Switching between the counter and the system clock never makes the
+    // clock go backwards.
+    for (int i = 0; i < 1000; ++i)
+    {
+        peelo::duration now;
+
+        if (i % 2)
+        {
+            peelo::steady_clock::enable_tsc();
+        } else {
+            peelo::steady_clock::disable_tsc();
+        }
+        now = peelo::steady_clock::now();
+        assert(before <= now);
+        before = now;
+    }
+
+    // Time keeps advancing after each switch, instead of being held at
+    // the largest reading of the other source.
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i % 2)
+        {
+            peelo::steady_clock::enable_tsc();
+        } else {
+            peelo::steady_clock::disable_tsc();
+        }
+        before = peelo::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        assert(peelo::steady_clock::now() - before
+               >= peelo::duration::from_nanoseconds(1000000));
+    }
+    peelo::steady_clock::disable_tsc();
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#include <peelo/chrono/datetime.hpp>
+#include <cassert>
+
+int main()
+{
+    const peelo::time_zone zone = peelo::time_zone::parse_rule(
+            "EET-2EEST,M3.5.0/3,M10.5.0/4"
+    );
+    const peelo::datetime summer(1403000000L, zone);
+    const peelo::datetime winter(1420000000L, zone);
+
+    assert(peelo::time_zone::utc().offset(0) == 0);
+    assert(zone.offset(1403000000L) == 3 * 3600);
+    assert(zone.is_dst(1403000000L));
+    assert(zone.abbreviation(1403000000L) == "EEST");
+    assert(zone.offset(1420000000L) == 2 * 3600);
+    assert(!zone.is_dst(1420000000L));
+    assert(summer.time().hour() == 13);
+    assert(winter.time().hour() == 6);
+    assert(summer.timestamp(zone) == 1403000000L);
+    assert(winter.timestamp(zone) == 1420000000L);
+    assert(peelo::date(-86400L, peelo::time_zone::utc())
+           == peelo::date(1969, peelo::month::dec, 31));
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+#include <peelo/chrono/weekday.hpp>
+#include <cassert>
+
+int main()
+{
+    assert(peelo::weekday::mon.days_until(peelo::weekday::sun) == 6);
+    assert(peelo::weekday::sun.days_until(peelo::weekday::mon) == 1);
+    assert(peelo::weekday::fri.days_until(peelo::weekday::fri) == 0);
+    assert(peelo::weekday::sat + 2 == peelo::weekday::mon);
+    assert(peelo::weekday::tue - 3 == peelo::weekday::sat);
+    assert(peelo::weekday::wed + -10 == peelo::weekday::sun);
+
+    return 0;
+}
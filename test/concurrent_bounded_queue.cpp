@@ -0,0 +1,51 @@
+#include <peelo/concurrent/bounded_queue.hpp>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    peelo::concurrent::bounded_queue<int> queue(4);
+    std::vector<std::thread> threads;
+    std::atomic<long> sum(0);
+    const int values[] = { 1, 2, 3 };
+    int slots[3];
+
+    assert(queue.capacity() == 4);
+    assert(queue.try_push(1));
+    assert(queue.push_n(values, 3) == 3);
+    assert(!queue.try_push(5));
+    assert(queue.size() == 4);
+    assert(queue.pop_n(slots, 3) == 3);
+    assert(slots[0] == 1 && slots[1] == 1 && slots[2] == 2);
+    assert(queue.try_pop(slots[0]));
+    assert(slots[0] == 3);
+    assert(!queue.try_pop(slots[0]));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.push_back(std::thread([&queue]() {
+            for (int j = 1; j <= 1000; ++j)
+            {
+                queue.push(j);
+            }
+        }));
+        threads.push_back(std::thread([&queue, &sum]() {
+            for (int j = 0; j < 1000; ++j)
+            {
+                int value;
+
+                queue.pop(value);
+                sum += value;
+            }
+        }));
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+    assert(sum == 4 * 500500);
+    assert(queue.empty());
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <peelo/concurrent/concurrent_map.hpp>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+static int square(int key)
+{
+    return key * key;
+}
+
+int main()
+{
+    peelo::concurrent_map<int, int> container(8);
+    std::vector<std::thread> threads;
+    int value;
+
+    assert(container.segment_count() == 8);
+    assert(container.insert_or_assign(1, 10));
+    assert(!container.insert_or_assign(1, 11));
+    assert(container.find(1, value) && value == 11);
+    assert(!container.find(2, value));
+    assert(container.compute_if_absent(3, square) == 9);
+    assert(container.compute_if_absent(1, square) == 11);
+    assert(container.erase(1) == 1);
+    assert(!container.contains(1));
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.push_back(std::thread([&container, i]() {
+            for (int j = 0; j < 1000; ++j)
+            {
+                int slot;
+
+                container.insert_or_assign(i * 1000 + j, j);
+                assert(container.find(i * 1000 + j, slot) && slot == j);
+                container.compute_if_absent(j, square);
+            }
+        }));
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+    assert(container.size() == 4000);
+
+    container.clear();
+    assert(container.empty());
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#include <peelo/container/flat_map.hpp>
+#include <cassert>
+
+int main()
+{
+    peelo::flat_map<int, bool> container;
+
+    container[6] = false;
+    container[1] = false;
+    container[3] = true;
+    assert(container.size() == 3);
+    assert(container.begin()->first() == 1);
+    assert(container.find(3) != container.end());
+    assert(container.find(8) == container.end());
+    assert(container.at(3));
+    assert(container.lower_bound(4)->first() == 6);
+
+    container.erase(3);
+    assert(container.size() == 2);
+    assert(container.count(3) == 0);
+
+    container.clear();
+    assert(container.empty());
+
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include <peelo/container/flat_set.hpp>
+#include <cassert>
+
+int main()
+{
+    const int input[] = { 6, 2, 3, 2, 9, 6 };
+    peelo::flat_set<int> container(input, input + 6);
+
+    assert(container.size() == 4);
+    assert(container[0] == 2);
+    assert(container[3] == 9);
+    assert(container.find(3) != container.end());
+    assert(container.find(8) == container.end());
+    assert(*container.lower_bound(4) == 6);
+    assert(container.upper_bound(9) == container.end());
+    assert(container.equal_range(6).second() - container.equal_range(6).first() == 1);
+
+    container << 8 << 1;
+    assert(container.size() == 6);
+    assert(container[0] == 1);
+
+    container.erase(6);
+    assert(container.size() == 5);
+    assert(container.count(6) == 0);
+
+    return 0;
+}
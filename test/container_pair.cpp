@@ -8,5 +8,9 @@ int main()
     assert(pair.first() == 1);
     assert(pair.second() == 2);
 
+    pair.assign(3, 4);
+    assert(pair.first() == 3);
+    assert(pair.second() == 4);
+
     return 0;
 }
@@ -0,0 +1,50 @@
+#include <peelo/container/small_vector.hpp>
+#include <cassert>
+#include <string>
+
+int main()
+{
+    peelo::small_vector<int, 2> vector;
+
+    vector << 1 << 2;
+    assert(vector.size() == 2);
+    assert(vector.is_inline());
+
+    vector << 3;
+    assert(vector.size() == 3);
+    assert(!vector.is_inline());
+    assert(vector.front() == 1);
+    assert(vector.back() == 3);
+
+    vector.insert(1, 5);
+    assert(vector[1] == 5);
+    assert(vector[2] == 2);
+
+    vector.pop_front();
+    assert(vector.size() == 3);
+    assert(vector.front() == 5);
+
+    // Elements of the vector itself can be inserted.
+    peelo::small_vector<std::string, 1> strings;
+
+    strings.push_back(std::string(32, 'a'));
+    strings.push_back(strings[0]);
+    strings.push_back(strings[1]);
+    strings.insert(0, strings[0]);
+    strings.insert(1, 2, strings[2]);
+    strings.resize(16, strings[5]);
+    assert(strings.size() == 16);
+    for (std::size_t i = 0; i < strings.size(); ++i)
+    {
+        assert(strings[i] == std::string(32, 'a'));
+    }
+
+    vector.resize(5, 7);
+    assert(vector.size() == 5);
+    assert(vector[2] == 3 && vector[3] == 7 && vector[4] == 7);
+    vector.resize(1);
+    assert(vector.size() == 1);
+    assert(vector.front() == 5);
+
+    return 0;
+}
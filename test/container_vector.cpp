@@ -1,4 +1,5 @@
 #include <peelo/container/vector.hpp>
+#include <peelo/text/string.hpp>
 #include <cassert>
 
 int main()
@@ -13,5 +14,22 @@ int main()
     assert(vector.size() == 2);
     assert(vector.back() == 2);
 
+    // Elements of the vector itself can be inserted, both when the storage
+    // grows and when the element is shifted before it is copied.
+    peelo::vector<peelo::string> strings;
+
+    strings.push_back("a");
+    strings.push_back("b");
+    strings.insert(0, strings[1]);
+    assert(strings.size() == 3);
+    assert(strings[0] == "b" && strings[1] == "a" && strings[2] == "b");
+    strings.reserve(8);
+    strings.insert(0, strings[1]);
+    assert(strings.size() == 4);
+    assert(strings[0] == "a" && strings[1] == "b" && strings[2] == "a");
+    strings.insert(1, 2, strings[3]);
+    assert(strings.size() == 6);
+    assert(strings[1] == "b" && strings[2] == "b" && strings[3] == "b");
+
     return 0;
 }
@@ -0,0 +1,104 @@
+#include <peelo/io/async_file.hpp>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+static void test(bool allow_io_uring)
+{
+    peelo::io_queue queue(64, allow_io_uring, 2);
+    const peelo::filename name("async_file_test");
+    char data[4096];
+    char buffer[4096];
+
+    for (std::size_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = static_cast<char>(i * 7);
+    }
+    {
+        peelo::async_file file(
+                queue,
+                name,
+                peelo::async_file::out
+                | peelo::async_file::create
+                | peelo::async_file::truncate
+        );
+
+        assert(file.write(data, sizeof(data), 0).get() == 4096);
+        assert(file.size() == 4096);
+    }
+    {
+        peelo::async_file file(queue, name);
+        peelo::async_file::segment segments[4];
+        std::atomic<long> total(0);
+
+        assert(file.read(buffer, 100, 4000).get() == 96);
+        assert(!std::memcmp(buffer, data + 4000, 96));
+
+        // Read the file backwards in four segments.
+        std::memset(buffer, 0, sizeof(buffer));
+        for (int i = 0; i < 4; ++i)
+        {
+            segments[i].buffer = buffer + 1024 * (3 - i);
+            segments[i].size = 1024;
+            segments[i].offset = 1024 * (3 - i);
+            segments[i].buffer_index = -1;
+        }
+        file.read(segments, 4, [&total](std::size_t, long n) { total += n; });
+        file.wait();
+        assert(total == 4096);
+        assert(!std::memcmp(buffer, data, sizeof(data)));
+
+        // Registered buffer.
+        void* buffers[] = { buffer };
+        const std::size_t sizes[] = { sizeof(buffer) };
+
+        std::memset(buffer, 0, sizeof(buffer));
+        queue.register_buffers(buffers, sizes, 1);
+        segments[0].buffer = buffer + 10;
+        segments[0].size = 20;
+        segments[0].offset = 10;
+        segments[0].buffer_index = 0;
+        file.read(segments, 1, [](std::size_t, long n) { assert(n == 20); });
+        file.wait();
+        assert(!std::memcmp(buffer + 10, data + 10, 20));
+
+        // Callbacks chain follow-up reads while the queue is full.
+        peelo::async_file::segment many[512];
+        char chained[512];
+        peelo::async_file* f = &file;
+
+        std::memset(buffer, 0, sizeof(buffer));
+        total = 0;
+        for (int i = 0; i < 512; ++i)
+        {
+            many[i].buffer = buffer + 8 * i;
+            many[i].size = 8;
+            many[i].offset = 8 * i;
+            many[i].buffer_index = -1;
+        }
+        file.read(many, 512, [&total, &chained, f](std::size_t i, long n)
+        {
+            total += n;
+            f->read(chained + i, 1, 8 * i, [&total](long m) { total += m; });
+        });
+        file.wait();
+        assert(total == 4096 + 512);
+        assert(!std::memcmp(buffer, data, sizeof(data)));
+        for (int i = 0; i < 512; ++i)
+        {
+            assert(chained[i] == data[8 * i]);
+        }
+    }
+
+    std::remove("async_file_test");
+    assert(!queue.uses_io_uring() || allow_io_uring);
+}
+
+int main()
+{
+    test(true);
+    test(false);
+
+    return 0;
+}
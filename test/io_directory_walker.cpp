@@ -0,0 +1,80 @@
+#include <peelo/io/directory_walker.hpp>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#if !defined(_WIN32)
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+int main()
+{
+#if !defined(_WIN32)
+    const char* dirs[] = {
+        "walker_test",
+        "walker_test/a",
+        "walker_test/a/b",
+        "walker_test/skip",
+        "walker_test/c"
+    };
+    const char* files[] = {
+        "walker_test/1",
+        "walker_test/a/2",
+        "walker_test/a/b/3",
+        "walker_test/skip/4",
+        "walker_test/c/5"
+    };
+
+    for (int i = 0; i < 5; ++i)
+    {
+        ::mkdir(dirs[i], 0755);
+        std::fclose(std::fopen(files[i], "w"));
+    }
+    ::symlink("..", "walker_test/a/b/loop");
+
+    peelo::directory_walker walker(peelo::filename("walker_test"));
+
+    // Symbolic link is reported but not followed.
+    assert(walker.list().size() == 10);
+
+    walker.set_prune([](const peelo::directory_walker::entry& dir)
+    {
+        assert(dir.is_directory());
+
+        return dir.file().file() == "walker_test/skip";
+    });
+    assert(walker.list().size() == 9);
+
+    // File names are built only on request.
+    walker.walk([](const peelo::directory_walker::entry& e)
+    {
+        assert(e.file().file() == e.directory().file()
+               + peelo::string("/") + peelo::string(e.name()));
+        assert(e.is_directory() == (e.name()[0] != '1'
+                                    && e.name()[0] != '2'
+                                    && e.name()[0] != '3'
+                                    && e.name()[0] != '5'
+                                    && std::strcmp(e.name(), "loop")));
+    });
+
+    // Link back up in the tree is followed, but the loop is detected.
+    walker.set_follow_symlinks(true);
+    walker.set_threads(4);
+    std::atomic<int> count(0);
+    walker.walk([&count](const peelo::directory_walker::entry&)
+    {
+        ++count;
+    });
+    assert(count == 9);
+
+    ::unlink("walker_test/a/b/loop");
+    for (int i = 4; i >= 0; --i)
+    {
+        std::remove(files[i]);
+        ::rmdir(dirs[i]);
+    }
+#endif
+
+    return 0;
+}
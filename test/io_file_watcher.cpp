@@ -0,0 +1,120 @@
+#include <peelo/config.hpp>
+#include <peelo/io/file_watcher.hpp>
+#include <cassert>
+#include <cstdio>
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+# include <poll.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+static int changes_of(peelo::file_watcher& watcher,
+                      const peelo::filename& file,
+                      std::size_t& count)
+{
+    int changes = 0;
+
+    count = 0;
+    while (watcher.has_pending() || !count)
+    {
+        if (!watcher.poll([&](const peelo::file_watcher::event& e)
+        {
+            assert(e.file == file);
+            changes |= e.changes;
+            ++count;
+        }, peelo::duration::from_milliseconds(500)))
+        {
+            break;
+        }
+    }
+
+    return changes;
+}
+
+/**
+ * Waits for events by polling only the descriptor of the watcher, as an
+ * event loop would.
+ */
+static int changes_of_fd(peelo::file_watcher& watcher, std::size_t& count)
+{
+    int changes = 0;
+
+    count = 0;
+    for (int i = 0; i < 10 && (!count || watcher.has_pending()); ++i)
+    {
+        struct pollfd pfd;
+
+        pfd.fd = watcher.fd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        assert(::poll(&pfd, 1, 2000) == 1);
+        watcher.poll([&](const peelo::file_watcher::event& e)
+        {
+            changes |= e.changes;
+            ++count;
+        });
+    }
+
+    return changes;
+}
+#endif
+
+int main()
+{
+#if defined(PEELO_HAVE_SYS_INOTIFY_H)
+    const peelo::filename dir("file_watcher_test");
+    const peelo::filename file(dir, "a");
+    peelo::file_watcher watcher(peelo::duration::from_milliseconds(20));
+    std::size_t count;
+    std::FILE* f;
+
+    ::mkdir(dir.c_str(), 0755);
+    watcher.watch(dir);
+    assert(watcher.is_watched(dir));
+    assert(watcher.poll([](const peelo::file_watcher::event&) {}) == 0);
+
+    // Burst of writes is coalesced into single event.
+    f = std::fopen(file.c_str(), "w");
+    for (int i = 0; i < 100; ++i)
+    {
+        std::fputc('x', f);
+        std::fflush(f);
+    }
+    std::fclose(f);
+    assert(changes_of(watcher, file, count)
+           == (peelo::file_watcher::created | peelo::file_watcher::modified));
+    assert(count == 1);
+
+    std::remove(file.c_str());
+    assert(changes_of(watcher, file, count) == peelo::file_watcher::removed);
+    assert(count == 1);
+
+    // Coalesced events wake up a loop waiting on the descriptor alone.
+    f = std::fopen(file.c_str(), "w");
+    std::fclose(f);
+    assert(changes_of_fd(watcher, count) & peelo::file_watcher::created);
+    assert(count == 1);
+    std::remove(file.c_str());
+    assert(changes_of_fd(watcher, count) == peelo::file_watcher::removed);
+    assert(count == 1);
+
+    watcher.unwatch(dir);
+    assert(!watcher.is_watched(dir));
+    f = std::fopen(file.c_str(), "w");
+    std::fclose(f);
+    assert(watcher.poll([](const peelo::file_watcher::event&) {},
+                        peelo::duration::from_milliseconds(50)) == 0);
+    std::remove(file.c_str());
+
+    // Directories of a file path.
+    assert(watcher.watch(peelo::filepath(
+        peelo::string("file_watcher_test:does_not_exist")
+    )) == 1);
+    assert(watcher.is_watched(dir));
+
+    ::rmdir(dir.c_str());
+#endif
+
+    return 0;
+}
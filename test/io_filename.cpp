@@ -0,0 +1,74 @@
+#include <peelo/io/filename.hpp>
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    const peelo::filename dir(".");
+    const peelo::filename missing("this file does not exist");
+
+    assert(dir.exists());
+    assert(dir.is_dir());
+    assert(!dir.is_file());
+    assert(dir.status().inode() == dir.refresh().inode());
+
+    assert(!std::strcmp(missing.c_str(), "this file does not exist"));
+
+    const peelo::filename copy(missing);
+
+    assert(copy.c_str() == missing.c_str());
+
+    assert(!missing.exists());
+    assert(!missing.is_dir());
+    assert(!missing.is_symlink());
+    assert(missing.status().size() == 0);
+
+    // Caches of a shared const file name are filled from several threads.
+    const peelo::filename shared("./.");
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.push_back(std::thread([&shared]()
+        {
+            for (int j = 0; j < 100; ++j)
+            {
+                assert(!std::strcmp(shared.c_str(), "."));
+                assert(shared.is_dir());
+                if (j % 10 == 0)
+                {
+                    assert(shared.refresh().is_dir());
+                }
+            }
+        }));
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+    }
+
+#if !defined(_WIN32)
+    const peelo::filename base("/usr/local");
+
+    assert(base.join(peelo::filename("lib/../bin")).file() == "/usr/local/bin");
+    assert(base.join(peelo::filename("../../..")).file() == "/");
+    assert(base.join(peelo::filename("/etc")).file() == "/etc");
+    assert(base.parent().file() == "/usr");
+    assert(base.parent().parent().file() == "/");
+    assert(base.parent().parent().parent().file() == "/");
+
+    assert(peelo::filename("../..").file() == "../..");
+    assert(peelo::filename("./a/./b/..").file() == "a");
+    assert(peelo::filename(peelo::filename("a"), "..").normalize().file() == ".");
+
+    assert(peelo::filename("/usr/share/doc").relative_to(base).file()
+            == "../share/doc");
+    assert(base.relative_to(base).file() == ".");
+    assert(peelo::filename("a/b").relative_to(peelo::filename(".")).file()
+            == "a/b");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include <peelo/io/filepath.hpp>
+#include <cassert>
+
+int main()
+{
+#if !defined(_WIN32)
+    const peelo::filepath path("/nonexistent:/bin:/usr/bin:/bin");
+    peelo::vector<peelo::string> names;
+
+    // Declared order is preserved and duplicates are removed.
+    assert(path.directories().size() == 3);
+    assert(path.directories()[0].file() == "/nonexistent");
+    assert(path.directories()[1].file() == "/bin");
+
+    assert(path.resolve("sh").file() == "/bin/sh");
+    assert(path.resolve("sh") == path.resolve("sh"));
+    assert(path.resolve("no such command").empty());
+    assert(path.resolve("/bin/sh").file() == "/bin/sh");
+
+    names.push_back("sh");
+    names.push_back("no such command");
+    names.push_back("sh");
+
+    const peelo::vector<peelo::filename> result = path.resolve_all(names);
+
+    assert(result.size() == 3);
+    assert(result[0].file() == "/bin/sh");
+    assert(result[1].empty());
+    assert(result[2] == result[0]);
+#endif
+
+    return 0;
+}
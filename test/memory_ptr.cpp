@@ -11,5 +11,13 @@ int main()
     p.reset();
     assert(!p);
 
+    peelo::ptr<int> a(new int(6));
+    peelo::ptr<int> b(a);
+
+    assert(a.use_count() == 2);
+    a.reset();
+    assert(!a);
+    assert(*b == 6 && b.unique());
+
     return 0;
 }
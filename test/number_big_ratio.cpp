@@ -0,0 +1,73 @@
+#include <peelo/number/big_ratio.hpp>
+#include <cassert>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+int main()
+{
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    peelo::big_ratio r;
+    peelo::big_ratio sum;
+
+    assert(r.numerator() == 0 && r.denominator() == 1);
+    r = peelo::big_ratio(6, -4);
+    assert(r.numerator() == -3 && r.denominator() == 2);
+    assert(peelo::big_ratio(peelo::ratio(3, 9)).to_ratio()
+           == peelo::ratio(1, 3));
+    try
+    {
+        peelo::big_ratio(1, 0);
+        assert(false);
+    }
+    catch (std::domain_error&) {}
+
+    // Arithmetic.
+    assert(peelo::big_ratio(1, 2) + peelo::big_ratio(1, 3)
+           == peelo::big_ratio(5, 6));
+    assert(peelo::big_ratio(1, 2) - peelo::big_ratio(1, 3)
+           == peelo::big_ratio(1, 6));
+    assert(peelo::big_ratio(2, 3) * peelo::big_ratio(9, 4)
+           == peelo::big_ratio(3, 2));
+    assert(peelo::big_ratio(2, 3) / peelo::big_ratio(-4, 9)
+           == peelo::big_ratio(-3, 2));
+    assert(peelo::big_ratio(1, 6) - peelo::big_ratio(1, 6)
+           == peelo::big_ratio());
+    try
+    {
+        peelo::big_ratio(1) / peelo::big_ratio();
+        assert(false);
+    }
+    catch (std::domain_error&) {}
+
+    // Values which overflow ratio.
+    r = peelo::big_ratio(peelo::ratio(max)) + peelo::ratio(1);
+    assert(!r.fits_ratio());
+    assert(r.to_string() == "9223372036854775808/1");
+    try
+    {
+        r.to_ratio();
+        assert(false);
+    }
+    catch (std::overflow_error&) {}
+
+    // Harmonic number H(30).
+    for (int i = 1; i <= 30; ++i)
+    {
+        sum += peelo::big_ratio(1, i);
+    }
+    assert(sum.to_string() == "9304682830147/2329089562800");
+
+    // Comparison.
+    assert(peelo::big_ratio(1, 3) < peelo::big_ratio(1, 2));
+    assert(peelo::big_ratio(-1, 2) < peelo::big_ratio(-1, 3));
+    assert(peelo::big_ratio(-1, 2) < peelo::big_ratio(1, 3));
+    assert(peelo::big_ratio(7, 3) >= peelo::big_ratio(14, 6));
+
+    std::stringstream ss;
+
+    ss << peelo::big_ratio(-1, 2);
+    assert(ss.str() == "-1/2");
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <peelo/number/bigint.hpp>
+#include <cassert>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+static peelo::bigint factorial(int n)
+{
+    peelo::bigint result(1);
+
+    for (int i = 2; i <= n; ++i)
+    {
+        result *= i;
+    }
+
+    return result;
+}
+
+int main()
+{
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    peelo::bigint a;
+    peelo::bigint b;
+    peelo::bigint q;
+    peelo::bigint r;
+
+    assert(peelo::bigint().is_zero());
+    assert(peelo::bigint().sign() == 0);
+    assert(peelo::bigint(-5).is_negative());
+    assert(peelo::bigint(min).to_int64() == min);
+    assert(peelo::bigint(max).to_int64() == max);
+    assert(!(peelo::bigint(max) + 1).fits_int64());
+    assert((peelo::bigint(min) - 1 + 1).to_int64() == min);
+
+    // Conversions.
+    assert(peelo::bigint(0).to_string() == "0");
+    assert(peelo::bigint(-1234567890123LL).to_string() == "-1234567890123");
+    assert(peelo::bigint::parse("-000123") == -123);
+    assert(peelo::bigint::parse(peelo::string("+42")) == 42);
+    assert(factorial(30).to_string() == "265252859812191058636308480000000");
+    assert(peelo::bigint::parse("265252859812191058636308480000000")
+           == factorial(30));
+
+    try
+    {
+        peelo::bigint::parse("12a");
+        assert(false);
+    }
+    catch (std::invalid_argument&) {}
+    try
+    {
+        peelo::bigint::parse("-");
+        assert(false);
+    }
+    catch (std::invalid_argument&) {}
+
+    // Large numbers take the Karatsuba and divide and conquer paths.
+    a = factorial(1000);
+    b = factorial(999);
+    assert(a.to_string().length() == 2568);
+    assert(peelo::bigint::parse(a.to_string()) == a);
+    assert(a / b == 1000);
+    assert(a % b == 0);
+    assert((a * a) / a == a);
+    assert(((a + 1) * (a - 1)) == a * a - 1);
+    assert(peelo::bigint::gcd(a, factorial(500) * 7919) == factorial(500));
+
+    // Division truncates towards zero.
+    peelo::bigint::divide(-7, 2, q, r);
+    assert(q == -3 && r == -1);
+    peelo::bigint::divide(7, -2, q, r);
+    assert(q == -3 && r == 1);
+    peelo::bigint::divide(a + 5, a, q, r);
+    assert(q == 1 && r == 5);
+    try
+    {
+        peelo::bigint(1) / peelo::bigint();
+        assert(false);
+    }
+    catch (std::domain_error&) {}
+
+    // Arithmetic with mixed signs.
+    assert(peelo::bigint(5) - 7 == -2);
+    assert(peelo::bigint(-5) + 7 == 2);
+    assert(peelo::bigint(-5) * -5 == 25);
+    assert(-peelo::bigint() == 0);
+    a = 10;
+    a += a;
+    a -= a;
+    assert(a.is_zero() && !a.is_negative());
+
+    // Comparison.
+    assert(peelo::bigint(-2) < peelo::bigint(1));
+    assert(peelo::bigint(-2) < peelo::bigint(-1));
+    assert(factorial(25) > factorial(24));
+    assert(-factorial(25) < -factorial(24));
+
+    std::stringstream ss;
+
+    ss << peelo::bigint(-99);
+    assert(ss.str() == "-99");
+
+    return 0;
+}
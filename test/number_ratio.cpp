@@ -0,0 +1,78 @@
+#include <peelo/number/ratio.hpp>
+#include <cassert>
+#include <limits>
+
+int main()
+{
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    peelo::ratio r;
+
+    assert(peelo::ratio() == peelo::ratio(0, 5));
+    assert(peelo::ratio().denominator() == 1);
+
+    // Normalization.
+    r = peelo::ratio(6, -4);
+    assert(r.numerator() == -3 && r.denominator() == 2);
+    assert(peelo::ratio(min, min) == peelo::ratio(1));
+    assert(peelo::ratio(min, 2).numerator() == min / 2);
+
+    // Arithmetic.
+    assert(peelo::ratio(1, 2) + peelo::ratio(1, 3) == peelo::ratio(5, 6));
+    assert(peelo::ratio(1, 2) - peelo::ratio(1, 3) == peelo::ratio(1, 6));
+    assert(peelo::ratio(2, 3) * peelo::ratio(9, 4) == peelo::ratio(3, 2));
+    assert(peelo::ratio(2, 3) / peelo::ratio(-4, 9) == peelo::ratio(-3, 2));
+    assert(peelo::ratio(1, 6) + peelo::ratio(-1, 6) == peelo::ratio());
+    assert(-peelo::ratio(1, 2) == peelo::ratio(-1, 2));
+
+    r = peelo::ratio(1, 4);
+    r += peelo::ratio(1, 4);
+    assert(r == peelo::ratio(1, 2));
+    r -= 1;
+    assert(r == peelo::ratio(-1, 2));
+    r *= 4;
+    assert(r == peelo::ratio(-2));
+    r /= peelo::ratio(-2, 3);
+    assert(r == peelo::ratio(3));
+
+    // Intermediate results larger than 64 bits.
+    assert(peelo::ratio(max, 3) * peelo::ratio(3, max) == peelo::ratio(1));
+    assert(peelo::ratio(max - 1, max) - peelo::ratio(max - 2, max)
+           == peelo::ratio(1, max));
+
+    // Comparison.
+    assert(peelo::ratio(1, 3) < peelo::ratio(1, 2));
+    assert(peelo::ratio(-1, 2) < peelo::ratio(1, 3));
+    assert(peelo::ratio(-1, 2) < peelo::ratio(-1, 3));
+    assert(peelo::ratio(max - 2, max - 1) < peelo::ratio(max - 1, max));
+    assert(peelo::ratio(max, max - 1) < peelo::ratio(max - 1, max - 2));
+    assert(peelo::ratio(7, 3) >= peelo::ratio(14, 6));
+
+    // Overflow.
+    assert(!peelo::ratio(max).checked_add(peelo::ratio(1), r));
+    assert(r == peelo::ratio(3));
+    assert(!peelo::ratio(1, max).checked_multiply(peelo::ratio(1, 2), r));
+    assert(!peelo::ratio(1, max).checked_add(peelo::ratio(1, max - 1), r));
+    assert(peelo::ratio(min).checked_subtract(peelo::ratio(0), r));
+    assert(r.numerator() == min);
+    try
+    {
+        -peelo::ratio(min);
+        assert(false);
+    }
+    catch (std::overflow_error&) {}
+    try
+    {
+        peelo::ratio(1) / peelo::ratio();
+        assert(false);
+    }
+    catch (std::domain_error&) {}
+    try
+    {
+        peelo::ratio(1, 0);
+        assert(false);
+    }
+    catch (std::domain_error&) {}
+
+    return 0;
+}